@@ -0,0 +1,109 @@
+#include "Benchmarks/bench_support.hpp"
+
+#include "geometry/geometry.hpp"
+
+#include <vector>
+
+namespace cg
+{
+
+namespace
+{
+
+constexpr size_t BOX_COUNT = 100000;
+
+bool same_box(const AABB &a, const AABB &b)
+{
+    return a.min_corner == b.min_corner && a.max_corner == b.max_corner;
+}
+
+void create_bench(size_t count)
+{
+    std::vector<Point3> points(count);
+    for(Point3 &p : points)
+    {
+        p.set(rand_0_1() * 200.0f - 100.0f, rand_0_1() * 50.0f, rand_0_1() * -300.0f);
+    }
+
+    // One merge per point versus create() on one thread and on all cores
+    AABB   expected, box_1, box_n;
+    double per_point = time_ns_per_op(
+        [&]() {
+            expected = AABB();
+            for(const Point3 &p : points) expected.merge(p);
+        },
+        count);
+    double create_1 = time_ns_per_op([&]() { box_1.create(points.data(), count, 1); }, count);
+    double create_n = time_ns_per_op([&]() { box_n.create(points.data(), count, 0); }, count);
+    logmsg("  create %8zu points: merge loop %5.2f  create %5.2f (1 thread) %5.2f (%u threads)"
+           "  %s",
+           count,
+           per_point,
+           create_1,
+           create_n,
+           resolve_thread_count(0),
+           (same_box(expected, box_1) && same_box(expected, box_n)) ? "match" : "MISMATCH");
+}
+
+} // namespace
+
+void aabb_bench()
+{
+    logmsg("AABB construction and slab tests (ns per point / box)");
+    create_bench(1000000);
+    if(large_benchmarks()) create_bench(10000000);
+
+    // One ray against many boxes
+    std::vector<AABB> boxes(BOX_COUNT);
+    for(AABB &b : boxes)
+    {
+        Point3 c(rand_0_1() * 100.0f - 50.0f, rand_0_1() * 100.0f - 50.0f, rand_0_1() * -100.0f);
+        Vector3 h(rand_0_1() * 2.0f, rand_0_1() * 2.0f, rand_0_1() * 2.0f);
+        b.update(c - h, c + h);
+    }
+    Ray3 ray(Point3(0.0f, 0.0f, 10.0f), Vector3(0.1f, -0.05f, -1.0f), true);
+
+    std::vector<RayObjectIntersectResult> expected(BOX_COUNT), out(BOX_COUNT);
+    double per_box = time_ns_per_op(
+        [&]() {
+            for(size_t i = 0; i < BOX_COUNT; i++) expected[i] = ray.intersect(boxes[i]);
+        },
+        BOX_COUNT);
+    size_t hits = 0;
+    double batch = time_ns_per_op(
+        [&]() { hits = intersect_boxes<8>(ray, boxes.data(), BOX_COUNT, out.data()); },
+        BOX_COUNT);
+
+    // Boxes kept as packets between queries
+    std::vector<AABBxN<8>> packets(BOX_COUNT / 8);
+    for(size_t i = 0; i < packets.size(); i++) packets[i] = AABBxN<8>::load(&boxes[i * 8]);
+    size_t packet_hits = 0;
+    double packet = time_ns_per_op(
+        [&]() {
+            packet_hits = 0;
+            for(const AABBxN<8> &p : packets)
+            {
+                packet_hits += p.intersect(ray).hit.any() ? 1 : 0;
+            }
+        },
+        BOX_COUNT);
+    do_not_optimize(packet_hits);
+
+    size_t bad = 0;
+    for(size_t i = 0; i < BOX_COUNT; i++)
+    {
+        if(expected[i].intersects != out[i].intersects ||
+           expected[i].distance != out[i].distance)
+            bad++;
+    }
+    logmsg("  ray vs %zu boxes: Ray3 %5.2f  intersect_boxes %5.2f  AABBx8 packets %5.2f"
+           "  (%zu hits, mismatches %zu)",
+           BOX_COUNT,
+           per_box,
+           batch,
+           packet,
+           hits,
+           bad);
+}
+
+} // namespace cg
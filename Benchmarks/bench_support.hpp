@@ -0,0 +1,77 @@
+//============================================================================
+//	Johns Hopkins University Engineering for Professionals
+//	605.667 Computer Graphics and 605.767 Applied Computer Graphics
+//	Instructor:	Brian Russin
+//
+//	Author:  Kyle Meyer
+//	File:    Benchmarks/bench_support.hpp
+//	Purpose: Timing helpers shared by the benchmarks.
+//============================================================================
+
+#ifndef __BENCHMARKS_BENCH_SUPPORT_HPP__
+#define __BENCHMARKS_BENCH_SUPPORT_HPP__
+
+#include <chrono>
+#include <cstddef>
+
+namespace cg
+{
+
+// declare logging function
+void logmsg(const char *message, ...);
+
+/**
+ * Should benchmarks include their largest problem sizes (--large)?
+ * @return Returns true if --large was given on the command line.
+ */
+bool large_benchmarks();
+
+/**
+ * Runs a function repeatedly and returns the best time per operation.
+ * @param  fn         Function to time. Each call performs ops operations.
+ * @param  ops        Number of operations performed by one call of fn.
+ * @param  reps       Number of timed repetitions (the minimum is reported).
+ * @return Returns nanoseconds per operation.
+ */
+template <typename Fn>
+double time_ns_per_op(Fn &&fn, size_t ops, int reps = 5)
+{
+    // Warm up caches and branch predictors
+    fn();
+
+    double best = 0.0;
+    for(int i = 0; i < reps; i++)
+    {
+        auto   start = std::chrono::steady_clock::now();
+        fn();
+        auto   end = std::chrono::steady_clock::now();
+        double ns = std::chrono::duration<double, std::nano>(end - start).count();
+        if(i == 0 || ns < best) best = ns;
+    }
+    return best / static_cast<double>(ops);
+}
+
+/**
+ * Prevents the compiler from optimizing away a computed value. The value
+ * (and, through the memory clobber, anything it points to) is treated as
+ * read by code the compiler cannot see.
+ * @param  value  Value to keep alive.
+ */
+template <typename T>
+void do_not_optimize(const T &value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "g"(&value) : "memory");
+#else
+    // Read every byte through a volatile so the value must be computed
+    const volatile unsigned char *bytes = reinterpret_cast<const volatile unsigned char *>(&value);
+    unsigned char                 sum = 0;
+    for(size_t i = 0; i < sizeof(T); i++) sum ^= bytes[i];
+    static volatile unsigned char sink;
+    sink = sum;
+#endif
+}
+
+} // namespace cg
+
+#endif
@@ -0,0 +1,175 @@
+#include "Benchmarks/bench_support.hpp"
+
+#include "geometry/geometry.hpp"
+
+#include <cmath>
+#include <vector>
+
+namespace cg
+{
+
+namespace
+{
+
+constexpr size_t RAY_COUNT = 10000;
+
+// Brute force is O(faces) per ray, so it only runs on a few rays
+constexpr size_t BRUTE_FORCE_RAY_COUNT = 200;
+
+/**
+ * Height field mesh of about triangle_count triangles over [-50, 50]^2.
+ */
+struct Mesh
+{
+    std::vector<Point3>   vertices;
+    std::vector<uint32_t> faces;
+
+    explicit Mesh(size_t triangle_count)
+    {
+        uint32_t w = static_cast<uint32_t>(std::sqrt(triangle_count / 2.0)) + 1;
+        float    step = 100.0f / static_cast<float>(w - 1);
+        vertices.reserve(static_cast<size_t>(w) * w);
+        for(uint32_t j = 0; j < w; j++)
+        {
+            for(uint32_t i = 0; i < w; i++)
+            {
+                float x = -50.0f + step * i, z = -50.0f + step * j;
+                float y = 4.0f * std::sin(x * 0.15f) * std::cos(z * 0.1f) + rand_0_1() * 0.5f;
+                vertices.emplace_back(x, y, z);
+            }
+        }
+        faces.reserve(6 * static_cast<size_t>(w - 1) * (w - 1));
+        for(uint32_t j = 0; j + 1 < w; j++)
+        {
+            for(uint32_t i = 0; i + 1 < w; i++)
+            {
+                uint32_t v = j * w + i;
+                faces.insert(faces.end(), {v, v + w, v + 1, v + 1, v + w, v + w + 1});
+            }
+        }
+    }
+
+    size_t triangle_count() const { return faces.size() / 3; }
+};
+
+// Rays from above the mesh towards random points on it
+std::vector<Ray3> make_rays(size_t count)
+{
+    std::vector<Ray3> rays(count);
+    for(Ray3 &r : rays)
+    {
+        Point3 from(rand_0_1() * 120.0f - 60.0f, 30.0f, rand_0_1() * 120.0f - 60.0f);
+        Point3 to(rand_0_1() * 100.0f - 50.0f, 0.0f, rand_0_1() * 100.0f - 50.0f);
+        r = Ray3(from, to, true);
+    }
+    return rays;
+}
+
+// Number of rays where the BVH and brute force results differ
+size_t mismatches(const BVH &bvh, const Mesh &mesh, const std::vector<Ray3> &rays)
+{
+    size_t n = 0;
+    for(size_t i = 0; i < BRUTE_FORCE_RAY_COUNT; i++)
+    {
+        RayMeshIntersectResult a = rays[i].intersect(mesh.vertices, mesh.faces, INFINITY);
+        RayMeshIntersectResult b = rays[i].intersect(bvh, INFINITY);
+        bool any = rays[i].does_intersect_exist(bvh, INFINITY);
+        if(a.intersects != b.intersects || a.distance != b.distance ||
+           a.face_index != b.face_index || any != a.intersects)
+            n++;
+    }
+    return n;
+}
+
+void mesh_bench(size_t triangle_count, const std::vector<Ray3> &rays)
+{
+    Mesh     mesh(triangle_count);
+    uint32_t threads = resolve_thread_count(0);
+    int      reps = (triangle_count > 1000000) ? 1 : 3;
+
+    // Build on one thread and on all cores
+    BVH    bvh;
+    double build_1 = time_ns_per_op([&]() { bvh.build(mesh.vertices, mesh.faces, 4, 1); }, 1, reps);
+    double build_n =
+        time_ns_per_op([&]() { bvh.build(mesh.vertices, mesh.faces, 4, threads); }, 1, reps);
+
+    // Closest hit and any hit traversal
+    std::vector<RayMeshIntersectResult> hits(rays.size());
+    double                              closest = time_ns_per_op(
+        [&]() {
+            for(size_t i = 0; i < rays.size(); i++) hits[i] = rays[i].intersect(bvh, INFINITY);
+        },
+        rays.size());
+    size_t hit_count = 0;
+    for(const RayMeshIntersectResult &h : hits) hit_count += h.intersects ? 1 : 0;
+    size_t any_count = 0;
+    double any = time_ns_per_op(
+        [&]() {
+            any_count = 0;
+            for(const Ray3 &r : rays) any_count += r.does_intersect_exist(bvh, INFINITY) ? 1 : 0;
+        },
+        rays.size());
+
+    logmsg("  %8zu triangles: build %8.2f ms (1 thread) %8.2f ms (%u threads)  %zu nodes",
+           mesh.triangle_count(),
+           build_1 * 1.0e-6,
+           build_n * 1.0e-6,
+           threads,
+           bvh.nodes().size());
+    logmsg("      closest hit %7.1f ns/ray  any hit %7.1f ns/ray  (%zu / %zu rays hit)",
+           closest,
+           any,
+           hit_count,
+           rays.size());
+
+    // Refit after moving every vertex
+    for(Point3 &v : mesh.vertices) v.y += 0.5f * std::sin(v.x * 0.3f);
+    double refit = time_ns_per_op([&]() { bvh.refit(mesh.vertices); }, 1, reps);
+
+    // Brute force comparison with 32 bit indices and with the automatically
+    // selected (16 bit where possible) index buffer
+    if(mesh.triangle_count() <= 100000)
+    {
+        IndexBuffer indices(mesh.faces);
+        double      brute_32 = time_ns_per_op(
+            [&]() {
+                for(size_t i = 0; i < BRUTE_FORCE_RAY_COUNT; i++)
+                    hits[i] = rays[i].intersect(mesh.vertices, mesh.faces, INFINITY);
+            },
+            BRUTE_FORCE_RAY_COUNT,
+            1);
+        double brute_auto = time_ns_per_op(
+            [&]() {
+                for(size_t i = 0; i < BRUTE_FORCE_RAY_COUNT; i++)
+                    hits[i] = rays[i].intersect(mesh.vertices, indices, INFINITY);
+            },
+            BRUTE_FORCE_RAY_COUNT,
+            1);
+        logmsg("      refit %8.2f ms  brute force %10.1f ns/ray (32 bit) %10.1f ns/ray (%zu bit)"
+               "  mismatches after refit %zu",
+               refit * 1.0e-6,
+               brute_32,
+               brute_auto,
+               indices.index_size() * 8,
+               mismatches(bvh, mesh, rays));
+    }
+    else
+    {
+        logmsg("      refit %8.2f ms", refit * 1.0e-6);
+    }
+}
+
+} // namespace
+
+void bvh_bench()
+{
+    logmsg("BVH build and traversal (%zu rays)", RAY_COUNT);
+    std::vector<Ray3> rays = make_rays(RAY_COUNT);
+    mesh_bench(10000, rays);
+    mesh_bench(100000, rays);
+    mesh_bench(1000000, rays);
+    if(large_benchmarks()) mesh_bench(10000000, rays);
+    else logmsg("  (run with --large for 10M triangles)");
+}
+
+} // namespace cg
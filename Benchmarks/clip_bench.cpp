@@ -0,0 +1,95 @@
+#include "Benchmarks/bench_support.hpp"
+
+#include "geometry/geometry.hpp"
+
+#include <cmath>
+#include <vector>
+
+namespace cg
+{
+
+namespace
+{
+
+constexpr size_t SEGMENT_COUNT = 1000;
+constexpr float  WORLD_SIZE = 1000.0f;
+
+// Random convex polygon: a regular n-gon, counter-clockwise
+std::vector<Point2> random_ngon()
+{
+    uint32_t            sides = 3 + static_cast<uint32_t>(rand_0_1() * 10.0f);
+    float               radius = 0.5f + rand_0_1() * 3.0f;
+    Point2              center(rand_0_1() * WORLD_SIZE, rand_0_1() * WORLD_SIZE);
+    std::vector<Point2> poly(sides);
+    for(uint32_t i = 0; i < sides; i++)
+    {
+        float angle = 2.0f * PI * static_cast<float>(i) / static_cast<float>(sides);
+        poly[i].set(center.x + radius * std::cos(angle), center.y + radius * std::sin(angle));
+    }
+    return poly;
+}
+
+void grid_bench(size_t polygon_count)
+{
+    std::vector<std::vector<Point2>> polygons(polygon_count);
+    for(auto &poly : polygons) poly = random_ngon();
+    std::vector<LineSegment2> segments(SEGMENT_COUNT);
+    for(LineSegment2 &s : segments)
+    {
+        s.a.set(rand_0_1() * WORLD_SIZE, rand_0_1() * WORLD_SIZE);
+        s.b.set(s.a.x + rand_0_1() * 100.0f - 50.0f, s.a.y + rand_0_1() * 100.0f - 50.0f);
+    }
+
+    // Every segment against every polygon
+    std::vector<SegmentPolygonClip> expected;
+    double                          brute = time_ns_per_op(
+        [&]() {
+            expected.clear();
+            for(uint32_t s = 0; s < SEGMENT_COUNT; s++)
+            {
+                for(uint32_t p = 0; p < polygon_count; p++)
+                {
+                    Segment2ClipResult r = segments[s].clip_to_polygon(polygons[p]);
+                    if(r.clipped) expected.push_back({s, p, 0.0f, 0.0f, r.clip_segment});
+                }
+            }
+        },
+        SEGMENT_COUNT,
+        1);
+
+    PolygonGrid grid;
+    double      build = time_ns_per_op([&]() { grid.build(polygons); }, polygon_count, 3);
+    std::vector<SegmentPolygonClip> clips;
+    double                          batch = time_ns_per_op(
+        [&]() { grid.clip_segments_to_polygons(segments.data(), SEGMENT_COUNT, clips); },
+        SEGMENT_COUNT);
+
+    size_t bad = (clips.size() == expected.size()) ? 0 : 1;
+    for(size_t i = 0; bad == 0 && i < clips.size(); i++)
+    {
+        if(clips[i].segment != expected[i].segment || clips[i].polygon != expected[i].polygon ||
+           !(clips[i].clip_segment.a == expected[i].clip_segment.a) ||
+           !(clips[i].clip_segment.b == expected[i].clip_segment.b))
+            bad++;
+    }
+    logmsg("  %6zu polygons: brute force %10.1f  grid %7.1f ns per segment"
+           "  (build %5.1f ns per polygon, %zu clips, %s)",
+           polygon_count,
+           brute,
+           batch,
+           build,
+           clips.size(),
+           bad == 0 ? "match" : "MISMATCH");
+}
+
+} // namespace
+
+void clip_bench()
+{
+    logmsg("Segment vs convex polygon clipping");
+    grid_bench(1000);
+    grid_bench(10000);
+    grid_bench(50000);
+}
+
+} // namespace cg
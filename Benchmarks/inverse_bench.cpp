@@ -0,0 +1,99 @@
+#include "Benchmarks/bench_support.hpp"
+
+#include "geometry/geometry.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace cg
+{
+
+namespace
+{
+
+constexpr size_t COUNT = 10000;
+
+// Largest deviation of m * inverse from the identity matrix
+float identity_error(const Matrix4x4 &m, const Matrix4x4 &inverse)
+{
+    Matrix4x4    p = m * inverse;
+    const float *a = p.get();
+    float        err = 0.0f;
+    for(int i = 0; i < 16; i++)
+    {
+        float expected = (i % 5 == 0) ? 1.0f : 0.0f;
+        err = std::max(err, std::abs(a[i] - expected));
+    }
+    return err;
+}
+
+// Random rotation about a random axis followed by a translation
+Matrix4x4 random_rigid()
+{
+    Matrix4x4 m;
+    m.translate(rand_0_1() * 100.0f - 50.0f, rand_0_1() * 100.0f - 50.0f, rand_0_1() * 100.0f);
+    m.rotate(rand_0_1() * 360.0f, rand_0_1() - 0.5f, rand_0_1() - 0.5f, rand_0_1() + 0.1f);
+    return m;
+}
+
+Matrix4x4 random_trs()
+{
+    Matrix4x4 m = random_rigid();
+    m.scale(rand_0_1() * 10.0f + 0.1f, rand_0_1() * 10.0f + 0.1f, rand_0_1() * 10.0f + 0.1f);
+    return m;
+}
+
+Matrix4x4 random_general()
+{
+    Matrix4x4 m = random_trs();
+    m.m30() = rand_0_1() - 0.5f;
+    m.m31() = rand_0_1() - 0.5f;
+    m.m32() = -1.0f;
+    return m;
+}
+
+void bench_type(const char *name, Matrix4x4 (*generate)())
+{
+    std::vector<Matrix4x4> in(COUNT), out(COUNT);
+    for(Matrix4x4 &m : in) m = generate();
+    MatrixType type = in[0].classify();
+
+    double gauss_jordan = time_ns_per_op(
+        [&]() {
+            for(size_t i = 0; i < COUNT; i++) out[i] = in[i].get_inverse(MatrixType::GENERAL);
+        },
+        COUNT);
+    float gj_error = 0.0f;
+    for(size_t i = 0; i < COUNT; i++) gj_error = std::max(gj_error, identity_error(in[i], out[i]));
+
+    double specialized = time_ns_per_op(
+        [&]() { invert_matrices(in.data(), out.data(), COUNT); }, COUNT);
+    float error = 0.0f;
+    for(size_t i = 0; i < COUNT; i++) error = std::max(error, identity_error(in[i], out[i]));
+
+    const char *type_name = (type == MatrixType::RIGID)    ? "rigid"
+                            : (type == MatrixType::AFFINE) ? "affine"
+                                                           : "general";
+    logmsg("  %-8s (classified %-7s) Gauss-Jordan %6.2f  get_inverse %6.2f (x%.2f)  "
+           "max |M*inv - I| %g vs %g",
+           name,
+           type_name,
+           gauss_jordan,
+           specialized,
+           gauss_jordan / specialized,
+           error,
+           gj_error);
+}
+
+} // namespace
+
+void inverse_bench()
+{
+    logmsg("Matrix4x4 inverse (%zu matrices, ns per inverse)", COUNT);
+    bench_type("rigid", random_rigid);
+    bench_type("TRS", random_trs);
+    bench_type("general", random_general);
+}
+
+} // namespace cg
@@ -0,0 +1,109 @@
+//============================================================================
+//	Johns Hopkins University Whiting School of Engineering
+//	605.667 Principles of Computer Graphics
+//	Instructor:	Brian Russin
+//
+//	Author:  Kyle Meyer
+//	File:    Benchmarks/main.cpp
+//	Purpose: Performance benchmarks for the geometry and scene libraries.
+//           Build with CMAKE_BUILD_TYPE=Release for meaningful timings.
+//           Pass benchmark names on the command line to run a subset
+//           and --large to include the largest problem sizes.
+//
+//============================================================================
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+namespace cg
+{
+
+void matrix_bench();
+void transform_bench();
+void inverse_bench();
+void vector_bench();
+void ray_bench();
+void bvh_bench();
+void aabb_bench();
+void sphere_bench();
+void noise_bench();
+void clip_bench();
+void sweep_bench();
+void polygon_bench();
+void random_bench();
+void scene_bench();
+
+// Set by --large: also run the slow, memory hungry problem sizes
+static bool large = false;
+
+bool large_benchmarks() { return large; }
+
+// Simple logging function. Echoes to the console as well as the log file.
+void logmsg(const char *message, ...)
+{
+    // Open file if not already opened
+    static FILE *lfile = NULL;
+    if(lfile == NULL) { lfile = fopen("Benchmarks.log", "w"); }
+
+    va_list arg;
+    va_start(arg, message);
+    vfprintf(lfile, message, arg);
+    va_end(arg);
+    putc('\n', lfile);
+    fflush(lfile);
+
+    va_start(arg, message);
+    vprintf(message, arg);
+    va_end(arg);
+    putchar('\n');
+}
+
+} // namespace cg
+
+struct Benchmark
+{
+    const char *name;
+    void (*run)();
+};
+
+const Benchmark BENCHMARKS[] = {{"matrix", cg::matrix_bench},
+                                {"transform", cg::transform_bench},
+                                {"inverse", cg::inverse_bench},
+                                {"vector", cg::vector_bench},
+                                {"ray", cg::ray_bench},
+                                {"bvh", cg::bvh_bench},
+                                {"aabb", cg::aabb_bench},
+                                {"sphere", cg::sphere_bench},
+                                {"noise", cg::noise_bench},
+                                {"clip", cg::clip_bench},
+                                {"sweep", cg::sweep_bench},
+                                {"polygon", cg::polygon_bench},
+                                {"random", cg::random_bench},
+                                {"scene", cg::scene_bench}};
+
+/**
+ * Main method. Entry point for application.
+ */
+int main(int argc, char *argv[])
+{
+#ifndef NDEBUG
+    cg::logmsg("WARNING: not an optimized build - timings are not representative");
+#endif
+    int names = 0;
+    for(int i = 1; i < argc; i++)
+    {
+        if(strcmp(argv[i], "--large") == 0) cg::large = true;
+        else names++;
+    }
+    for(const Benchmark &b : BENCHMARKS)
+    {
+        bool run = (names == 0);
+        for(int i = 1; i < argc; i++)
+        {
+            if(strcmp(argv[i], b.name) == 0) run = true;
+        }
+        if(run) b.run();
+    }
+    return 0;
+}
@@ -0,0 +1,298 @@
+#include "Benchmarks/bench_support.hpp"
+
+#include "geometry/geometry.hpp"
+#include "geometry/matrix_kernels.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace cg
+{
+
+namespace
+{
+
+constexpr size_t COUNT = 4096;
+
+// Largest absolute difference between 2 float arrays
+float max_difference(const std::vector<float> &a, const std::vector<float> &b)
+{
+    float d = 0.0f;
+    for(size_t i = 0; i < a.size(); i++) d = std::max(d, std::abs(a[i] - b[i]));
+    return d;
+}
+
+struct KernelTimes
+{
+    double multiply;
+    double transform_hpoint;
+    double transform_point;
+    double transform_vector;
+    double transpose;
+};
+
+// Builds a translation matrix with a full multiply (reference for translate)
+Matrix4x4 translation(float x, float y, float z)
+{
+    Matrix4x4 m;
+    m.m03() = x;
+    m.m13() = y;
+    m.m23() = z;
+    return m;
+}
+
+Matrix4x4 scaling(float x, float y, float z)
+{
+    Matrix4x4 m;
+    m.m00() = x;
+    m.m11() = y;
+    m.m22() = z;
+    return m;
+}
+
+Matrix4x4 rotation_z(float angle)
+{
+    Matrix4x4 m;
+    m.rotate_z(angle);
+    return m;
+}
+
+// Times building T * Rz * S node transforms: full multiplies against
+// temporaries, the in-place methods, and compose_trs
+void trs_bench()
+{
+    std::vector<float> params(COUNT * 4);
+    for(float &f : params) f = rand_0_1() * 10.0f;
+    std::vector<Matrix4x4> full(COUNT), in_place(COUNT), composed(COUNT);
+
+    double t_full = time_ns_per_op(
+        [&]() {
+            for(size_t i = 0; i < COUNT; i++)
+            {
+                const float *p = &params[i * 4];
+                Matrix4x4    m;
+                m *= translation(p[0], p[1], p[2]);
+                m *= rotation_z(p[3] * 36.0f);
+                m *= scaling(p[1], p[2], p[0]);
+                full[i] = m;
+            }
+        },
+        COUNT);
+    double t_in_place = time_ns_per_op(
+        [&]() {
+            for(size_t i = 0; i < COUNT; i++)
+            {
+                const float *p = &params[i * 4];
+                Matrix4x4    m;
+                m.translate(p[0], p[1], p[2]);
+                m.rotate_z(p[3] * 36.0f);
+                m.scale(p[1], p[2], p[0]);
+                in_place[i] = m;
+            }
+        },
+        COUNT);
+    double t_composed = time_ns_per_op(
+        [&]() {
+            for(size_t i = 0; i < COUNT; i++)
+            {
+                const float *p = &params[i * 4];
+                composed[i] = Matrix4x4::compose_trs(Vector3(p[0], p[1], p[2]),
+                                                     rotation_z(p[3] * 36.0f),
+                                                     Vector3(p[1], p[2], p[0]));
+            }
+        },
+        COUNT);
+
+    float d_in_place = 0.0f, d_composed = 0.0f;
+    for(size_t i = 0; i < COUNT; i++)
+    {
+        for(int j = 0; j < 16; j++)
+        {
+            float f = full[i].get()[j];
+            d_in_place = std::max(d_in_place, std::abs(in_place[i].get()[j] - f));
+            d_composed = std::max(d_composed, std::abs(composed[i].get()[j] - f));
+        }
+    }
+    logmsg("  TRS build: full multiply %6.2f  in place %6.2f (x%.2f, max diff %g)  "
+           "compose_trs %6.2f (x%.2f, max diff %g)",
+           t_full,
+           t_in_place,
+           t_full / t_in_place,
+           d_in_place,
+           t_composed,
+           t_full / t_composed,
+           d_composed);
+}
+
+// Times a per-frame animated node update: interpolate between 2 key
+// orientations and build T * R * S. Euler keys need trig for every angle;
+// quaternion keys interpolate with slerp / nlerp and convert without trig.
+void rotation_bench()
+{
+    struct EulerKey
+    {
+        float x, y, z;
+    };
+    std::vector<EulerKey>   euler0(COUNT), euler1(COUNT);
+    std::vector<Quaternion> quat0(COUNT), quat1(COUNT);
+    for(size_t i = 0; i < COUNT; i++)
+    {
+        euler0[i] = {rand_0_1() * 360.0f, rand_0_1() * 360.0f, rand_0_1() * 360.0f};
+        euler1[i] = {rand_0_1() * 360.0f, rand_0_1() * 360.0f, rand_0_1() * 360.0f};
+        quat0[i] = Quaternion::from_axis_angle(euler0[i].z, Vector3(0.0f, 0.0f, 1.0f)) *
+                   Quaternion::from_axis_angle(euler0[i].y, Vector3(0.0f, 1.0f, 0.0f)) *
+                   Quaternion::from_axis_angle(euler0[i].x, Vector3(1.0f, 0.0f, 0.0f));
+        quat1[i] = Quaternion::from_axis_angle(euler1[i].z, Vector3(0.0f, 0.0f, 1.0f)) *
+                   Quaternion::from_axis_angle(euler1[i].y, Vector3(0.0f, 1.0f, 0.0f)) *
+                   Quaternion::from_axis_angle(euler1[i].x, Vector3(1.0f, 0.0f, 0.0f));
+    }
+    std::vector<Matrix4x4> out(COUNT);
+    Vector3                t(1.0f, 2.0f, 3.0f), sc(2.0f, 2.0f, 2.0f);
+    float                  f = 0.37f;
+
+    double t_euler = time_ns_per_op(
+        [&]() {
+            for(size_t i = 0; i < COUNT; i++)
+            {
+                Matrix4x4 m;
+                m.translate(t.x, t.y, t.z);
+                m.rotate_z(euler0[i].z + (euler1[i].z - euler0[i].z) * f);
+                m.rotate_y(euler0[i].y + (euler1[i].y - euler0[i].y) * f);
+                m.rotate_x(euler0[i].x + (euler1[i].x - euler0[i].x) * f);
+                m.scale(sc.x, sc.y, sc.z);
+                out[i] = m;
+            }
+            do_not_optimize(out.data());
+        },
+        COUNT);
+    double t_slerp = time_ns_per_op(
+        [&]() {
+            for(size_t i = 0; i < COUNT; i++)
+            {
+                Quaternion q = Quaternion::slerp(quat0[i], quat1[i], f);
+                out[i] = Matrix4x4::compose_trs(t, q.to_matrix(), sc);
+            }
+            do_not_optimize(out.data());
+        },
+        COUNT);
+    double t_nlerp = time_ns_per_op(
+        [&]() {
+            for(size_t i = 0; i < COUNT; i++)
+            {
+                Quaternion q = Quaternion::nlerp(quat0[i], quat1[i], f);
+                out[i] = Matrix4x4::compose_trs(t, q.to_matrix(), sc);
+            }
+            do_not_optimize(out.data());
+        },
+        COUNT);
+
+    // Check the quaternion keys match the Euler matrices
+    float d = 0.0f;
+    for(size_t i = 0; i < COUNT; i++)
+    {
+        Matrix4x4 m;
+        m.rotate_z(euler0[i].z);
+        m.rotate_y(euler0[i].y);
+        m.rotate_x(euler0[i].x);
+        Matrix4x4 q = quat0[i].to_matrix();
+        for(int j = 0; j < 16; j++) d = std::max(d, std::abs(q.get()[j] - m.get()[j]));
+    }
+    logmsg("  animated TRS: Euler keys %6.2f  slerp keys %6.2f (x%.2f)  nlerp keys %6.2f "
+           "(x%.2f)  rotation %zu bytes vs %zu as a matrix  (max diff %g)",
+           t_euler,
+           t_slerp,
+           t_euler / t_slerp,
+           t_nlerp,
+           t_euler / t_nlerp,
+           sizeof(Quaternion),
+           sizeof(Matrix4x4),
+           d);
+}
+
+} // namespace
+
+void matrix_bench()
+{
+    logmsg("Matrix4x4 kernels (%zu operations per pass, ns per operation)", COUNT);
+    logmsg("Selected kernels: %s", simd_level_name(matrix_kernels().level));
+
+    // Random input matrices and points
+    std::vector<float> a(COUNT * 16), b(COUNT * 16), v(COUNT * 4);
+    for(float &f : a) f = rand_0_1() * 2.0f - 1.0f;
+    for(float &f : b) f = rand_0_1() * 2.0f - 1.0f;
+    for(float &f : v) f = rand_0_1() * 10.0f - 5.0f;
+
+    std::vector<float> scalar_result, out(COUNT * 16);
+    KernelTimes        scalar_times{};
+
+    const SimdLevel levels[] = {SimdLevel::SCALAR, SimdLevel::SSE41, SimdLevel::AVX2};
+    for(SimdLevel level : levels)
+    {
+        const MatrixKernels *k = matrix_kernels(level);
+        if(k == nullptr)
+        {
+            logmsg("  %-8s not supported by this CPU", simd_level_name(level));
+            continue;
+        }
+
+        KernelTimes t;
+        t.multiply = time_ns_per_op(
+            [&]() {
+                for(size_t i = 0; i < COUNT; i++)
+                    k->multiply(&a[i * 16], &b[i * 16], &out[i * 16]);
+            },
+            COUNT);
+        std::vector<float> product = out;
+
+        t.transform_hpoint = time_ns_per_op(
+            [&]() {
+                for(size_t i = 0; i < COUNT; i++)
+                    k->transform_hpoint(&a[i * 16], &v[i * 4], &out[i * 4]);
+            },
+            COUNT);
+        t.transform_point = time_ns_per_op(
+            [&]() {
+                for(size_t i = 0; i < COUNT; i++)
+                    k->transform_point(&a[i * 16], &v[i * 4], &out[i * 4]);
+            },
+            COUNT);
+        t.transform_vector = time_ns_per_op(
+            [&]() {
+                for(size_t i = 0; i < COUNT; i++)
+                    k->transform_vector(&a[i * 16], &v[i * 4], &out[i * 4]);
+            },
+            COUNT);
+        t.transpose = time_ns_per_op(
+            [&]() {
+                for(size_t i = 0; i < COUNT; i++) k->transpose(&a[i * 16], &out[i * 16]);
+            },
+            COUNT);
+
+        if(level == SimdLevel::SCALAR)
+        {
+            scalar_times = t;
+            scalar_result = product;
+        }
+
+        logmsg("  %-8s multiply %6.2f (x%.2f)  hpoint %5.2f (x%.2f)  point %5.2f (x%.2f)  "
+               "vector %5.2f (x%.2f)  transpose %5.2f (x%.2f)  max diff %g",
+               simd_level_name(level),
+               t.multiply,
+               scalar_times.multiply / t.multiply,
+               t.transform_hpoint,
+               scalar_times.transform_hpoint / t.transform_hpoint,
+               t.transform_point,
+               scalar_times.transform_point / t.transform_point,
+               t.transform_vector,
+               scalar_times.transform_vector / t.transform_vector,
+               t.transpose,
+               scalar_times.transpose / t.transpose,
+               max_difference(product, scalar_result));
+    }
+
+    trs_bench();
+    rotation_bench();
+}
+
+} // namespace cg
@@ -0,0 +1,102 @@
+#include "Benchmarks/bench_support.hpp"
+
+#include "geometry/geometry.hpp"
+
+#include <cstring>
+#include <vector>
+
+namespace cg
+{
+
+namespace
+{
+
+constexpr size_t SAMPLE_COUNT = 1000000;
+constexpr float  NOISE_SCALE = 0.37f;
+
+void batch_bench(const Noise &noise, NoiseType type)
+{
+    std::vector<Point3> points(SAMPLE_COUNT);
+    for(Point3 &p : points)
+    {
+        p.set(rand_0_1() * 200.0f - 100.0f, rand_0_1() * 50.0f, rand_0_1() * -300.0f);
+    }
+    bool                turb = (type == NoiseType::TURBULENCE);
+    std::vector<float>  expected(SAMPLE_COUNT), out(SAMPLE_COUNT);
+    double              scalar = time_ns_per_op(
+        [&]() {
+            for(size_t i = 0; i < SAMPLE_COUNT; i++)
+            {
+                expected[i] = turb ? noise.turbulence(NOISE_SCALE, points[i])
+                                   : noise.noise(points[i], NOISE_SCALE);
+            }
+        },
+        SAMPLE_COUNT);
+    double batch = time_ns_per_op(
+        [&]() {
+            if(turb)
+                noise.turbulence(NOISE_SCALE, points.data(), SAMPLE_COUNT, out.data());
+            else
+                noise.noise(points.data(), SAMPLE_COUNT, NOISE_SCALE, out.data());
+        },
+        SAMPLE_COUNT);
+    bool same = std::memcmp(expected.data(), out.data(), SAMPLE_COUNT * sizeof(float)) == 0;
+    logmsg("  %-10s %zu samples: scalar %6.2f  batch %6.2f  %s",
+           turb ? "turbulence" : "noise",
+           SAMPLE_COUNT,
+           scalar,
+           batch,
+           same ? "match" : "MISMATCH");
+}
+
+void bake_bench(const Noise &noise, uint32_t nx, uint32_t ny, uint32_t nz)
+{
+    size_t             count = static_cast<size_t>(nx) * ny * nz;
+    std::vector<float> expected(count), grid_1(count), grid_n(count);
+    Point3             origin(-3.0f, 1.5f, 0.25f);
+    Vector3            spacing(0.05f, 0.05f, 0.1f);
+    for(uint32_t k = 0, idx = 0; k < nz; k++)
+    {
+        for(uint32_t j = 0; j < ny; j++)
+        {
+            for(uint32_t i = 0; i < nx; i++, idx++)
+            {
+                Point3 p(origin.x + spacing.x * static_cast<float>(i),
+                         origin.y + spacing.y * static_cast<float>(j),
+                         origin.z + spacing.z * static_cast<float>(k));
+                expected[idx] = noise.turbulence(NOISE_SCALE, p);
+            }
+        }
+    }
+    auto bake = [&](std::vector<float> &grid, uint32_t threads) {
+        noise.bake(NoiseType::TURBULENCE, NOISE_SCALE, origin, spacing, nx, ny, nz, grid.data(),
+                   threads);
+    };
+    double t_1 = time_ns_per_op([&]() { bake(grid_1, 1); }, count, 3);
+    double t_n = time_ns_per_op([&]() { bake(grid_n, 0); }, count, 3);
+    bool   same = std::memcmp(expected.data(), grid_1.data(), count * sizeof(float)) == 0 &&
+                std::memcmp(expected.data(), grid_n.data(), count * sizeof(float)) == 0;
+    logmsg("  bake %4u x %4u x %3u turbulence: %6.2f (1 thread) %6.2f (%u threads)  %s",
+           nx,
+           ny,
+           nz,
+           t_1,
+           t_n,
+           resolve_thread_count(0),
+           same ? "match" : "MISMATCH");
+}
+
+} // namespace
+
+void noise_bench()
+{
+    logmsg("Noise (ns per sample, 4 turbulence octaves)");
+    Noise noise;
+    batch_bench(noise, NoiseType::NOISE);
+    batch_bench(noise, NoiseType::TURBULENCE);
+    bake_bench(noise, 1024, 1024, 1);
+    bake_bench(noise, 128, 128, 128);
+    if(large_benchmarks()) bake_bench(noise, 256, 256, 256);
+}
+
+} // namespace cg
@@ -0,0 +1,92 @@
+#include "Benchmarks/bench_support.hpp"
+
+#include "geometry/geometry.hpp"
+
+#include <cmath>
+#include <memory>
+#include <vector>
+
+namespace cg
+{
+
+namespace
+{
+
+constexpr size_t POINT_COUNT = 100000;
+
+// Smooth wavy outline with short edges, counter-clockwise
+std::vector<Point2> outline(size_t sides)
+{
+    std::vector<Point2> poly(sides);
+    for(size_t i = 0; i < sides; i++)
+    {
+        float angle = 2.0f * PI * static_cast<float>(i) / static_cast<float>(sides);
+        float radius = 80.0f + 15.0f * std::sin(7.0f * angle) + rand_0_1();
+        poly[i].set(radius * std::cos(angle), radius * std::sin(angle));
+    }
+    return poly;
+}
+
+// Star with jagged spikes: long edges, many crossed by any horizontal line
+std::vector<Point2> star(size_t sides)
+{
+    std::vector<Point2> poly(sides);
+    for(size_t i = 0; i < sides; i++)
+    {
+        float angle = 2.0f * PI * static_cast<float>(i) / static_cast<float>(sides);
+        float radius = (i % 2 == 0) ? 100.0f : 40.0f + rand_0_1() * 50.0f;
+        poly[i].set(radius * std::cos(angle), radius * std::sin(angle));
+    }
+    return poly;
+}
+
+void containment_bench(const char *name, const std::vector<Point2> &poly)
+{
+    size_t              sides = poly.size();
+    std::vector<Point2> points(POINT_COUNT);
+    for(Point2 &p : points) p.set(rand_0_1() * 220.0f - 110.0f, rand_0_1() * 220.0f - 110.0f);
+
+    // Vertex list every query
+    std::unique_ptr<bool[]> expected(new bool[POINT_COUNT]);
+    double                  list = time_ns_per_op(
+        [&]() {
+            for(size_t i = 0; i < POINT_COUNT; i++) expected[i] = points[i].is_in_polygon(poly);
+        },
+        POINT_COUNT,
+        (sides > 1000) ? 1 : 5);
+
+    PreparedPolygon prepared;
+    double          build = time_ns_per_op([&]() { prepared.build(poly); }, 1, 3);
+    std::unique_ptr<bool[]> inside(new bool[POINT_COUNT]);
+    double                  single = time_ns_per_op(
+        [&]() { prepared.contains(points.data(), POINT_COUNT, inside.get(), 1); }, POINT_COUNT);
+    size_t count = 0;
+    double threaded = time_ns_per_op(
+        [&]() { count = prepared.contains(points.data(), POINT_COUNT, inside.get()); },
+        POINT_COUNT);
+
+    size_t bad = 0;
+    for(size_t i = 0; i < POINT_COUNT; i++) bad += (inside[i] != expected[i]) ? 1 : 0;
+    logmsg("  %-7s %5zu vertices: vertex list %8.1f  prepared %6.1f (1 thread) %6.1f (%u threads)"
+           " ns per point  (build %.1f us, %zu inside, %s)",
+           name,
+           sides,
+           list,
+           single,
+           threaded,
+           resolve_thread_count(0),
+           build / 1000.0,
+           count,
+           bad == 0 ? "match" : "MISMATCH");
+}
+
+} // namespace
+
+void polygon_bench()
+{
+    logmsg("Point in polygon");
+    for(size_t sides : {16, 256, 4096}) containment_bench("outline", outline(sides));
+    for(size_t sides : {16, 256, 4096}) containment_bench("star", star(sides));
+}
+
+} // namespace cg
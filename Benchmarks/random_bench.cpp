@@ -0,0 +1,157 @@
+#include "Benchmarks/bench_support.hpp"
+
+#include "geometry/geometry.hpp"
+
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+namespace cg
+{
+
+namespace
+{
+
+constexpr size_t   SAMPLE_COUNT = 1000000;
+constexpr uint64_t SEED = 12345;
+
+// rand_0_1 as it was, on the shared std::rand state
+float std_rand_0_1() { return static_cast<float>(std::rand()) / static_cast<float>(RAND_MAX); }
+
+void uniform_bench()
+{
+    std::vector<float> expected(SAMPLE_COUNT), out(SAMPLE_COUNT);
+
+    double t_rand = time_ns_per_op(
+        [&]() {
+            for(size_t i = 0; i < SAMPLE_COUNT; i++) out[i] = std_rand_0_1();
+            do_not_optimize(out.data());
+        },
+        SAMPLE_COUNT);
+
+    std::mt19937                          mt(static_cast<uint32_t>(SEED));
+    std::uniform_real_distribution<float> dist(0.0f, 1.0f);
+    double                                t_mt = time_ns_per_op(
+        [&]() {
+            for(size_t i = 0; i < SAMPLE_COUNT; i++) out[i] = dist(mt);
+            do_not_optimize(out.data());
+        },
+        SAMPLE_COUNT);
+
+    Random r;
+    double t_scalar = time_ns_per_op(
+        [&]() {
+            r.seed(SEED);
+            for(size_t i = 0; i < SAMPLE_COUNT; i++) expected[i] = r.uniform();
+            do_not_optimize(expected.data());
+        },
+        SAMPLE_COUNT);
+    double t_fill = time_ns_per_op(
+        [&]() {
+            r.seed(SEED);
+            r.fill_uniform(out.data(), SAMPLE_COUNT);
+            do_not_optimize(out.data());
+        },
+        SAMPLE_COUNT);
+    bool same = std::memcmp(expected.data(), out.data(), SAMPLE_COUNT * sizeof(float)) == 0;
+    logmsg("  uniform: std::rand %6.2f  mt19937 %6.2f  Random %6.2f  fill %6.2f  %s",
+           t_rand,
+           t_mt,
+           t_scalar,
+           t_fill,
+           same ? "match" : "MISMATCH");
+}
+
+void sphere_box_bench()
+{
+    std::vector<Vector3> dirs(SAMPLE_COUNT);
+    std::vector<Point3>  points(SAMPLE_COUNT);
+    Point3               lo(-10.0f, 0.0f, -30.0f), hi(10.0f, 5.0f, -1.0f);
+
+    // Previous approach: rejection sampling with the old rand_0_1
+    double t_reject = time_ns_per_op(
+        [&]() {
+            for(size_t i = 0; i < SAMPLE_COUNT; i++)
+            {
+                float x, y, z, d2;
+                do
+                {
+                    x = std_rand_0_1() * 2.0f - 1.0f;
+                    y = std_rand_0_1() * 2.0f - 1.0f;
+                    z = std_rand_0_1() * 2.0f - 1.0f;
+                    d2 = x * x + y * y + z * z;
+                } while(d2 > 1.0f || d2 < 1.0e-6f);
+                float s = 1.0f / std::sqrt(d2);
+                dirs[i].set(x * s, y * s, z * s);
+            }
+            do_not_optimize(dirs.data());
+        },
+        SAMPLE_COUNT);
+
+    Random r(SEED);
+    double t_sphere = time_ns_per_op(
+        [&]() {
+            r.fill_on_sphere(dirs.data(), SAMPLE_COUNT);
+            do_not_optimize(dirs.data());
+        },
+        SAMPLE_COUNT);
+    double t_box = time_ns_per_op(
+        [&]() {
+            r.fill_in_box(points.data(), SAMPLE_COUNT, lo, hi);
+            do_not_optimize(points.data());
+        },
+        SAMPLE_COUNT);
+
+    bool ok = true;
+    for(size_t i = 0; i < SAMPLE_COUNT; i++)
+    {
+        const Point3 &p = points[i];
+        ok = ok && std::abs(dirs[i].norm() - 1.0f) < 1.0e-5f && p.x >= lo.x && p.x <= hi.x &&
+             p.y >= lo.y && p.y <= hi.y && p.z >= lo.z && p.z <= hi.z;
+    }
+    logmsg("  on sphere: std::rand rejection %6.2f  fill %6.2f   in box: fill %6.2f  %s",
+           t_reject,
+           t_sphere,
+           t_box,
+           ok ? "ok" : "OUT OF RANGE");
+}
+
+// One stream per task: the result does not depend on the thread count
+void stream_bench()
+{
+    constexpr uint32_t  TASKS = 64;
+    constexpr size_t    PER_TASK = SAMPLE_COUNT / TASKS;
+    std::vector<float>  out_1(TASKS * PER_TASK), out_n(TASKS * PER_TASK);
+    auto                run = [&](std::vector<float> &out, uint32_t threads) {
+        parallel_for(TASKS, threads, 1, [&](size_t first, size_t last) {
+            for(size_t t = first; t < last; t++)
+            {
+                Random r = Random::stream(SEED, static_cast<uint32_t>(t));
+                r.fill_uniform(out.data() + t * PER_TASK, PER_TASK);
+            }
+        });
+    };
+    double t_1 = time_ns_per_op([&]() { run(out_1, 1); }, TASKS * PER_TASK);
+    double t_n = time_ns_per_op([&]() { run(out_n, 0); }, TASKS * PER_TASK);
+    bool   same = std::memcmp(out_1.data(), out_n.data(), out_1.size() * sizeof(float)) == 0;
+    logmsg("  %u streams: %6.2f (1 thread) %6.2f (%u threads)  %s",
+           TASKS,
+           t_1,
+           t_n,
+           resolve_thread_count(0),
+           same ? "match" : "MISMATCH");
+}
+
+} // namespace
+
+void random_bench()
+{
+    logmsg("Random numbers (ns per sample)");
+    uniform_bench();
+    sphere_box_bench();
+    stream_bench();
+}
+
+} // namespace cg
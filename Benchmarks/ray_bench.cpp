@@ -0,0 +1,196 @@
+#include "Benchmarks/bench_support.hpp"
+
+#include "geometry/geometry.hpp"
+
+#include <cmath>
+#include <vector>
+
+namespace cg
+{
+
+namespace
+{
+
+constexpr size_t COUNT = 100000;
+constexpr size_t OBJECTS = 32;
+
+// Moves an object so the object list is not all the same
+void offset(BoundingSphere &s, float f) { s.center.x += f; }
+void offset(AABB &b, float f)
+{
+    b.min_corner.x += f;
+    b.max_corner.x += f;
+}
+void offset(Plane &p, float f) { p.d += f; }
+
+// Number of lanes whose hit flag or distance differs from the Ray3 result
+template <typename Result>
+size_t mismatches(const std::vector<Result> &expected, const std::vector<Result> &out)
+{
+    size_t n = 0;
+    for(size_t i = 0; i < expected.size(); i++)
+    {
+        if(expected[i].intersects != out[i].intersects ||
+           expected[i].distance != out[i].distance)
+            n++;
+    }
+    return n;
+}
+
+// Nearest hit of one ray over a list of objects, one ray at a time
+template <typename Object>
+float nearest(const Ray3 &ray, const std::vector<Object> &objects)
+{
+    float t = INFINITY;
+    for(const Object &object : objects)
+    {
+        RayObjectIntersectResult r = ray.intersect(object);
+        if(r.intersects && r.distance < t) t = r.distance;
+    }
+    return t;
+}
+
+// Nearest hit of each ray in a packet over a list of objects
+template <size_t N, typename Object>
+FloatxN<N> nearest(const RayPacket<N> &packet, const std::vector<Object> &objects)
+{
+    FloatxN<N> t = FloatxN<N>::broadcast(INFINITY);
+    for(const Object &object : objects)
+    {
+        RayPacketHit<N> r = packet.intersect(object);
+        t = select(r.hit & (r.distance < t), r.distance, t);
+    }
+    return t;
+}
+
+// Times nearest hits over an object list with the rays loaded into
+// packets once and reused for every object
+template <size_t N, typename Object>
+double packet_time(const std::vector<Ray3>   &rays,
+                   const std::vector<Object> &objects,
+                   std::vector<float>        &out,
+                   size_t                     ops)
+{
+    std::vector<RayPacket<N>> packets(rays.size() / N);
+    for(size_t i = 0; i < packets.size(); i++) packets[i] = RayPacket<N>::load(&rays[i * N]);
+    return time_ns_per_op(
+        [&]() {
+            for(size_t i = 0; i < packets.size(); i++)
+                nearest(packets[i], objects).store(&out[i * N]);
+        },
+        ops);
+}
+
+// Times Ray3 one ray at a time against packets of 4, 8 and 16 rays
+template <typename Object>
+void object_bench(const char *name, const std::vector<Ray3> &rays, const Object &object)
+{
+    // One object, rays converted to packets on every call
+    std::vector<RayObjectIntersectResult> expected(rays.size()), out(rays.size());
+    double per_ray = time_ns_per_op(
+        [&]() {
+            for(size_t i = 0; i < rays.size(); i++) expected[i] = rays[i].intersect(object);
+        },
+        rays.size());
+    double bulk = time_ns_per_op(
+        [&]() { intersect_rays<8>(rays.data(), rays.size(), object, out.data()); },
+        rays.size());
+    size_t bad = mismatches(expected, out);
+
+    // Many objects (e.g. picking against every object in a scene)
+    std::vector<Object> objects(OBJECTS, object);
+    for(size_t i = 0; i < OBJECTS; i++) offset(objects[i], static_cast<float>(i) * 0.05f);
+    size_t             ops = rays.size() * OBJECTS;
+    std::vector<float> t_ray(rays.size()), t_packet(rays.size());
+    double             many_ray = time_ns_per_op(
+        [&]() {
+            for(size_t i = 0; i < rays.size(); i++) t_ray[i] = nearest(rays[i], objects);
+        },
+        ops);
+    double x4 = packet_time<4>(rays, objects, t_packet, ops);
+    bad += (t_packet != t_ray) ? 1 : 0;
+    double x8 = packet_time<8>(rays, objects, t_packet, ops);
+    bad += (t_packet != t_ray) ? 1 : 0;
+    double x16 = packet_time<16>(rays, objects, t_packet, ops);
+    bad += (t_packet != t_ray) ? 1 : 0;
+
+    logmsg("  %-9s Ray3 %6.2f  intersect_rays %6.2f | x%zu objects: Ray3 %5.2f  x4 %5.2f  "
+           "x8 %5.2f  x16 %5.2f  mismatches %zu",
+           name,
+           per_ray,
+           bulk,
+           OBJECTS,
+           many_ray,
+           x4,
+           x8,
+           x16,
+           bad);
+}
+
+} // namespace
+
+void ray_bench()
+{
+    logmsg("Ray packet intersection (%zu rays, ns per ray)", COUNT);
+
+    // Rays from around the origin in random unit directions
+    std::vector<Ray3> rays(COUNT);
+    for(Ray3 &r : rays)
+    {
+        r = Ray3(Point3(rand_0_1() * 2.0f - 1.0f, rand_0_1() * 2.0f - 1.0f, rand_0_1() * 2.0f),
+                 Vector3(rand_0_1() - 0.5f, rand_0_1() - 0.5f, -rand_0_1()),
+                 true);
+    }
+
+    object_bench("sphere", rays, BoundingSphere(Point3(0.5f, -0.25f, -10.0f), 3.0f));
+    object_bench("box", rays, AABB(Point3(-2.0f, -2.0f, -12.0f), Point3(3.0f, 1.0f, -8.0f)));
+    object_bench("plane", rays, Plane(Point3(0.0f, 0.0f, -5.0f), Vector3(0.2f, 0.1f, 1.0f)));
+
+    // Triangle
+    Point3 v0(-3.0f, -2.0f, -6.0f), v1(4.0f, -1.0f, -7.0f), v2(0.0f, 3.0f, -6.5f);
+    std::vector<RayTriangleIntersectResult> expected(COUNT), out(COUNT);
+    double per_ray = time_ns_per_op(
+        [&]() {
+            for(size_t i = 0; i < COUNT; i++) expected[i] = rays[i].intersect(v0, v1, v2);
+        },
+        COUNT);
+    double x8 = time_ns_per_op(
+        [&]() { intersect_rays<8>(rays.data(), COUNT, v0, v1, v2, out.data()); }, COUNT);
+    size_t hits = 0;
+    for(const RayTriangleIntersectResult &r : expected) hits += r.intersects ? 1 : 0;
+    logmsg("  %-9s Ray3 %6.2f  x8 %6.2f  mismatches %zu  (%zu hits)",
+           "triangle",
+           per_ray,
+           x8,
+           mismatches(expected, out),
+           hits);
+
+    // Axis parallel rays starting on the box's slab planes: a zero direction
+    // component makes the slab distance 0 * inf = NaN, which the packets
+    // must treat as Ray3 does
+    AABB              box(Point3(-2.0f, -2.0f, -12.0f), Point3(3.0f, 1.0f, -8.0f));
+    const float       xs[] = {-3.0f, -2.0f, 0.0f, 3.0f, 4.0f};
+    const float       ys[] = {-3.0f, -2.0f, 0.0f, 1.0f, 2.0f};
+    const float       zs[] = {-13.0f, -12.0f, -10.0f, -8.0f, -7.0f};
+    std::vector<Ray3> edge_rays;
+    for(float x : xs)
+        for(float y : ys)
+            for(float z : zs)
+                for(int32_t axis = 0; axis < 3; axis++)
+                    for(float sign : {-1.0f, 1.0f})
+                    {
+                        Vector3 d(axis == 0 ? sign : 0.0f,
+                                  axis == 1 ? sign : 0.0f,
+                                  axis == 2 ? sign : 0.0f);
+                        edge_rays.push_back(Ray3(Point3(x, y, z), d));
+                    }
+    std::vector<RayObjectIntersectResult> edge_expected(edge_rays.size());
+    std::vector<RayObjectIntersectResult> edge_out(edge_rays.size());
+    for(size_t i = 0; i < edge_rays.size(); i++) edge_expected[i] = edge_rays[i].intersect(box);
+    intersect_rays<8>(edge_rays.data(), edge_rays.size(), box, edge_out.data());
+    logmsg("  box, %zu axis parallel rays on its planes: mismatches %zu",
+           edge_rays.size(),
+           mismatches(edge_expected, edge_out));
+}
+
+} // namespace cg
@@ -0,0 +1,96 @@
+#include "Benchmarks/bench_support.hpp"
+
+#include "geometry/geometry.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace cg
+{
+
+namespace
+{
+
+// Vertices handed to the streaming build per call
+constexpr size_t SPAN_SIZE = 4096;
+
+bool contains_all(const BoundingSphere &s, const std::vector<Point3> &points)
+{
+    return std::all_of(points.begin(), points.end(), [&](const Point3 &p) {
+        return s.contains(p);
+    });
+}
+
+void fit_bench(const char *name, const std::vector<Point3> &points)
+{
+    size_t         count = points.size();
+    BoundingSphere ritter_1, ritter_n, streamed, tight;
+    double         t_ritter_1 =
+        time_ns_per_op([&]() { ritter_1.create(points.data(), count, 1); }, count);
+    double t_ritter_n = time_ns_per_op([&]() { ritter_n.create(points.data(), count, 0); }, count);
+
+    // Vertex data arriving in spans, e.g. while an asset streams in
+    double t_streamed = time_ns_per_op(
+        [&]() {
+            streamed = BoundingSphere(points[0], 0.0f);
+            for(size_t first = 0; first < count; first += SPAN_SIZE)
+            {
+                streamed.grow(points.data() + first, std::min(SPAN_SIZE, count - first));
+            }
+        },
+        count);
+    double t_tight = time_ns_per_op([&]() { tight.create_tight(points.data(), count); }, count, 3);
+
+    bool ok = contains_all(ritter_1, points) && contains_all(ritter_n, points) &&
+              contains_all(streamed, points) && contains_all(tight, points);
+    logmsg("  %-9s %8zu pts: Ritter %5.2f (1 thread) %5.2f (%u threads) +%4.1f%%"
+           "  stream %5.2f +%5.1f%%  tight %6.2f  %s",
+           name,
+           count,
+           t_ritter_1,
+           t_ritter_n,
+           resolve_thread_count(0),
+           100.0f * (ritter_1.radius / tight.radius - 1.0f),
+           t_streamed,
+           100.0f * (streamed.radius / tight.radius - 1.0f),
+           t_tight,
+           ok ? "ok" : "NOT CONTAINED");
+}
+
+void cloud_bench(size_t count)
+{
+    // Uniform box, points on an ellipsoid surface (scanned / tessellated
+    // mesh) and a dense cluster with a few far outliers
+    std::vector<Point3> box(count), shell(count), cluster(count);
+    for(size_t i = 0; i < count; i++)
+    {
+        box[i].set(rand_0_1() * 40.0f - 20.0f, rand_0_1() * 10.0f, rand_0_1() * -30.0f);
+
+        float theta = rand_0_1() * 2.0f * PI;
+        float z = rand_0_1() * 2.0f - 1.0f;
+        float s = std::sqrt(1.0f - z * z);
+        shell[i].set(8.0f * s * std::cos(theta) + 3.0f, 4.0f * s * std::sin(theta), 2.0f * z);
+
+        cluster[i].set(rand_0_1(), rand_0_1(), rand_0_1());
+    }
+    for(size_t i = 0; i < 8; i++)
+    {
+        cluster[(i * count) / 8].set(rand_0_1() * 20.0f - 10.0f, 10.0f, rand_0_1() * 5.0f);
+    }
+    fit_bench("box", box);
+    fit_bench("ellipsoid", shell);
+    fit_bench("outliers", cluster);
+}
+
+} // namespace
+
+void sphere_bench()
+{
+    logmsg("Bounding sphere fits (ns per point, radius over the minimum sphere)");
+    cloud_bench(100000);
+    cloud_bench(1000000);
+    if(large_benchmarks()) cloud_bench(10000000);
+}
+
+} // namespace cg
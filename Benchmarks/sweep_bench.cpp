@@ -0,0 +1,193 @@
+#include "Benchmarks/bench_support.hpp"
+
+#include "geometry/geometry.hpp"
+
+#include <cmath>
+#include <vector>
+
+namespace cg
+{
+
+namespace
+{
+
+constexpr float WORLD_SIZE = 1000.0f;
+
+bool same(const std::vector<SegmentPairIntersection> &a,
+          const std::vector<SegmentPairIntersection> &b)
+{
+    if(a.size() != b.size()) return false;
+    for(size_t i = 0; i < a.size(); i++)
+    {
+        if(a[i].first != b[i].first || a[i].second != b[i].second || !(a[i].point == b[i].point))
+            return false;
+    }
+    return true;
+}
+
+void set_bench(const char *name, const std::vector<LineSegment2> &segments)
+{
+    size_t n = segments.size();
+
+    // Every pair, as a caller of LineSegment2::intersect would do it
+    std::vector<SegmentPairIntersection> expected;
+    double                               brute = time_ns_per_op(
+        [&]() {
+            expected.clear();
+            for(uint32_t i = 0; i < n; i++)
+            {
+                for(uint32_t j = i + 1; j < n; j++)
+                {
+                    Segment2IntersectionResult r = segments[i].intersect(segments[j]);
+                    if(r.intersects) expected.push_back({i, j, r.intersect_point});
+                }
+            }
+        },
+        1,
+        1);
+
+    std::vector<SegmentPairIntersection> swept, pruned_1, pruned_n, chosen;
+    bool                                 swept_ok = false;
+    double sweep = time_ns_per_op(
+        [&]() { swept_ok = sweep_segment_intersections(segments, swept); }, 1, 3);
+    double prune_1 =
+        time_ns_per_op([&]() { prune_segment_intersections(segments, pruned_1, 1); }, 1, 3);
+    double prune_n =
+        time_ns_per_op([&]() { prune_segment_intersections(segments, pruned_n, 0); }, 1, 3);
+    double find = time_ns_per_op([&]() { find_segment_intersections(segments, chosen); }, 1, 3);
+
+    logmsg("  %-10s %6zu segments %7zu crossings: all pairs %8.2f  sweep %7.2f%s"
+           "  prune %7.2f (1 thread) %7.2f (%u threads)  chosen %7.2f ms  %s",
+           name,
+           n,
+           expected.size(),
+           brute * 1.0e-6,
+           sweep * 1.0e-6,
+           swept_ok ? "" : " (declined)",
+           prune_1 * 1.0e-6,
+           prune_n * 1.0e-6,
+           resolve_thread_count(0),
+           find * 1.0e-6,
+           ((!swept_ok || same(expected, swept)) && same(expected, pruned_1) &&
+            same(expected, pruned_n) && same(expected, chosen))
+               ? "match"
+               : "MISMATCH");
+}
+
+// Random short segments scattered over the world
+std::vector<LineSegment2> scattered(size_t n, float length)
+{
+    std::vector<LineSegment2> s(n);
+    for(LineSegment2 &seg : s)
+    {
+        seg.a.set(rand_0_1() * WORLD_SIZE, rand_0_1() * WORLD_SIZE);
+        seg.b.set(seg.a.x + (rand_0_1() - 0.5f) * length, seg.a.y + (rand_0_1() - 0.5f) * length);
+    }
+    return s;
+}
+
+// Connected strokes: consecutive segments share endpoints
+std::vector<LineSegment2> strokes(size_t n)
+{
+    std::vector<LineSegment2> s(n);
+    Point2                    p(WORLD_SIZE * 0.5f, WORLD_SIZE * 0.5f);
+    for(size_t i = 0; i < n; i++)
+    {
+        if(i % 50 == 0) p.set(rand_0_1() * WORLD_SIZE, rand_0_1() * WORLD_SIZE);
+        Point2 q(p.x + (rand_0_1() - 0.5f) * 40.0f, p.y + (rand_0_1() - 0.5f) * 40.0f);
+        s[i] = LineSegment2(p, q);
+        p = q;
+    }
+    return s;
+}
+
+// Long, nearly horizontal strokes (hatching): every x extent overlaps but
+// few segments cross
+std::vector<LineSegment2> hatching(size_t n)
+{
+    std::vector<LineSegment2> s(n);
+    for(LineSegment2 &seg : s)
+    {
+        float y = rand_0_1() * WORLD_SIZE;
+        seg.a.set(rand_0_1() * 10.0f, y);
+        seg.b.set(WORLD_SIZE - rand_0_1() * 10.0f, y + (rand_0_1() - 0.5f) * 2.0f);
+    }
+    return s;
+}
+
+// Segments fanning out from one point (many segments through a point)
+std::vector<LineSegment2> fan(size_t n)
+{
+    std::vector<LineSegment2> s(n);
+    Point2                    c(WORLD_SIZE * 0.5f, WORLD_SIZE * 0.5f);
+    for(size_t i = 0; i < n; i++)
+    {
+        float angle = 2.0f * PI * (static_cast<float>(i) + 0.5f) / static_cast<float>(n);
+        s[i] = LineSegment2(c, c + Vector2(300.0f * std::cos(angle), 300.0f * std::sin(angle)));
+    }
+    return s;
+}
+
+// Hatching crossed by a few vertical strokes
+std::vector<LineSegment2> hatching_vertical(size_t n, size_t vertical_count)
+{
+    std::vector<LineSegment2> s = hatching(n - vertical_count);
+    for(size_t i = 0; i < vertical_count; i++)
+    {
+        float x = rand_0_1() * WORLD_SIZE;
+        float y = rand_0_1() * WORLD_SIZE * 0.5f;
+        s.push_back(LineSegment2(Point2(x, y), Point2(x, y + rand_0_1() * WORLD_SIZE * 0.5f)));
+    }
+    return s;
+}
+
+// Axis aligned segments on an integer grid, half of them vertical, as in a
+// floor plan: many share endpoints, T junctions and collinear overlaps.
+// Every 100th segment has zero length.
+std::vector<LineSegment2> axis_aligned(size_t n)
+{
+    std::vector<LineSegment2> s(n);
+    for(size_t i = 0; i < n; i++)
+    {
+        Point2 p(std::floor(rand_0_1() * WORLD_SIZE), std::floor(rand_0_1() * WORLD_SIZE));
+        float  length = (i % 100 == 0) ? 0.0f : std::floor(1.0f + rand_0_1() * 40.0f);
+        Point2 q = (i % 2 == 0) ? Point2(p.x, p.y + length) : Point2(p.x + length, p.y);
+        s[i] = LineSegment2(p, q);
+    }
+    return s;
+}
+
+// Outlines of axis aligned rectangles: corners shared by a horizontal and
+// a vertical segment
+std::vector<LineSegment2> rectangles(size_t n)
+{
+    std::vector<LineSegment2> s;
+    for(size_t i = 0; i < n / 4; i++)
+    {
+        float x0 = rand_0_1() * WORLD_SIZE, y0 = rand_0_1() * WORLD_SIZE;
+        float x1 = x0 + 1.0f + rand_0_1() * 30.0f, y1 = y0 + 1.0f + rand_0_1() * 30.0f;
+        s.push_back(LineSegment2(Point2(x0, y0), Point2(x1, y0)));
+        s.push_back(LineSegment2(Point2(x1, y0), Point2(x1, y1)));
+        s.push_back(LineSegment2(Point2(x1, y1), Point2(x0, y1)));
+        s.push_back(LineSegment2(Point2(x0, y1), Point2(x0, y0)));
+    }
+    return s;
+}
+
+} // namespace
+
+void sweep_bench()
+{
+    logmsg("All-pairs segment intersection (ms per set)");
+    set_bench("scattered", scattered(2000, 40.0f));
+    set_bench("scattered", scattered(10000, 20.0f));
+    set_bench("strokes", strokes(10000));
+    set_bench("hatching", hatching(10000));
+    set_bench("fan", fan(500));
+    set_bench("hatch+vert", hatching_vertical(10000, 20));
+    set_bench("axis", axis_aligned(10000));
+    set_bench("rectangles", rectangles(10000));
+    if(large_benchmarks()) set_bench("scattered", scattered(50000, 10.0f));
+}
+
+} // namespace cg
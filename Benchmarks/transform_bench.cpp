@@ -0,0 +1,105 @@
+#include "Benchmarks/bench_support.hpp"
+
+#include "geometry/geometry.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace cg
+{
+
+namespace
+{
+
+constexpr size_t COUNT = 100000;
+
+float max_difference(const std::vector<Point3> &a, const std::vector<Point3> &b)
+{
+    float d = 0.0f;
+    for(size_t i = 0; i < a.size(); i++)
+    {
+        d = std::max(d, std::abs(a[i].x - b[i].x));
+        d = std::max(d, std::abs(a[i].y - b[i].y));
+        d = std::max(d, std::abs(a[i].z - b[i].z));
+    }
+    return d;
+}
+
+} // namespace
+
+void transform_bench()
+{
+    logmsg("Batch transforms (%zu points, ns per point)", COUNT);
+
+    Matrix4x4 m;
+    m.translate(1.0f, -2.0f, 3.0f);
+    m.rotate(30.0f, 0.3f, 0.5f, 0.8f);
+    m.scale(1.5f, 0.5f, 2.0f);
+
+    Matrix4x4 proj;
+    proj.m00() = 1.428f;
+    proj.m11() = 1.428f;
+    proj.m22() = -1.010f;
+    proj.m23() = -2.010f;
+    proj.m32() = -1.0f;
+    proj.m33() = 0.0f;
+
+    std::vector<Point3> in(COUNT);
+    for(Point3 &p : in)
+    {
+        p.set(rand_0_1() * 100.0f - 50.0f, rand_0_1() * 100.0f - 50.0f, rand_0_1() * -100.0f - 1.0f);
+    }
+    std::vector<Point3> expected(COUNT), out(COUNT);
+
+    // Affine: per point operator* versus batch
+    double per_point = time_ns_per_op(
+        [&]() {
+            for(size_t i = 0; i < COUNT; i++) expected[i] = m * in[i];
+        },
+        COUNT);
+    double batch = time_ns_per_op(
+        [&]() { transform_points(m, in.data(), out.data(), COUNT, false); }, COUNT);
+    logmsg("  affine points      per point %6.2f  batch %6.2f (x%.2f)  max diff %g",
+           per_point,
+           batch,
+           per_point / batch,
+           max_difference(expected, out));
+
+    // Projective: per point HPoint3 transform and divide versus batch
+    per_point = time_ns_per_op(
+        [&]() {
+            for(size_t i = 0; i < COUNT; i++)
+                expected[i] = (proj * HPoint3(in[i].x, in[i].y, in[i].z, 1.0f)).to_cartesian();
+        },
+        COUNT);
+    batch = time_ns_per_op(
+        [&]() { transform_points(proj, in.data(), out.data(), COUNT, true); }, COUNT);
+    logmsg("  projected points   per point %6.2f  batch %6.2f (x%.2f)  max diff %g",
+           per_point,
+           batch,
+           per_point / batch,
+           max_difference(expected, out));
+
+    // Structure of arrays input
+    std::vector<float> x(COUNT), y(COUNT), z(COUNT), ox(COUNT), oy(COUNT), oz(COUNT);
+    for(size_t i = 0; i < COUNT; i++)
+    {
+        x[i] = in[i].x;
+        y[i] = in[i].y;
+        z[i] = in[i].z;
+    }
+    batch = time_ns_per_op(
+        [&]() {
+            transform_points(m, {x.data(), y.data(), z.data()},
+                             {ox.data(), oy.data(), oz.data()}, COUNT, false);
+        },
+        COUNT);
+    for(size_t i = 0; i < COUNT; i++) expected[i] = m * in[i];
+    for(size_t i = 0; i < COUNT; i++) out[i].set(ox[i], oy[i], oz[i]);
+    logmsg("  affine points SoA                    batch %6.2f          max diff %g",
+           batch,
+           max_difference(expected, out));
+}
+
+} // namespace cg
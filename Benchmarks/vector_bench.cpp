@@ -0,0 +1,174 @@
+#include "Benchmarks/bench_support.hpp"
+
+#include "geometry/geometry.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace cg
+{
+
+namespace
+{
+
+constexpr size_t COUNT = 100000;
+
+// Times the same dot / cross / normalize loops on N-wide packets
+template <size_t N>
+void packet_bench(const std::vector<Vector3> &a, const std::vector<Vector3> &b)
+{
+    std::vector<Vector3xN<N>> pa(COUNT / N), pb(COUNT / N), out(COUNT / N);
+    for(size_t i = 0; i < pa.size(); i++)
+    {
+        pa[i] = Vector3xN<N>::load(&a[i * N]);
+        pb[i] = Vector3xN<N>::load(&b[i * N]);
+    }
+
+    FloatxN<N> sum = FloatxN<N>::broadcast(0.0f);
+    double     t_dot = time_ns_per_op(
+        [&]() {
+            for(size_t i = 0; i < pa.size(); i++) sum = sum + pa[i].dot(pb[i]);
+        },
+        COUNT);
+    double t_cross = time_ns_per_op(
+        [&]() {
+            for(size_t i = 0; i < pa.size(); i++) out[i] = pa[i].cross(pb[i]);
+        },
+        COUNT);
+    double t_normalize = time_ns_per_op(
+        [&]() {
+            for(size_t i = 0; i < pa.size(); i++)
+            {
+                out[i] = pa[i];
+                out[i].normalize();
+            }
+        },
+        COUNT);
+    do_not_optimize(sum);
+
+    // Check against the scalar results
+    float max_diff = 0.0f;
+    for(size_t i = 0; i < pa.size(); i++)
+    {
+        for(size_t j = 0; j < N; j++)
+        {
+            Vector3 expected = a[i * N + j];
+            expected.normalize();
+            Vector3 d = out[i].get(j) - expected;
+            max_diff = std::max(max_diff, std::sqrt(d.norm_squared()));
+        }
+    }
+    logmsg("  Vector3x%zu: dot %.2f  cross %.2f  normalize %.2f  (max diff from Vector3 %g)",
+           N,
+           t_dot,
+           t_cross,
+           t_normalize,
+           max_diff);
+}
+
+// Times normalize_vectors at each accuracy against the scalar loops
+void normalize_batch_bench(const std::vector<Vector3> &a)
+{
+    std::vector<Vector3> out(COUNT);
+    std::vector<float>   inv(COUNT);
+    double               t_quake = time_ns_per_op(
+        [&]() {
+            for(size_t i = 0; i < COUNT; i++) out[i] = a[i] * fast_inv_sqrt(a[i].norm_squared());
+            do_not_optimize(out.data());
+        },
+        COUNT);
+    logmsg("  fast_inv_sqrt loop %.2f", t_quake);
+
+    const char *names[] = {"fast", "refined", "exact"};
+    for(NormalizeAccuracy accuracy :
+        {NormalizeAccuracy::FAST, NormalizeAccuracy::REFINED, NormalizeAccuracy::EXACT})
+    {
+        double t_normalize = time_ns_per_op(
+            [&]() {
+                normalize_vectors(a.data(), out.data(), COUNT, accuracy);
+                do_not_optimize(out.data());
+            },
+            COUNT);
+        double t_inverse = time_ns_per_op(
+            [&]() {
+                inverse_lengths(a.data(), inv.data(), COUNT, accuracy);
+                do_not_optimize(inv.data());
+            },
+            COUNT);
+        float max_error = 0.0f;
+        for(const Vector3 &v : out) max_error = std::max(max_error, std::abs(v.norm() - 1.0f));
+        logmsg("  normalize_vectors %-7s %.2f  inverse_lengths %.2f  (max |length - 1| %g)",
+               names[static_cast<int>(accuracy)],
+               t_normalize,
+               t_inverse,
+               max_error);
+    }
+}
+
+} // namespace
+
+void vector_bench()
+{
+    logmsg("Vector3 / Point3 hot loops (%zu elements, ns per element)", COUNT);
+
+    std::vector<Vector3> a(COUNT), b(COUNT), out(COUNT);
+    std::vector<Point3>  p(COUNT), q(COUNT);
+    for(size_t i = 0; i < COUNT; i++)
+    {
+        a[i].set(rand_0_1() - 0.5f, rand_0_1() - 0.5f, rand_0_1() - 0.5f);
+        b[i].set(rand_0_1() - 0.5f, rand_0_1() - 0.5f, rand_0_1() - 0.5f);
+        p[i].set(rand_0_1() * 10.0f, rand_0_1() * 10.0f, rand_0_1() * 10.0f);
+    }
+    Matrix4x4 m;
+    m.translate(1.0f, 2.0f, 3.0f);
+    m.rotate_y(30.0f);
+
+    float  sum = 0.0f;
+    double t_dot = time_ns_per_op(
+        [&]() {
+            for(size_t i = 0; i < COUNT; i++) sum += a[i].dot(b[i]);
+        },
+        COUNT);
+    double t_cross = time_ns_per_op(
+        [&]() {
+            for(size_t i = 0; i < COUNT; i++) out[i] = a[i].cross(b[i]);
+        },
+        COUNT);
+    double t_normalize = time_ns_per_op(
+        [&]() {
+            for(size_t i = 0; i < COUNT; i++)
+            {
+                out[i] = a[i];
+                out[i].normalize();
+            }
+        },
+        COUNT);
+    double t_add = time_ns_per_op(
+        [&]() {
+            for(size_t i = 0; i < COUNT; i++) q[i] = p[i] + a[i] * 0.5f;
+        },
+        COUNT);
+    double t_matrix = time_ns_per_op(
+        [&]() {
+            for(size_t i = 0; i < COUNT; i++) out[i] = m * a[i];
+        },
+        COUNT);
+    double t_copy = time_ns_per_op([&]() { q = p; }, COUNT);
+    do_not_optimize(sum);
+
+    logmsg("  dot %.2f  cross %.2f  normalize %.2f  point + vector * s %.2f  "
+           "matrix * vector %.2f  copy %.2f",
+           t_dot,
+           t_cross,
+           t_normalize,
+           t_add,
+           t_matrix,
+           t_copy);
+
+    normalize_batch_bench(a);
+    packet_bench<4>(a, b);
+    packet_bench<8>(a, b);
+}
+
+} // namespace cg
@@ -1,5 +1,8 @@
 #include "Module3/color_blending_node.hpp"
 
+#include "scene/gl_state_cache.hpp"
+#include "scene/render_list.hpp"
+
 namespace cg
 {
 
@@ -12,18 +15,27 @@ ColorBlendingNode::ColorBlendingNode(const Color4 &c, bool b)
 void ColorBlendingNode::draw(SceneState &scene_state)
 {
     // Enable blending
+    GLStateCache &gl = gl_state();
     if(blending_)
     {
-        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-        glEnable(GL_BLEND);
+        gl.blend_func(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        gl.set_enabled(GL_BLEND, true);
     }
 
     // Set the current color and draw all children.
-    glUniform4fv(scene_state.color_loc, 1, &color_.r);
+    gl.uniform4fv(scene_state.color_loc, &color_.r);
     SceneNode::draw(scene_state);
 
     // Disable blending so it is not enabled except for children of this node
-    if(blending_) { glDisable(GL_BLEND); }
+    if(blending_) { gl.set_enabled(GL_BLEND, false); }
+}
+
+void ColorBlendingNode::compile(RenderCompiler &compiler)
+{
+    uint32_t material = compiler.material;
+    compiler.material = compiler.list.add_material(color_, MaterialUniform::COLOR, blending_);
+    compile_children(compiler);
+    compiler.material = material;
 }
 
 } // namespace cg
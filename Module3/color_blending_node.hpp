@@ -36,6 +36,14 @@ class ColorBlendingNode : public PresentationNode
      */
     void draw(SceneState &scene_state) override;
 
+    /**
+     * Compile this presentation node and its children. The color becomes
+     * the material of the draw records below it, blended if blending is
+     * enabled.
+     * @param  compiler  Render list being compiled.
+     */
+    void compile(RenderCompiler &compiler) override;
+
   protected:
     bool   blending_;
     Color4 color_;
@@ -1,6 +1,7 @@
 #include "Module3/drag_line_node.hpp"
 
 #include "geometry/segment2.hpp"
+#include "scene/gl_state_cache.hpp"
 #include "scene/scene.hpp"
 
 #include <vector>
@@ -21,7 +22,8 @@ DragLineNode::DragLineNode(
 
     // Load dummy data into the vertex position VBO
     std::vector<LineSegment2> pts(capacity_);
-    glBindBuffer(GL_ARRAY_BUFFER, vbo_);
+    GLStateCache             &gl = gl_state();
+    gl.bind_buffer(GL_ARRAY_BUFFER, vbo_);
     glBufferData(GL_ARRAY_BUFFER,
                  capacity_ * 2 * sizeof(PositionAndColor),
                  (GLvoid *)&pts[0],
@@ -29,10 +31,10 @@ DragLineNode::DragLineNode(
 
     // Allocate a VAO, enable it and set the vertex attribute arrays and pointers
     glGenVertexArrays(1, &vao_);
-    glBindVertexArray(vao_);
+    gl.bind_vertex_array(vao_);
 
     // Enable vertex attribute array and pointer so they are bound to the VAO
-    glBindBuffer(GL_ARRAY_BUFFER, vbo_);
+    gl.bind_buffer(GL_ARRAY_BUFFER, vbo_);
     glVertexAttribPointer(position_loc, 2, GL_FLOAT, GL_FALSE, sizeof(PositionAndColor), (void *)0);
     glEnableVertexAttribArray(position_loc);
 
@@ -42,7 +44,7 @@ DragLineNode::DragLineNode(
     glEnableVertexAttribArray(color_loc);
 
     // Make sure changes to this VAO are local
-    glBindVertexArray(0);
+    gl.bind_vertex_array(0);
 }
 
 void DragLineNode::set_width(float w) { width_ = w; }
@@ -53,7 +55,7 @@ void DragLineNode::replace_point_0(const Point2 &pt)
 {
     // Replace the first vertex and color in the VBO.
     start_vertex_.position = pt;
-    glBindBuffer(GL_ARRAY_BUFFER, vbo_);
+    gl_state().bind_buffer(GL_ARRAY_BUFFER, vbo_);
     glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(PositionAndColor), (GLvoid *)&start_vertex_);
     draw_ = false;
 }
@@ -62,7 +64,7 @@ void DragLineNode::replace_point_1(const Point2 &pt)
 {
     // Replace the first vertex and color in the VBO.
     end_vertex_.position = pt;
-    glBindBuffer(GL_ARRAY_BUFFER, vbo_);
+    gl_state().bind_buffer(GL_ARRAY_BUFFER, vbo_);
     glBufferSubData(GL_ARRAY_BUFFER,
                     sizeof(PositionAndColor),
                     sizeof(PositionAndColor),
@@ -80,9 +82,8 @@ void DragLineNode::draw(SceneState &scene_state)
         check_error("DragLineNode - after width");
 
         // Draw - the count in glDrawArrays is the number of vertices in the list
-        glBindVertexArray(vao_);
+        gl_state().bind_vertex_array(vao_);
         glDrawArrays(GL_LINES, 0, 2);
-        glBindVertexArray(0);
     }
 }
 
@@ -1,5 +1,7 @@
 #include "Module3/line_shader_node.hpp"
 
+#include "scene/gl_state_cache.hpp"
+
 #include <iostream>
 
 namespace cg
@@ -31,7 +33,7 @@ bool LineShaderNode::get_locations()
 void LineShaderNode::draw(SceneState &scene_state)
 {
     // Enable this program
-    shader_program_.use();
+    gl_state().use_program(shader_program_.get_program());
 
     // Set scene state locations to ones needed for this program
     scene_state.ortho_matrix_loc = ortho_matrix_loc_;
@@ -39,7 +41,7 @@ void LineShaderNode::draw(SceneState &scene_state)
     scene_state.vtx_color_loc = vertex_color_loc_;
 
     // Set the matrix
-    glUniformMatrix4fv(ortho_matrix_loc_, 1, GL_FALSE, scene_state.ortho_matrix.get());
+    gl_state().uniform_matrix4fv(ortho_matrix_loc_, scene_state.ortho_matrix.get());
 
     // Draw all children
     SceneNode::draw(scene_state);
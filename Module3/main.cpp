@@ -67,6 +67,9 @@ std::shared_ptr<cg::NGonNode> g_octagon;
 std::shared_ptr<cg::NGonNode> g_circle;
 std::shared_ptr<cg::NGonNode> g_hexagon;
 
+// Spatial index over the n-gons for clipping the drag line
+cg::PolygonGrid g_clip_grid;
+
 // Draggable line
 std::shared_ptr<cg::DragLineNode> g_drag_line;
 float                             g_drag_line_width = 1.0f;
@@ -253,45 +256,20 @@ void handle_mouse_motion_event(const SDL_Event &event)
         g_current_line.b.set(world.x, world.y);
         g_drag_line->replace_point_1(g_current_line.b);
 
-        // Compute intersection points with n-gons
-        std::vector<cg::Point2> int_pts;
-
-        auto clip_result = g_current_line.clip_to_polygon(g_hexagon->get_vertex_list());
-        if(clip_result.clipped)
-        {
-            if(!equal(clip_result.clip_segment.a, g_current_line.a))
-            {
-                int_pts.push_back(clip_result.clip_segment.a);
-            }
-            if(!equal(clip_result.clip_segment.b, g_current_line.b))
-            {
-                int_pts.push_back(clip_result.clip_segment.b);
-            }
-        }
-
-        clip_result = g_current_line.clip_to_polygon(g_circle->get_vertex_list());
-        if(clip_result.clipped)
+        // Compute intersection points with n-gons (entry and exit points
+        // that are not the line endpoints)
+        std::vector<cg::Point2>             int_pts;
+        std::vector<cg::SegmentPolygonClip> clips;
+        g_clip_grid.clip_segments_to_polygons(&g_current_line, 1, clips);
+        for(const cg::SegmentPolygonClip &clip : clips)
         {
-            if(!equal(clip_result.clip_segment.a, g_current_line.a))
+            if(!equal(clip.clip_segment.a, g_current_line.a))
             {
-                int_pts.push_back(clip_result.clip_segment.a);
+                int_pts.push_back(clip.clip_segment.a);
             }
-            if(!equal(clip_result.clip_segment.b, g_current_line.b))
+            if(!equal(clip.clip_segment.b, g_current_line.b))
             {
-                int_pts.push_back(clip_result.clip_segment.b);
-            }
-        }
-
-        clip_result = g_current_line.clip_to_polygon(g_octagon->get_vertex_list());
-        if(clip_result.clipped)
-        {
-            if(!equal(clip_result.clip_segment.a, g_current_line.a))
-            {
-                int_pts.push_back(clip_result.clip_segment.a);
-            }
-            if(!equal(clip_result.clip_segment.b, g_current_line.b))
-            {
-                int_pts.push_back(clip_result.clip_segment.b);
+                int_pts.push_back(clip.clip_segment.b);
             }
         }
         g_intersection_points->update(int_pts);
@@ -375,6 +353,11 @@ void create_scene()
     g_hexagon = std::make_shared<cg::NGonNode>(
         cg::Point2(-2.0f, -2.0f), 6, 3.0f, ngon_shader->get_position_loc());
 
+    // Index the n-gons for clipping (same order as the original per-shape tests)
+    g_clip_grid.build({g_hexagon->get_vertex_list(),
+                       g_circle->get_vertex_list(),
+                       g_octagon->get_vertex_list()});
+
     // Circle is red and not blended - it is the "background" color and is
     // drawn first so the other 2 filled objects blend with its color
     auto circle_color =
@@ -533,8 +516,18 @@ int main(int argc, char **argv)
         sleep(DRAW_INTERVAL_MILLIS);
     }
 
+    // Release the scene while the context exists: the nodes delete their
+    // OpenGL objects through the state cache
+    g_intersection_points.reset();
+    g_drag_line.reset();
+    g_hexagon.reset();
+    g_circle.reset();
+    g_octagon.reset();
+    g_scene_root.reset();
+
     // Destroy OpenGL Context, SDL Window and SDL
     SDL_GL_DestroyContext(g_gl_context);
+    cg::gl_state().invalidate();
     SDL_DestroyWindow(g_sdl_window);
     SDL_Quit();
 
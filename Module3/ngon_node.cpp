@@ -1,6 +1,7 @@
 #include "Module3/ngon_node.hpp"
 
 #include "geometry/geometry.hpp"
+#include "scene/gl_state_cache.hpp"
 #include "scene/scene.hpp"
 
 #include <cmath>
@@ -26,8 +27,9 @@ NGonNode::NGonNode(const Point2 &center, int32_t num_sides, float radius, int32_
     vertex_list_.push_back({center.x + radius, center.y});
 
     // Add the points to a VBO.
+    GLStateCache &gl = gl_state();
     glGenBuffers(1, &vbo_);
-    glBindBuffer(GL_ARRAY_BUFFER, vbo_);
+    gl.bind_buffer(GL_ARRAY_BUFFER, vbo_);
     glBufferData(GL_ARRAY_BUFFER,
                  vertex_list_.size() * sizeof(Point2),
                  (GLvoid *)&vertex_list_[0],
@@ -36,8 +38,8 @@ NGonNode::NGonNode(const Point2 &center, int32_t num_sides, float radius, int32_
 
     // VAO
     glGenVertexArrays(1, &vao_);
-    glBindVertexArray(vao_);
-    glBindBuffer(GL_ARRAY_BUFFER, vbo_);
+    gl.bind_vertex_array(vao_);
+    gl.bind_buffer(GL_ARRAY_BUFFER, vbo_);
     glEnableVertexAttribArray(position_loc);
     glVertexAttribPointer(position_loc, 2, GL_FLOAT, GL_FALSE, 0, (void *)0);
 
@@ -51,14 +53,15 @@ NGonNode::~NGonNode()
 {
     glDeleteBuffers(1, &vbo_);
     glDeleteVertexArrays(1, &vao_);
+    gl_state().forget_buffer(vbo_);
+    gl_state().forget_vertex_array(vao_);
 }
 
 void NGonNode::draw(SceneState &scene_state)
 {
-    // Bind the VAO and draw the line
-    glBindVertexArray(vao_);
+    // Bind the VAO and draw the n-gon
+    gl_state().bind_vertex_array(vao_);
     glDrawArrays(GL_TRIANGLE_FAN, 0, num_verts_);
-    glBindVertexArray(0);
     check_error("End of n-gon:");
 }
 
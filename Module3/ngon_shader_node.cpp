@@ -1,5 +1,7 @@
 #include "Module3/ngon_shader_node.hpp"
 
+#include "scene/gl_state_cache.hpp"
+
 #include <iostream>
 
 namespace cg
@@ -31,7 +33,7 @@ bool NGonShaderNode::get_locations()
 void NGonShaderNode::draw(SceneState &scene_state)
 {
     // Enable this program
-    shader_program_.use();
+    gl_state().use_program(shader_program_.get_program());
 
     // Set scene state locations to ones needed for this program
     scene_state.ortho_matrix_loc = ortho_matrix_loc_;
@@ -39,7 +41,7 @@ void NGonShaderNode::draw(SceneState &scene_state)
     scene_state.position_loc = position_loc_;
 
     // Set the matrix (do this here for now)
-    glUniformMatrix4fv(ortho_matrix_loc_, 1, GL_FALSE, scene_state.ortho_matrix.get());
+    gl_state().uniform_matrix4fv(ortho_matrix_loc_, scene_state.ortho_matrix.get());
 
     // Draw all children
     SceneNode::draw(scene_state);
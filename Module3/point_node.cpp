@@ -1,5 +1,7 @@
 #include "Module3/point_node.hpp"
 
+#include "scene/gl_state_cache.hpp"
+
 namespace cg
 {
 
@@ -7,14 +9,15 @@ PointNode::PointNode(int32_t capacity, int32_t position_loc)
 {
     // Set up a buffer for dynamic draw with the specified capacity.
     std::vector<Point2> pts(capacity);
+    GLStateCache &gl = gl_state();
     glGenBuffers(1, &vbo_);
-    glBindBuffer(GL_ARRAY_BUFFER, vbo_);
+    gl.bind_buffer(GL_ARRAY_BUFFER, vbo_);
     glBufferData(GL_ARRAY_BUFFER, capacity * sizeof(Point2), (GLvoid *)&pts[0], GL_DYNAMIC_DRAW);
 
     // Allocate a VAO, enable it and set the vertex attribute arrays and pointers
     glGenVertexArrays(1, &vao_);
-    glBindVertexArray(vao_);
-    glBindBuffer(GL_ARRAY_BUFFER, vbo_);
+    gl.bind_vertex_array(vao_);
+    gl.bind_buffer(GL_ARRAY_BUFFER, vbo_);
     glVertexAttribPointer(position_loc, 2, GL_FLOAT, GL_FALSE, 0, (void *)0);
     glEnableVertexAttribArray(position_loc);
 
@@ -26,6 +29,8 @@ PointNode::~PointNode()
 {
     glDeleteBuffers(1, &vbo_);
     glDeleteVertexArrays(1, &vao_);
+    gl_state().forget_buffer(vbo_);
+    gl_state().forget_vertex_array(vao_);
 }
 
 void PointNode::update(const std::vector<Point2> &vtx_list)
@@ -33,7 +38,7 @@ void PointNode::update(const std::vector<Point2> &vtx_list)
     // Update the vertex buffer object.
     if(vtx_list.size() > 0)
     {
-        glBindBuffer(GL_ARRAY_BUFFER, vbo_);
+        gl_state().bind_buffer(GL_ARRAY_BUFFER, vbo_);
         glBufferSubData(
             GL_ARRAY_BUFFER, 0, vtx_list.size() * sizeof(Point2), (GLvoid *)&vtx_list[0]);
     }
@@ -46,10 +51,10 @@ void PointNode::draw(SceneState &scene_state)
 {
     if(vertex_count_ > 0)
     {
-        // Bind the VAO and draw the points
-        glBindVertexArray(vao_);
+        // Bind the VAO and draw the points. The VAO stays bound: all binds go
+        // through the state cache, so nothing changes it by accident.
+        gl_state().bind_vertex_array(vao_);
         glDrawArrays(GL_POINTS, 0, vertex_count_);
-        glBindVertexArray(0);
     }
 }
 
@@ -1,5 +1,7 @@
 #include "Module3/point_shader_node.hpp"
 
+#include "scene/gl_state_cache.hpp"
+
 #include <iostream>
 
 namespace cg
@@ -25,14 +27,14 @@ bool PointShaderNode::get_locations()
 void PointShaderNode::draw(SceneState &scene_state)
 {
     // Enable this program
-    shader_program_.use();
+    gl_state().use_program(shader_program_.get_program());
 
     // Set scene state locations to ones needed for this program
     scene_state.ortho_matrix_loc = ortho_matrix_loc_;
     scene_state.position_loc = position_loc_;
 
     // Set the matrix
-    glUniformMatrix4fv(ortho_matrix_loc_, 1, GL_FALSE, scene_state.ortho_matrix.get());
+    gl_state().uniform_matrix4fv(ortho_matrix_loc_, scene_state.ortho_matrix.get());
 
     // Draw all children
     SceneNode::draw(scene_state);
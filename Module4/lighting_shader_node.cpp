@@ -1,5 +1,7 @@
 #include "Module4/lighting_shader_node.hpp"
 
+#include "scene/gl_state_cache.hpp"
+
 #include <iostream>
 
 namespace cg
@@ -7,6 +9,7 @@ namespace cg
 
 bool LightingShaderNode::get_locations()
 {
+    instancing_ = {-1, -1, -1, -1, -1};
     position_loc_ = glGetAttribLocation(shader_program_.get_program(), "vtx_position");
     std::cout << "vtx_position location: " << position_loc_ << std::endl;
     
@@ -49,24 +52,48 @@ bool LightingShaderNode::get_locations()
         std::cout << "Error getting normal_matrix location\n";
         return false;
     }
+
+    GLuint program = shader_program_.get_program();
+    instancing_.instanced_loc = glGetUniformLocation(program, "instanced");
+    instancing_.pv_matrix_loc = glGetUniformLocation(program, "pv_matrix");
+    instancing_.model_matrix_loc = glGetAttribLocation(program, "instance_model_matrix");
+    instancing_.normal_matrix_loc = glGetAttribLocation(program, "instance_normal_matrix");
+    instancing_.color_loc = glGetAttribLocation(program, "instance_color");
     return true;
 }
 
 void LightingShaderNode::draw(SceneState &scene_state)
 {
     // Enable this program
-    shader_program_.use();
+    gl_state().use_program(shader_program_.get_program());
 
     // Set scene state locations to ones needed for this program
+    set_locations(scene_state);
+
+    // Draw all children
+    SceneNode::draw(scene_state);
+}
+
+void LightingShaderNode::compile(RenderCompiler &compiler)
+{
+    SceneState state = compiler.state;
+    uint32_t   program = compiler.program;
+    set_locations(compiler.state);
+    compiler.program =
+        compiler.list.add_program(compiler.state, shader_program_.get_program(), &instancing_);
+    compile_children(compiler);
+    compiler.program = program;
+    compiler.state = state;
+}
+
+void LightingShaderNode::set_locations(SceneState &scene_state) const
+{
     scene_state.position_loc = position_loc_;
     scene_state.normal_loc = vertex_normal_loc_;
     scene_state.material_diffuse_loc = material_color_loc_;
     scene_state.pvm_matrix_loc = pvm_matrix_loc_;
     scene_state.model_matrix_loc = model_matrix_loc_;
     scene_state.normal_matrix_loc = normal_matrix_loc_;
-
-    // Draw all children
-    SceneNode::draw(scene_state);
 }
 
 int32_t LightingShaderNode::get_position_loc() const { return position_loc_; }
@@ -12,6 +12,7 @@
 #ifndef __MODULE4_LIGHTING_SHADER_NODE_HPP__
 #define __MODULE4_LIGHTING_SHADER_NODE_HPP__
 
+#include "scene/render_list.hpp"
 #include "scene/shader_node.hpp"
 
 namespace cg
@@ -24,7 +25,8 @@ class LightingShaderNode : public ShaderNode
 {
   public:
     /**
-     * Gets uniform and attribute locations.
+     * Gets uniform and attribute locations. The instancing inputs are
+     * optional: without them the render list draws records one by one.
      */
     bool get_locations() override;
 
@@ -35,6 +37,13 @@ class LightingShaderNode : public ShaderNode
      */
     void draw(SceneState &scene_state) override;
 
+    /**
+     * Compile this shader node and its children. The program becomes the
+     * program of the draw records below it.
+     * @param  compiler  Render list being compiled.
+     */
+    void compile(RenderCompiler &compiler) override;
+
     /**
      * Get the location of the vertex position attribute.
      * @return  Returns the vertex position attribute location.
@@ -55,6 +64,12 @@ class LightingShaderNode : public ShaderNode
     GLint pvm_matrix_loc_;     // Composite projection, view, model matrix location
     GLint model_matrix_loc_;   // Modeling composite matrix location
     GLint normal_matrix_loc_;  // Normal transformation matrix location
+
+    // Instancing locations (-1 if the shader does not support instancing)
+    InstanceLocations instancing_;
+
+    // Sets the scene state locations to the ones of this program
+    void set_locations(SceneState &scene_state) const;
 };
 
 } // namespace cg
@@ -58,6 +58,62 @@ std::shared_ptr<cg::SceneNode> g_scene_root;
 
 cg::SceneState g_scene_state;
 
+// Scene graph flattened into draw records, recompiled when the graph changes
+cg::RenderList g_render_list;
+
+// Fixed scene transforms, computed at compile time. Each is the translate /
+// rotate / scale sequence described at its node in construct_scene().
+using cg::Matrix4x4;
+constexpr Matrix4x4 FLOOR_TRANSFORM = Matrix4x4::make_scale(100.0f, 100.0f, 1.0f);
+constexpr Matrix4x4 LEFT_WALL_TRANSFORM =
+    Matrix4x4::product(Matrix4x4::make_translation(-50.0f, 0.0f, 50.0f),
+                       Matrix4x4::make_rotation_y(90.0f),
+                       Matrix4x4::make_scale(100.0f, 100.0f, 1.0f));
+constexpr Matrix4x4 RIGHT_WALL_TRANSFORM =
+    Matrix4x4::product(Matrix4x4::make_translation(50.0f, 0.0f, 50.0f),
+                       Matrix4x4::make_rotation_y(-90.0f),
+                       Matrix4x4::make_scale(100.0f, 100.0f, 1.0f));
+constexpr Matrix4x4 BACK_WALL_TRANSFORM =
+    Matrix4x4::product(Matrix4x4::make_translation(0.0f, 50.0f, 50.0f),
+                       Matrix4x4::make_rotation_x(90.0f),
+                       Matrix4x4::make_scale(100.0f, 100.0f, 1.0f));
+constexpr Matrix4x4 CEILING_TRANSFORM =
+    Matrix4x4::product(Matrix4x4::make_translation(0.0f, 0.0f, 100.0f),
+                       Matrix4x4::make_rotation_x(180.0f),
+                       Matrix4x4::make_scale(100.0f, 100.0f, 1.0f));
+constexpr Matrix4x4 BOX_TRANSFORM = Matrix4x4::product(
+    Matrix4x4::make_translation(25.0f, 25.0f, 10.0f), Matrix4x4::make_rotation_z(45.0f));
+constexpr Matrix4x4 BOX_FACE1_TRANSFORM =
+    Matrix4x4::product(Matrix4x4::make_translation(0.0f, 10.0f, 0.0f),
+                       Matrix4x4::make_rotation_x(90.0f),
+                       Matrix4x4::make_scale(40.0f, 20.0f, 1.0f));
+constexpr Matrix4x4 BOX_FACE2_TRANSFORM =
+    Matrix4x4::product(Matrix4x4::make_translation(0.0f, -10.0f, 0.0f),
+                       Matrix4x4::make_rotation_x(90.0f),
+                       Matrix4x4::make_rotation_z(180.0f),
+                       Matrix4x4::make_scale(40.0f, 20.0f, 1.0f));
+constexpr Matrix4x4 BOX_FACE3_TRANSFORM =
+    Matrix4x4::product(Matrix4x4::make_translation(-20.0f, 0.0f, 0.0f),
+                       Matrix4x4::make_rotation_y(-90.0f),
+                       Matrix4x4::make_scale(20.0f, 20.0f, 1.0f));
+constexpr Matrix4x4 BOX_FACE4_TRANSFORM =
+    Matrix4x4::product(Matrix4x4::make_translation(20.0f, 0.0f, 0.0f),
+                       Matrix4x4::make_rotation_y(90.0f),
+                       Matrix4x4::make_scale(20.0f, 20.0f, 1.0f));
+constexpr Matrix4x4 BOX_FACE5_TRANSFORM = Matrix4x4::product(
+    Matrix4x4::make_translation(0.0f, 0.0f, 10.0f), Matrix4x4::make_scale(40.0f, 20.0f, 1.0f));
+constexpr Matrix4x4 BOX_FACE6_TRANSFORM = Matrix4x4::product(
+    Matrix4x4::make_translation(0.0f, 0.0f, -10.0f), Matrix4x4::make_scale(40.0f, 20.0f, 1.0f));
+
+// Fixed perspective projection: fov = 70, aspect = 1.0, near = 1.0, far = 200.
+constexpr Matrix4x4 PROJECTION = Matrix4x4::make_perspective(70.0f, 1.0f, 1.0f, 200.0f);
+
+// Fixed camera outside the center of the front wall (imagine it being a
+// window) looking parallel to the floor
+constexpr Matrix4x4 VIEW = Matrix4x4::make_look_at(cg::Point3(0.0f, -90.0f, 50.0f),
+                                                   cg::Point3(0.0f, 0.0f, 50.0f),
+                                                   cg::Vector3(0.0f, 0.0f, 1.0f));
+
 // Sleep function to help run a reasonable timer
 void sleep(int32_t milliseconds)
 {
@@ -74,7 +130,7 @@ void display()
   
   // Draw the scene if it exists
   if (g_scene_root)
-      g_scene_root->draw(g_scene_state);
+      g_render_list.execute(g_scene_root, g_scene_state);
   
   // Swap buffers to display the rendered frame
   SDL_GL_SwapWindow(g_sdl_window);
@@ -175,7 +231,7 @@ void construct_scene()
     // === FLOOR ===
     // Transform: scale to 100x100, keep at Z=0
     auto floor_transform = std::make_shared<cg::TransformNode>();
-    floor_transform->scale(100.0f, 100.0f, 1.0f);
+    floor_transform->set_matrix(FLOOR_TRANSFORM);
     
     auto floor_color = std::make_shared<cg::ColorNode>(cg::Color4(0.6f, 0.5f, 0.2f, 1.0f)); // brownish-green
     
@@ -186,9 +242,7 @@ void construct_scene()
     // === LEFT WALL ===
     // Transform: translate to x=-50, rotate 90° around Y, scale to 100x100
     auto left_wall_transform = std::make_shared<cg::TransformNode>();
-    left_wall_transform->translate(-50.0f, 0.0f, 50.0f);  // Position at left edge, center height
-    left_wall_transform->rotate_y(90.0f);                 // Rotate to face right
-    left_wall_transform->scale(100.0f, 100.0f, 1.0f);     // Scale to room size
+    left_wall_transform->set_matrix(LEFT_WALL_TRANSFORM);
     
     auto left_wall_color = std::make_shared<cg::ColorNode>(cg::Color4(1.0f, 1.0f, 1.0f, 1.0f)); // white
     
@@ -198,9 +252,7 @@ void construct_scene()
     // === RIGHT WALL ===
     // Transform: translate to x=+50, rotate -90° around Y, scale to 100x100
     auto right_wall_transform = std::make_shared<cg::TransformNode>();
-    right_wall_transform->translate(50.0f, 0.0f, 50.0f);   // Position at right edge, center height
-    right_wall_transform->rotate_y(-90.0f);                // Rotate to face left
-    right_wall_transform->scale(100.0f, 100.0f, 1.0f);     // Scale to room size
+    right_wall_transform->set_matrix(RIGHT_WALL_TRANSFORM);
     
     auto right_wall_color = std::make_shared<cg::ColorNode>(cg::Color4(1.0f, 1.0f, 1.0f, 1.0f)); // white
     
@@ -210,9 +262,7 @@ void construct_scene()
     // === BACK WALL ===
     // Transform: translate to y=+50, rotate 90° around X, scale to 100x100
     auto back_wall_transform = std::make_shared<cg::TransformNode>();
-    back_wall_transform->translate(0.0f, 50.0f, 50.0f);    // Position at back, center height
-    back_wall_transform->rotate_x(90.0f);                  // Rotate to face forward
-    back_wall_transform->scale(100.0f, 100.0f, 1.0f);      // Scale to room size
+    back_wall_transform->set_matrix(BACK_WALL_TRANSFORM);
     
     auto back_wall_color = std::make_shared<cg::ColorNode>(cg::Color4(0.9f, 0.7f, 0.5f, 1.0f)); // tan
     
@@ -222,9 +272,7 @@ void construct_scene()
     // === CEILING ===
     // Transform: translate to z=+100, flip to face downward, scale to 100x100
     auto ceiling_transform = std::make_shared<cg::TransformNode>();
-    ceiling_transform->translate(0.0f, 0.0f, 100.0f);      // Position at top
-    ceiling_transform->rotate_x(180.0f);                   // Flip to face downward
-    ceiling_transform->scale(100.0f, 100.0f, 1.0f);        // Scale to room size
+    ceiling_transform->set_matrix(CEILING_TRANSFORM);
     
     auto ceiling_color = std::make_shared<cg::ColorNode>(cg::Color4(0.1f, 0.4f, 1.0f, 1.0f)); // bluish
     
@@ -234,27 +282,21 @@ void construct_scene()
     // === PURPLE BOX ===
     // Main box transform: position at (25, 25, 10), rotate 45° around Z
     auto box_main_transform = std::make_shared<cg::TransformNode>();
-    box_main_transform->translate(25.0f, 25.0f, 10.0f);    // Position in back-right corner, 10 units up (half height)
-    box_main_transform->rotate_z(45.0f);                   // Rotate 45 degrees
+    box_main_transform->set_matrix(BOX_TRANSFORM);
     
     // Purple color for all box faces
     auto purple_color = std::make_shared<cg::ColorNode>(cg::Color4(0.5f, 0.0f, 0.5f, 1.0f)); // purple
     
     // Box Face 1: Front (positive Y direction)
     auto box_face1_transform = std::make_shared<cg::TransformNode>();
-    box_face1_transform->translate(0.0f, 10.0f, 0.0f);     // Move to front face
-    box_face1_transform->rotate_x(90.0f);                  // Rotate to vertical
-    box_face1_transform->scale(40.0f, 20.0f, 1.0f);        // Scale to box dimensions
+    box_face1_transform->set_matrix(BOX_FACE1_TRANSFORM);
     
     box_face1_transform->add_child(purple_color);
     purple_color->add_child(unit_square);
     
     // Box Face 2: Back (negative Y direction)
     auto box_face2_transform = std::make_shared<cg::TransformNode>();
-    box_face2_transform->translate(0.0f, -10.0f, 0.0f);    // Move to back face
-    box_face2_transform->rotate_x(90.0f);                  // Rotate to vertical - same as front face
-    box_face2_transform->rotate_z(180.0f);                 // Flip to face outward
-    box_face2_transform->scale(40.0f, 20.0f, 1.0f);        // Scale to box dimensions
+    box_face2_transform->set_matrix(BOX_FACE2_TRANSFORM);
     
     auto purple_color2 = std::make_shared<cg::ColorNode>(cg::Color4(0.5f, 0.0f, 0.5f, 1.0f));
     box_face2_transform->add_child(purple_color2);
@@ -262,9 +304,7 @@ void construct_scene()
     
     // Box Face 3: Left (negative X direction)
     auto box_face3_transform = std::make_shared<cg::TransformNode>();
-    box_face3_transform->translate(-20.0f, 0.0f, 0.0f);    // Move to left face
-    box_face3_transform->rotate_y(-90.0f);                 // Rotate to vertical
-    box_face3_transform->scale(20.0f, 20.0f, 1.0f);        // Scale to box dimensions
+    box_face3_transform->set_matrix(BOX_FACE3_TRANSFORM);
     
     auto purple_color3 = std::make_shared<cg::ColorNode>(cg::Color4(0.5f, 0.0f, 0.5f, 1.0f));
     box_face3_transform->add_child(purple_color3);
@@ -272,9 +312,7 @@ void construct_scene()
     
     // Box Face 4: Right (positive X direction)
     auto box_face4_transform = std::make_shared<cg::TransformNode>();
-    box_face4_transform->translate(20.0f, 0.0f, 0.0f);     // Move to right face
-    box_face4_transform->rotate_y(90.0f);                  // Rotate to vertical
-    box_face4_transform->scale(20.0f, 20.0f, 1.0f);        // Scale to box dimensions
+    box_face4_transform->set_matrix(BOX_FACE4_TRANSFORM);
     
     auto purple_color4 = std::make_shared<cg::ColorNode>(cg::Color4(0.5f, 0.0f, 0.5f, 1.0f));
     box_face4_transform->add_child(purple_color4);
@@ -282,8 +320,7 @@ void construct_scene()
     
     // Box Face 5: Top (positive Z direction)
     auto box_face5_transform = std::make_shared<cg::TransformNode>();
-    box_face5_transform->translate(0.0f, 0.0f, 10.0f);     // Move to top face
-    box_face5_transform->scale(40.0f, 20.0f, 1.0f);        // Scale to box dimensions
+    box_face5_transform->set_matrix(BOX_FACE5_TRANSFORM);
     
     auto purple_color5 = std::make_shared<cg::ColorNode>(cg::Color4(0.5f, 0.0f, 0.5f, 1.0f));
     box_face5_transform->add_child(purple_color5);
@@ -291,8 +328,7 @@ void construct_scene()
     
     // Box Face 6: Bottom (negative Z direction) - rests on floor
     auto box_face6_transform = std::make_shared<cg::TransformNode>();
-    box_face6_transform->translate(0.0f, 0.0f, -10.0f);    // Move to bottom face
-    box_face6_transform->scale(40.0f, 20.0f, 1.0f);        // Scale to box dimensions
+    box_face6_transform->set_matrix(BOX_FACE6_TRANSFORM);
     
     auto purple_color6 = std::make_shared<cg::ColorNode>(cg::Color4(0.5f, 0.0f, 0.5f, 1.0f));
     box_face6_transform->add_child(purple_color6);
@@ -368,9 +404,9 @@ bool initialize_graphics()
     }
 
     // Initialize OpenGL settings
-    glEnable(GL_DEPTH_TEST);
-    glEnable(GL_CULL_FACE);
-    glCullFace(GL_BACK);
+    cg::gl_state().set_enabled(GL_DEPTH_TEST, true);
+    cg::gl_state().set_enabled(GL_CULL_FACE, true);
+    cg::gl_state().cull_face(GL_BACK);
     glFrontFace(GL_CCW);  // Counter-clockwise winding is front-facing
     glEnable(GL_MULTISAMPLE);
     glClearColor(0.0f, 0.0f, 0.0f, 1.0f);  // Black background
@@ -383,10 +419,16 @@ bool initialize_graphics()
  */
 void cleanup_graphics()
 {
+    // Release the render list and the scene while the context exists: the
+    // nodes and the list delete their OpenGL objects through the state cache
+    g_render_list.clear();
+    g_scene_root.reset();
+
     if (g_gl_context) {
         SDL_GL_DestroyContext(g_gl_context);
         g_gl_context = nullptr;
     }
+    cg::gl_state().invalidate();
     
     if (g_sdl_window) {
         SDL_DestroyWindow(g_sdl_window);
@@ -417,35 +459,19 @@ int main(int argc, char **argv)
     std::cout << "OpenGL  " << glGetString(GL_VERSION) << ", GLSL "
               << glGetString(GL_SHADING_LANGUAGE_VERSION) << '\n';
 
-    // Set a fixed perspective projection. fov = 70, aspect = 1.0, near = 1.0 far = 200.
-    // We are hard-coding viewing and projection matrices since they do not change in
-    // this application.
-    cg::Matrix4x4 projection;
-    projection.m00() = 1.428f;
-    projection.m11() = 1.428f;
-    projection.m22() = -1.010f;
-    projection.m23() = -2.010f;
-    projection.m32() = -1.0f;
-    projection.m33() = 0.0f;
-
-    // Set a fixed camera outside the center of the front wall (imagine
-    // it being a window) looking parallel to the floor
-    cg::Matrix4x4 view;
-    view.m00() = 1.0f;
-    view.m11() = 0.0f;
-    view.m12() = 1.0f;
-    view.m13() = -50.0f;
-    view.m21() = -1.0f;
-    view.m22() = 0.0f;
-    view.m23() = -90.0f;
-    view.m33() = 1.0f;
-
-    // Set the composite projection and viewing matrix
-    // These remain fixed.
-    g_scene_state.pv = projection * view;
+    // Set the composite projection and viewing matrix. The projection and
+    // view are fixed in this application so they are built at compile time.
+    constexpr cg::Matrix4x4 PV = cg::Matrix4x4::product(PROJECTION, VIEW);
+    g_scene_state.set_pv(PV);
 
     construct_scene();
 
+    // The room is drawn with the depth test, so the records can be sorted to
+    // group state changes, and the walls sharing the unit square drawn
+    // instanced
+    g_render_list.set_sorted(true);
+    g_render_list.set_instanced(true);
+
     // Main loop
     while(handle_events())
     {
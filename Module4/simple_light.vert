@@ -4,6 +4,11 @@
 layout (location = 0) in vec3 vtx_position;
 // Vertex normal attribute
 layout (location = 1) in vec3 vtx_normal;
+// Per-instance model matrix, normal matrix and material color, used in
+// place of the uniforms when drawing instanced
+layout (location = 2) in mat4 instance_model_matrix;
+layout (location = 6) in mat4 instance_normal_matrix;
+layout (location = 10) in vec3 instance_color;
 // Color passed to the fragment shader
 layout (location = 0) smooth out vec4 color;
 
@@ -11,6 +16,8 @@ uniform vec3 material_color; // Material diffuse color
 uniform mat4 pvm_matrix;     // Composite projection, view, model matrix
 uniform mat4 model_matrix;   // Composite modeling matrix
 uniform mat4 normal_matrix;  // Normal transformation matrix
+uniform bool instanced;      // True to use the instance attributes
+uniform mat4 pv_matrix;      // Composite projection, view matrix (instanced)
 
 void main() 
 {
@@ -18,14 +25,19 @@ void main()
     // world coordinates and is hard-coded here for now!
     vec3 light_position = vec3(0.0, -100.0, 50.0f);
 
+    // Matrices and color of this instance
+    mat4 model = instanced ? instance_model_matrix : model_matrix;
+    mat4 normal_model = instanced ? instance_normal_matrix : normal_matrix;
+    vec3 diffuse = instanced ? instance_color : material_color;
+
     // Convert normal and position to world coords. Construct L - from vertex to light
-    vec3 N = normalize(vec3(normal_matrix * vec4(vtx_normal, 0.0)));
-    vec4 v = model_matrix * vec4(vtx_position, 1.0);
+    vec3 N = normalize(vec3(normal_model * vec4(vtx_normal, 0.0)));
+    vec4 v = model * vec4(vtx_position, 1.0);
     vec3 L = normalize(vec3(light_position - vec3(v)));
 
     // The diffuse shading equation. Intnesity depends on cos of L and N
-    color = vec4(material_color * max(dot(L, N), 0.0), 1.0);
+    color = vec4(diffuse * max(dot(L, N), 0.0), 1.0);
 
     // Convert position to clip coordinates and pass along
-    gl_Position = pvm_matrix * vec4(vtx_position, 1.0);
+    gl_Position = instanced ? pv_matrix * v : pvm_matrix * vec4(vtx_position, 1.0);
 }
@@ -1,4 +1,5 @@
 #include "Module4/unit_square_node.hpp"
+#include "scene/gl_state_cache.hpp"
 #include "scene/graphics.hpp"
 
 #include <GL/glext.h>
@@ -7,7 +8,7 @@
 namespace cg 
 {
 
-UnitSquareNode::UnitSquareNode() : vbo_(0), vao_(0)
+UnitSquareNode::UnitSquareNode() : vbo_(0), vao_(0), position_loc_(-2), normal_loc_(-2)
 {
   create_vertices();
   setup_geometry();
@@ -17,9 +18,15 @@ UnitSquareNode::~UnitSquareNode()
 {
   // Clean up OpenGL resources
   if (vbo_ != 0)
+  {
       glDeleteBuffers(1, &vbo_);
+      gl_state().forget_buffer(vbo_);
+  }
   if (vao_ != 0)
+  {
       glDeleteVertexArrays(1, &vao_);
+      gl_state().forget_vertex_array(vao_);
+  }
 }
 
 void UnitSquareNode::create_vertices()
@@ -55,21 +62,21 @@ void UnitSquareNode::create_vertices()
 void UnitSquareNode::setup_geometry()
 {
   //bind vao 
+  GLStateCache &gl = gl_state();
   glGenVertexArrays(1, &vao_);
-  glBindVertexArray(vao_);
+  gl.bind_vertex_array(vao_);
 
   //bind vbo 
   glGenBuffers(1, &vbo_);
-  glBindBuffer(GL_ARRAY_BUFFER, vbo_);
+  gl.bind_buffer(GL_ARRAY_BUFFER, vbo_);
 
   glBufferData(GL_ARRAY_BUFFER, 
                NUM_VERTICES * sizeof(VertexAndNormal), 
                vertices_, 
                GL_STATIC_DRAW);
 
-  //unbind vbo and vao 
-  glBindVertexArray(0);
-  glBindBuffer(GL_ARRAY_BUFFER, 0);
+  //unbind vao so later attribute changes are not made to it
+  gl.bind_vertex_array(0);
 }
 
 
@@ -80,10 +87,49 @@ void UnitSquareNode::draw(SceneState &scene_state)
     if (error != GL_NO_ERROR) {
         std::cout << "OpenGL error before draw: " << error << std::endl;
     }
-  //rebind VBO and VAO 
-  glBindVertexArray(vao_);
-  glBindBuffer(GL_ARRAY_BUFFER, vbo_);
+  //bind VAO and set up the attributes for the current shader. The VAO
+  //stays bound: all binds go through the state cache
+  setup_attributes(scene_state);
+  gl_state().bind_vertex_array(vao_);
+
+  //draw the triangle strip
+  glDrawArrays(GL_TRIANGLE_STRIP, 0, NUM_VERTICES);
+
+    error = glGetError();
+    if (error != GL_NO_ERROR) {
+        std::cout << "OpenGL error after draw: " << error << std::endl;
+    }
 
+  GeometryNode::draw(scene_state);
+}
+
+bool UnitSquareNode::get_draw_call(const SceneState &scene_state, DrawCall &call)
+{
+  setup_attributes(scene_state);
+  call = {vao_, GL_TRIANGLE_STRIP, 0, NUM_VERTICES};
+  return true;
+}
+
+void UnitSquareNode::setup_attributes(const SceneState &scene_state)
+{
+  // Attribute pointers are VAO state: only respecify them when the shader
+  // uses other locations than they were last set up for
+  if (scene_state.position_loc == position_loc_ && scene_state.normal_loc == normal_loc_)
+    return;
+
+  // The arrays enabled for the old locations would keep pointing at this
+  // layout, so disable them first
+  GLStateCache &gl = gl_state();
+  gl.bind_vertex_array(vao_);
+  if (position_loc_ >= 0)
+    glDisableVertexAttribArray(position_loc_);
+  if (normal_loc_ >= 0)
+    glDisableVertexAttribArray(normal_loc_);
+  position_loc_ = scene_state.position_loc;
+  normal_loc_ = scene_state.normal_loc;
+  gl.bind_buffer(GL_ARRAY_BUFFER, vbo_);
+
+  // Set up position attribute (vertex.x, vertex.y, vertex.z)
   if(scene_state.position_loc >= 0)
   {
     glVertexAttribPointer(scene_state.position_loc, 
@@ -104,25 +150,6 @@ void UnitSquareNode::draw(SceneState &scene_state)
                           (void*)offsetof(VertexAndNormal, normal));
     glEnableVertexAttribArray(scene_state.normal_loc);
   }
-  //draw the triangle strip
-  glDrawArrays(GL_TRIANGLE_STRIP, 0, NUM_VERTICES);
-
-  //cleanup 
-  if(scene_state.position_loc >= 0)
-    glDisableVertexAttribArray(scene_state.position_loc);
-  if(scene_state.normal_loc >= 0)
-    glDisableVertexAttribArray(scene_state.normal_loc);
-
-  //unbind buffer
-  glBindBuffer(GL_ARRAY_BUFFER, 0);
-  glBindVertexArray(0);
-
-    error = glGetError();
-    if (error != GL_NO_ERROR) {
-        std::cout << "OpenGL error after draw: " << error << std::endl;
-    }
-
-  GeometryNode::draw(scene_state);
 }
 
 
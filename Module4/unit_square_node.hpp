@@ -27,6 +27,15 @@ public:
    */
   void draw(SceneState &scene_state) override;
 
+  /**
+   * Gets the square as one triangle strip draw call. Sets up the vertex
+   * array attributes for the locations in the scene state.
+   * @param scene_state Scene state containing shader attribute locations.
+   * @param call Receives the draw call.
+   * @return Returns true.
+   */
+  bool get_draw_call(const SceneState &scene_state, DrawCall &call) override;
+
 private:
   /**
    * Sets up the vertex data and OpenGL buffers for the unit square.
@@ -38,9 +47,18 @@ private:
    */
   void create_vertices();
 
+  /**
+   * Points the vertex array attributes at the vertex buffer and enables them,
+   * unless they are already set up for the same locations.
+   * @param scene_state Scene state containing shader attribute locations.
+   */
+  void setup_attributes(const SceneState &scene_state);
+
   // OpenGL resources
   GLuint vbo_;                    // Vertex buffer object
   GLuint vao_;                    // Vertex array object
+  GLint position_loc_;            // Locations the attributes are set up for
+  GLint normal_loc_;              // (-2 = not set up yet)
   
   // Vertex data
   static constexpr int NUM_VERTICES = 4;
@@ -1,57 +1,95 @@
 #include "geometry/aabb.hpp"
 
 #include "geometry/geometry.hpp"
+#include "geometry/parallel.hpp"
+
+#include <cfloat>
+#include <mutex>
 
 namespace cg
 {
 
-// NOTE - this is not required until 605.767!
-
-AABB::AABB()
+namespace
 {
-    // Complete in 605.767
-}
 
-AABB::AABB(const Point3 &min, const Point3 &max)
-{
-    // Complete in 605.767
-}
+// Vertex lists shorter than this are reduced on the calling thread
+constexpr size_t PARALLEL_MIN_POINTS = 65536;
 
-AABB::AABB(const std::vector<Point3> &vertex_list)
+// Grows box by count points. The points are read as a flat float array 4
+// points (12 floats, 3 SSE registers) at a time: lane k of the running min
+// / max holds component k % 3, and the 12 lanes are folded into x, y, z at
+// the end.
+void min_max(const Point3 *points, size_t count, AABB &box)
 {
-    // Complete in 605.767
+    size_t n4 = 0;
+#if defined(CG_PACKET_SSE)
+    const float *f = reinterpret_cast<const float *>(points);
+    __m128       lo[3], hi[3];
+    for(int32_t k = 0; k < 3; k++)
+    {
+        lo[k] = _mm_set1_ps(FLT_MAX);
+        hi[k] = _mm_set1_ps(-FLT_MAX);
+    }
+    n4 = count & ~static_cast<size_t>(3);
+    for(size_t i = 0; i < 3 * n4; i += 12)
+    {
+        for(int32_t k = 0; k < 3; k++)
+        {
+            __m128 v = _mm_loadu_ps(f + i + 4 * k);
+            lo[k] = _mm_min_ps(lo[k], v);
+            hi[k] = _mm_max_ps(hi[k], v);
+        }
+    }
+    float l[12], h[12];
+    for(int32_t k = 0; k < 3; k++)
+    {
+        _mm_storeu_ps(l + 4 * k, lo[k]);
+        _mm_storeu_ps(h + 4 * k, hi[k]);
+    }
+    for(int32_t k = 0; k < 12; k += 3)
+    {
+        box.merge(AABB(Point3(l[k], l[k + 1], l[k + 2]), Point3(h[k], h[k + 1], h[k + 2])));
+    }
+#endif
+    for(size_t i = n4; i < count; i++) box.merge(points[i]);
 }
 
-void AABB::create(const std::vector<Point3> &vertex_list)
-{
-    // Complete in 605.767
-}
+} // namespace
 
-void AABB::update(const Point3 &min, const Point3 &max)
+AABB::AABB()
+    : min_corner{FLT_MAX, FLT_MAX, FLT_MAX}, max_corner{-FLT_MAX, -FLT_MAX, -FLT_MAX}
 {
-    // Complete in 605.767
 }
 
-void AABB::merge(const AABB &box)
-{
-    // Complete in 605.767
-}
+AABB::AABB(const Point3 &min, const Point3 &max) : min_corner(min), max_corner(max) {}
+
+AABB::AABB(const std::vector<Point3> &vertex_list) { create(vertex_list); }
 
-Point3 AABB::min_pt() const
+void AABB::create(const std::vector<Point3> &vertex_list)
 {
-    // Complete in 605.767
-    return Point3();
+    create(vertex_list.data(), vertex_list.size());
 }
 
-Point3 AABB::max_pt() const
+void AABB::create(const Point3 *vertices, size_t count, uint32_t thread_count)
 {
-    // Complete in 605.767
-    return Point3();
+    *this = AABB();
+    std::mutex lock;
+    parallel_for(count, thread_count, PARALLEL_MIN_POINTS, [&](size_t first, size_t last) {
+        AABB box;
+        min_max(vertices + first, last - first, box);
+        std::lock_guard<std::mutex> guard(lock);
+        merge(box);
+    });
 }
 
-void compute_center()
+void AABB::update(const Point3 &min, const Point3 &max)
 {
-    // Complete in 605.767
+    min_corner = min;
+    max_corner = max;
 }
 
+Point3 AABB::compute_center() const { return min_corner.mid_point(max_corner); }
+
+Vector3 AABB::compute_half_diagonal() const { return (max_corner - min_corner) * 0.5f; }
+
 } // namespace cg
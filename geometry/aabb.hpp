@@ -12,7 +12,11 @@
 #define __GEOMETRY_AABB_HPP__
 
 #include "geometry/point3.hpp"
+#include "geometry/vector3.hpp"
 
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
 #include <vector>
 
 namespace cg
@@ -23,8 +27,12 @@ namespace cg
  */
 struct AABB
 {
+    Point3 min_corner; // Minimum x,y,z
+    Point3 max_corner; // Maximum x,y,z
+
     /**
-     * Default constructor.
+     * Default constructor. Creates an empty box (min > max) so merging any
+     * point or box into it yields that point or box.
      */
     AABB();
 
@@ -47,6 +55,15 @@ struct AABB
      */
     void create(const std::vector<Point3> &vertex_list);
 
+    /**
+     * Creates an AABB given an array of vertices. Large arrays are split
+     * across threads and each range is reduced 4 points at a time.
+     * @param  vertices      Vertices.
+     * @param  count         Number of vertices.
+     * @param  thread_count  Number of threads (0 = one per core).
+     */
+    void create(const Point3 *vertices, size_t count, uint32_t thread_count = 0);
+
     /**
      * Updates the AABB given new minimum and maximum points.
      * @param  min  Minimum point (x,y,z)
@@ -60,6 +77,18 @@ struct AABB
      */
     void merge(const AABB &box);
 
+    /**
+     * Grows this box to include a point.
+     * @param  p  Point to include.
+     */
+    void merge(const Point3 &p);
+
+    /**
+     * Is the box empty (created from no points)?
+     * @return  Returns true if min > max.
+     */
+    bool is_empty() const;
+
     /**
      * Get the point at the minimum x,y,z.
      * @return  Returns the min. point.
@@ -73,11 +102,48 @@ struct AABB
     Point3 max_pt() const;
 
     /**
-     * Compute center and half diagonal
+     * Compute the center of the box.
+     * @return  Returns the center point.
+     */
+    Point3 compute_center() const;
+
+    /**
+     * Compute the half diagonal (center to max corner).
+     * @return  Returns the half diagonal vector.
      */
-    void compute_center();
+    Vector3 compute_half_diagonal() const;
 };
 
+static_assert(sizeof(AABB) == 6 * sizeof(float), "AABB must be tightly packed");
+
+// Inline definitions
+
+inline void AABB::merge(const AABB &box)
+{
+    min_corner.set(std::min(min_corner.x, box.min_corner.x),
+                   std::min(min_corner.y, box.min_corner.y),
+                   std::min(min_corner.z, box.min_corner.z));
+    max_corner.set(std::max(max_corner.x, box.max_corner.x),
+                   std::max(max_corner.y, box.max_corner.y),
+                   std::max(max_corner.z, box.max_corner.z));
+}
+
+inline void AABB::merge(const Point3 &p)
+{
+    min_corner.set(std::min(min_corner.x, p.x),
+                   std::min(min_corner.y, p.y),
+                   std::min(min_corner.z, p.z));
+    max_corner.set(std::max(max_corner.x, p.x),
+                   std::max(max_corner.y, p.y),
+                   std::max(max_corner.z, p.z));
+}
+
+inline bool AABB::is_empty() const { return min_corner.x > max_corner.x; }
+
+inline Point3 AABB::min_pt() const { return min_corner; }
+
+inline Point3 AABB::max_pt() const { return max_corner; }
+
 } // namespace cg
 
 #endif
@@ -1,24 +1,341 @@
 #include "geometry/bounding_sphere.hpp"
 
 #include "geometry/geometry.hpp"
+#include "geometry/parallel.hpp"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <mutex>
+#include <random>
 
 namespace cg
 {
 
-BoundingSphere::BoundingSphere() : center{0.0f, 0.0f, 0.0f}, radius(1.0f) {}
+namespace
+{
+
+// Vertex lists shorter than this are searched on the calling thread
+constexpr size_t PARALLEL_MIN_POINTS = 65536;
+
+// Relative slack on the squared radius for Welzl containment tests, so
+// points that round onto the boundary do not trigger another recursion
+constexpr double WELZL_SLACK = 1.0e-10;
+
+/**
+ * Smallest float radius r with r * r >= d2, so contains() agrees exactly
+ * with the distance that set the radius.
+ */
+float fit_radius(float d2)
+{
+    float r = std::sqrt(d2);
+    if(r * r < d2) r = std::nextafter(r, FLT_MAX);
+    return r;
+}
+
+// Index of the min and max point along each axis. Ties keep the lowest
+// index so the result does not depend on the thread count.
+struct Extremes
+{
+    size_t lo[3];
+    size_t hi[3];
+};
+
+float axis(const Point3 &p, int32_t k) { return (k == 0) ? p.x : ((k == 1) ? p.y : p.z); }
+
+void find_extremes(const Point3 *points, size_t first, size_t last, Extremes &e)
+{
+    // Track the values in registers rather than reloading points[index]
+    float lo[3] = {points[first].x, points[first].y, points[first].z};
+    float hi[3] = {lo[0], lo[1], lo[2]};
+    for(int32_t k = 0; k < 3; k++) e.lo[k] = e.hi[k] = first;
+    for(size_t i = first + 1; i < last; i++)
+    {
+        const float v[3] = {points[i].x, points[i].y, points[i].z};
+        for(int32_t k = 0; k < 3; k++)
+        {
+            if(v[k] < lo[k])
+            {
+                lo[k] = v[k];
+                e.lo[k] = i;
+            }
+            if(v[k] > hi[k])
+            {
+                hi[k] = v[k];
+                e.hi[k] = i;
+            }
+        }
+    }
+}
+
+void merge_extremes(const Point3 *points, const Extremes &src, Extremes &dst)
+{
+    for(int32_t k = 0; k < 3; k++)
+    {
+        float a = axis(points[src.lo[k]], k), b = axis(points[dst.lo[k]], k);
+        if(a < b || (a == b && src.lo[k] < dst.lo[k])) dst.lo[k] = src.lo[k];
+        a = axis(points[src.hi[k]], k), b = axis(points[dst.hi[k]], k);
+        if(a > b || (a == b && src.hi[k] < dst.hi[k])) dst.hi[k] = src.hi[k];
+    }
+}
+
+// Double precision point and ball for Welzl's algorithm. r2 < 0 is the
+// empty ball.
+struct DPoint
+{
+    double x, y, z;
+};
+
+struct DBall
+{
+    DPoint c;
+    double r2;
+};
+
+DPoint sub(const DPoint &a, const DPoint &b) { return {a.x - b.x, a.y - b.y, a.z - b.z}; }
+double dot(const DPoint &a, const DPoint &b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
+DPoint cross(const DPoint &a, const DPoint &b)
+{
+    return {a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x};
+}
+
+bool ball_contains(const DBall &b, const DPoint &p)
+{
+    DPoint d = sub(p, b.c);
+    return dot(d, d) <= b.r2 * (1.0 + WELZL_SLACK);
+}
+
+DBall ball_2(const DPoint &a, const DPoint &b)
+{
+    DBall  r{{0.5 * (a.x + b.x), 0.5 * (a.y + b.y), 0.5 * (a.z + b.z)}, 0.0};
+    DPoint d = sub(a, r.c);
+    r.r2 = dot(d, d);
+    return r;
+}
+
+// Circumscribed ball of a triangle (center in the triangle plane). Falls
+// back to the ball on the farthest pair if the points are collinear.
+DBall ball_3(const DPoint &a, const DPoint &b, const DPoint &c)
+{
+    DPoint u = sub(a, c), v = sub(b, c);
+    DPoint n = cross(u, v);
+    double n2 = dot(n, n);
+    if(n2 <= DBL_EPSILON * dot(u, u) * dot(v, v))
+    {
+        DBall ab = ball_2(a, b), ac = ball_2(a, c), bc = ball_2(b, c);
+        return (ab.r2 >= ac.r2 && ab.r2 >= bc.r2) ? ab : ((ac.r2 >= bc.r2) ? ac : bc);
+    }
+    double u2 = dot(u, u), v2 = dot(v, v);
+    DPoint w = {v.x * u2 - u.x * v2, v.y * u2 - u.y * v2, v.z * u2 - u.z * v2};
+    DPoint o = cross(w, n);
+    double s = 0.5 / n2;
+    DBall  r{{c.x + o.x * s, c.y + o.y * s, c.z + o.z * s}, 0.0};
+    DPoint d = sub(a, r.c);
+    r.r2 = dot(d, d);
+    return r;
+}
+
+// Circumscribed ball of a tetrahedron. If the points are coplanar, uses
+// the smallest triangle ball that holds the fourth point.
+DBall ball_4(const DPoint &a, const DPoint &b, const DPoint &c, const DPoint &d)
+{
+    DPoint u = sub(b, a), v = sub(c, a), w = sub(d, a);
+    DPoint vw = cross(v, w);
+    double det = dot(u, vw);
+    double scale = std::sqrt(dot(u, u) * dot(v, v) * dot(w, w));
+    if(std::abs(det) <= DBL_EPSILON * 64.0 * scale)
+    {
+        const DPoint *p[4] = {&a, &b, &c, &d};
+        DBall         best{{0.0, 0.0, 0.0}, DBL_MAX};
+        for(int32_t skip = 0; skip < 4; skip++)
+        {
+            const DPoint *t[3];
+            int32_t       n = 0;
+            for(int32_t i = 0; i < 4; i++)
+            {
+                if(i != skip) t[n++] = p[i];
+            }
+            DBall r = ball_3(*t[0], *t[1], *t[2]);
+            if(r.r2 < best.r2 && ball_contains(r, *p[skip])) best = r;
+        }
+        return best;
+    }
+    // Solve 2 [u v w]^T o = [|u|^2 |v|^2 |w|^2] for the offset o from a
+    double u2 = dot(u, u), v2 = dot(v, v), w2 = dot(w, w);
+    DPoint wu = cross(w, u), uv = cross(u, v);
+    double s = 0.5 / det;
+    DPoint o = {(vw.x * u2 + wu.x * v2 + uv.x * w2) * s,
+                (vw.y * u2 + wu.y * v2 + uv.y * w2) * s,
+                (vw.z * u2 + wu.z * v2 + uv.z * w2) * s};
+    return {{a.x + o.x, a.y + o.y, a.z + o.z}, dot(o, o)};
+}
+
+DBall boundary_ball(const DPoint *r, int32_t nr)
+{
+    switch(nr)
+    {
+    case 1: return {r[0], 0.0};
+    case 2: return ball_2(r[0], r[1]);
+    case 3: return ball_3(r[0], r[1], r[2]);
+    case 4: return ball_4(r[0], r[1], r[2], r[3]);
+    default: return {{0.0, 0.0, 0.0}, -1.0};
+    }
+}
+
+/**
+ * Welzl's algorithm with the move-to-front heuristic: smallest ball
+ * containing points [0, end) with the nr points in r on its boundary.
+ * Points that forced a recursion are moved to the front so later calls
+ * test them first. Recursion depth is at most 4.
+ */
+DBall welzl(std::vector<DPoint> &points, size_t end, DPoint *r, int32_t nr)
+{
+    DBall ball = boundary_ball(r, nr);
+    if(nr == 4) return ball;
+    for(size_t i = 0; i < end; i++)
+    {
+        if(!ball_contains(ball, points[i]))
+        {
+            r[nr] = points[i];
+            ball = welzl(points, i, r, nr + 1);
+            std::rotate(points.begin(), points.begin() + i, points.begin() + i + 1);
+        }
+    }
+    return ball;
+}
 
-BoundingSphere::BoundingSphere(const BoundingSphere &s) : center(s.center), radius(s.radius) {}
+} // namespace
+
+BoundingSphere::BoundingSphere() : center{0.0f, 0.0f, 0.0f}, radius(1.0f) {}
 
 BoundingSphere::BoundingSphere(const Point3 &c, float r) : center(c), radius(r) {}
 
 BoundingSphere::BoundingSphere(std::vector<Point3> &vertex_list)
 {
-    // Complete in 605.767
+    create(vertex_list.data(), vertex_list.size());
+}
+
+void BoundingSphere::create(const Point3 *vertices, size_t count, uint32_t thread_count)
+{
+    center = Point3();
+    radius = 0.0f;
+    if(count == 0) return;
+
+    // Parallel search for the min / max point along each axis
+    Extremes   extremes;
+    bool       found = false;
+    std::mutex lock;
+    parallel_for(count, thread_count, PARALLEL_MIN_POINTS, [&](size_t first, size_t last) {
+        if(first >= last) return;
+        Extremes e;
+        find_extremes(vertices, first, last, e);
+        std::lock_guard<std::mutex> guard(lock);
+        if(found)
+        {
+            merge_extremes(vertices, e, extremes);
+        }
+        else
+        {
+            extremes = e;
+            found = true;
+        }
+    });
+
+    // Initial sphere on the extreme pair that is farthest apart
+    int32_t best = 0;
+    float   best_d2 = -1.0f;
+    for(int32_t k = 0; k < 3; k++)
+    {
+        float d2 = (vertices[extremes.hi[k]] - vertices[extremes.lo[k]]).norm_squared();
+        if(d2 > best_d2)
+        {
+            best_d2 = d2;
+            best = k;
+        }
+    }
+    const Point3 &a = vertices[extremes.lo[best]];
+    const Point3 &b = vertices[extremes.hi[best]];
+    center = a.mid_point(b);
+    radius = fit_radius(std::max((a - center).norm_squared(), (b - center).norm_squared()));
+
+    // Second pass grows the sphere over every point
+    grow(vertices, count);
+}
+
+void BoundingSphere::create_tight(const Point3 *vertices, size_t count)
+{
+    center = Point3();
+    radius = 0.0f;
+    if(count == 0) return;
+
+    // Welzl's expected linear time relies on a random point order. A fixed
+    // seed keeps the result repeatable.
+    std::vector<DPoint> points(count);
+    for(size_t i = 0; i < count; i++)
+    {
+        points[i] = {vertices[i].x, vertices[i].y, vertices[i].z};
+    }
+    std::mt19937 rng(count);
+    std::shuffle(points.begin(), points.end(), rng);
+
+    DPoint boundary[4];
+    DBall  ball = welzl(points, count, boundary, 0);
+    center.set(static_cast<float>(ball.c.x), static_cast<float>(ball.c.y),
+               static_cast<float>(ball.c.z));
+
+    // Radius from the float center so every vertex passes contains()
+    float d2 = 0.0f;
+    for(size_t i = 0; i < count; i++)
+    {
+        d2 = std::max(d2, (vertices[i] - center).norm_squared());
+    }
+    radius = fit_radius(d2);
+}
+
+void BoundingSphere::grow(const Point3 *vertices, size_t count)
+{
+    float r2 = radius * radius;
+    for(size_t i = 0; i < count; i++)
+    {
+        Vector3 v = vertices[i] - center;
+        float   d2 = v.norm_squared();
+        if(d2 > r2)
+        {
+            // Move the center toward the point so the far side stays put
+            float d = std::sqrt(d2);
+            float new_radius = 0.5f * (radius + d);
+            center = center + v * ((new_radius - radius) / d);
+            radius = std::max(new_radius, fit_radius((vertices[i] - center).norm_squared()));
+            r2 = radius * radius;
+        }
+    }
+}
+
+bool BoundingSphere::contains(const Point3 &p) const
+{
+    return (p - center).norm_squared() <= radius * radius;
 }
 
 BoundingSphere &BoundingSphere::merge_with(const BoundingSphere &s2)
 {
-    // Complete in 605.767
+    Vector3 v = s2.center - center;
+    float   d = v.norm();
+
+    // One sphere already holds the other
+    if(d + s2.radius <= radius) return *this;
+    if(d + radius <= s2.radius)
+    {
+        *this = s2;
+        return *this;
+    }
+
+    // Both spheres touch the new one from inside on the line through their
+    // centers. Re-measure from the rounded center so both stay inside.
+    Point3 c1 = center;
+    float  new_radius = 0.5f * (d + radius + s2.radius);
+    center = c1 + v * ((new_radius - radius) / d);
+    radius = std::max({new_radius, (c1 - center).norm() + radius,
+                       (s2.center - center).norm() + s2.radius});
     return *this;
 }
 
@@ -14,6 +14,8 @@
 
 #include "geometry/point3.hpp"
 
+#include <cstddef>
+#include <cstdint>
 #include <vector>
 
 namespace cg
@@ -36,7 +38,14 @@ struct BoundingSphere
      * Copy constructor
      * @param   s   Sphere to copy.
      */
-    BoundingSphere(const BoundingSphere &s);
+    BoundingSphere(const BoundingSphere &s) = default;
+
+    /**
+     * Assignment operator
+     * @param   s   Sphere to assign to this sphere.
+     * @return   Returns the address of this sphere.
+     */
+    BoundingSphere &operator=(const BoundingSphere &s) = default;
 
     /**
      * Constructor given a center point and radius.
@@ -51,6 +60,45 @@ struct BoundingSphere
      */
     BoundingSphere(std::vector<Point3> &vertex_list);
 
+    /**
+     * Fits a sphere to a vertex list with Ritter's method: the farthest
+     * apart pair of axis extreme points gives the initial sphere, which a
+     * second pass grows to cover every point. The extreme point search is
+     * split across threads for large lists. Fast but typically 5-20%
+     * larger than the minimum sphere.
+     * @param  vertices      Vertex array.
+     * @param  count         Number of vertices.
+     * @param  thread_count  Number of threads (0 = one per core).
+     */
+    void create(const Point3 *vertices, size_t count, uint32_t thread_count = 0);
+
+    /**
+     * Fits the minimum bounding sphere to a vertex list with Welzl's
+     * randomized algorithm (move-to-front variant). Expected linear time
+     * but several times slower than create(). Use when a tight sphere is
+     * worth the build time, e.g. at asset import.
+     * @param  vertices  Vertex array.
+     * @param  count     Number of vertices.
+     */
+    void create_tight(const Point3 *vertices, size_t count);
+
+    /**
+     * Grows the sphere (as little as possible, keeping the far side fixed)
+     * to contain a span of points. Lets a sphere be built over vertex data
+     * that arrives in pieces: start from a sphere of radius 0 at the first
+     * point and grow it with each span.
+     * @param  vertices  Vertex array.
+     * @param  count     Number of vertices.
+     */
+    void grow(const Point3 *vertices, size_t count);
+
+    /**
+     * Does the sphere contain a point?
+     * @param  p  Point to test.
+     * @return  Returns true if p is inside or on the sphere.
+     */
+    bool contains(const Point3 &p) const;
+
     /**
      * Merge this bounding sphere with another to create the smallest sphere
      * containing the 2.
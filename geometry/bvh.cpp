@@ -0,0 +1,498 @@
+#include "geometry/bvh.hpp"
+
+#include "geometry/geometry.hpp"
+#include "geometry/parallel.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <thread>
+
+namespace cg
+{
+
+namespace
+{
+
+// Number of SAH bins per axis
+constexpr uint32_t BIN_COUNT = 16;
+
+// Subtrees smaller than this are not worth a thread
+constexpr uint32_t PARALLEL_MIN_TRIANGLES = 16384;
+
+// Below this depth splits fall back to the median so the tree depth (and
+// the traversal stack) stays bounded for badly distributed meshes
+constexpr uint32_t MEDIAN_SPLIT_DEPTH = 32;
+constexpr int32_t  STACK_SIZE = 128;
+
+// Widens the far slab distance by about 2 gamma(3) so float round off never
+// culls a box containing a hit (Ize, "Robust BVH Ray Traversal")
+constexpr float ROBUST_SCALE = 1.0f + 3.0f * std::numeric_limits<float>::epsilon();
+
+/**
+ * Triangle bounds and centroid used while building.
+ */
+struct BuildTriangle
+{
+    AABB   bounds;
+    Point3 centroid;
+};
+
+/**
+ * One SAH bin.
+ */
+struct Bin
+{
+    AABB     bounds;
+    uint32_t count = 0;
+};
+
+float component(const Point3 &p, int32_t axis)
+{
+    return (axis == 0) ? p.x : (axis == 1) ? p.y : p.z;
+}
+
+// Half the surface area of a box (the SAH only compares ratios). 0 if empty.
+float half_area(const AABB &box)
+{
+    float dx = box.max_corner.x - box.min_corner.x;
+    float dy = box.max_corner.y - box.min_corner.y;
+    float dz = box.max_corner.z - box.min_corner.z;
+    return (dx < 0.0f) ? 0.0f : dx * dy + dy * dz + dz * dx;
+}
+
+/**
+ * Recursive binned SAH build over a range of the triangle order array.
+ * Subtrees are built on separate threads down to a given depth; each
+ * thread writes its own node array, which is spliced in afterwards.
+ */
+struct Builder
+{
+    const std::vector<BuildTriangle> &tris;
+    std::vector<uint32_t>            &order;
+    uint32_t                          max_leaf_size;
+
+    // Appends the subtree for order[first, first + count) to nodes
+    void build(uint32_t              first,
+               uint32_t              count,
+               uint32_t              depth,
+               uint32_t              parallel_depth,
+               std::vector<BVHNode> &nodes) const
+    {
+        uint32_t index = static_cast<uint32_t>(nodes.size());
+        nodes.push_back({});
+
+        AABB bounds, centroid_bounds;
+        for(uint32_t i = first; i < first + count; i++)
+        {
+            bounds.merge(tris[order[i]].bounds);
+            centroid_bounds.merge(tris[order[i]].centroid);
+        }
+        nodes[index].bounds = bounds;
+
+        if(count <= max_leaf_size)
+        {
+            nodes[index].offset = first;
+            nodes[index].count = count;
+            return;
+        }
+
+        uint32_t left_count = (depth < MEDIAN_SPLIT_DEPTH)
+                                  ? sah_split(first, count, centroid_bounds)
+                                  : median_split(first, count, centroid_bounds);
+        uint32_t right_first = first + left_count;
+        uint32_t right_count = count - left_count;
+        nodes[index].count = 0;
+
+        if(depth < parallel_depth && count >= PARALLEL_MIN_TRIANGLES)
+        {
+            std::vector<BVHNode> right_nodes;
+            std::thread          worker([&]() {
+                build(right_first, right_count, depth + 1, parallel_depth, right_nodes);
+            });
+            build(first, left_count, depth + 1, parallel_depth, nodes);
+            worker.join();
+
+            // Right child indices in the spliced subtree are relative to its start
+            uint32_t base = static_cast<uint32_t>(nodes.size());
+            for(BVHNode &n : right_nodes)
+            {
+                if(!n.is_leaf()) n.offset += base;
+            }
+            nodes.insert(nodes.end(), right_nodes.begin(), right_nodes.end());
+            nodes[index].offset = base;
+        }
+        else
+        {
+            build(first, left_count, depth + 1, parallel_depth, nodes);
+            nodes[index].offset = static_cast<uint32_t>(nodes.size());
+            build(right_first, right_count, depth + 1, parallel_depth, nodes);
+        }
+    }
+
+    // Partitions the range with the lowest cost binned SAH split. Returns
+    // the number of triangles on the left.
+    uint32_t sah_split(uint32_t first, uint32_t count, const AABB &centroid_bounds) const
+    {
+        float   best_cost = INFINITY;
+        int32_t best_axis = -1;
+        int32_t best_bin = 0;
+        for(int32_t axis = 0; axis < 3; axis++)
+        {
+            float lo = component(centroid_bounds.min_corner, axis);
+            float extent = component(centroid_bounds.max_corner, axis) - lo;
+            if(extent <= 0.0f) continue;
+            float scale = static_cast<float>(BIN_COUNT) / extent;
+
+            Bin bins[BIN_COUNT];
+            for(uint32_t i = first; i < first + count; i++)
+            {
+                const BuildTriangle &t = tris[order[i]];
+                Bin &b = bins[bin_index(component(t.centroid, axis), lo, scale)];
+                b.count++;
+                b.bounds.merge(t.bounds);
+            }
+
+            // Sweep from the left, then from the right evaluating each plane
+            float    left_area[BIN_COUNT - 1];
+            uint32_t left_n[BIN_COUNT - 1];
+            AABB     box;
+            uint32_t n = 0;
+            for(uint32_t i = 0; i < BIN_COUNT - 1; i++)
+            {
+                box.merge(bins[i].bounds);
+                n += bins[i].count;
+                left_area[i] = half_area(box);
+                left_n[i] = n;
+            }
+            box = AABB();
+            n = 0;
+            for(uint32_t i = BIN_COUNT - 1; i > 0; i--)
+            {
+                box.merge(bins[i].bounds);
+                n += bins[i].count;
+                if(n == 0 || left_n[i - 1] == 0) continue;
+                float cost = left_area[i - 1] * static_cast<float>(left_n[i - 1]) +
+                             half_area(box) * static_cast<float>(n);
+                if(cost < best_cost)
+                {
+                    best_cost = cost;
+                    best_axis = axis;
+                    best_bin = static_cast<int32_t>(i);
+                }
+            }
+        }
+
+        // All centroids coincide: any split is as good as another
+        if(best_axis < 0) return count / 2;
+
+        float lo = component(centroid_bounds.min_corner, best_axis);
+        float scale = static_cast<float>(BIN_COUNT) /
+                      (component(centroid_bounds.max_corner, best_axis) - lo);
+        auto mid = std::partition(
+            order.begin() + first, order.begin() + first + count, [&](uint32_t t) {
+                return bin_index(component(tris[t].centroid, best_axis), lo, scale) <
+                       static_cast<uint32_t>(best_bin);
+            });
+        return static_cast<uint32_t>(mid - (order.begin() + first));
+    }
+
+    // Splits the range in half along the longest centroid axis
+    uint32_t median_split(uint32_t first, uint32_t count, const AABB &centroid_bounds) const
+    {
+        Vector3 extent = centroid_bounds.max_corner - centroid_bounds.min_corner;
+        int32_t axis = (extent.x > extent.y && extent.x > extent.z) ? 0
+                       : (extent.y > extent.z)                      ? 1
+                                                                    : 2;
+        std::nth_element(order.begin() + first,
+                         order.begin() + first + count / 2,
+                         order.begin() + first + count,
+                         [&](uint32_t a, uint32_t b) {
+                             return component(tris[a].centroid, axis) <
+                                    component(tris[b].centroid, axis);
+                         });
+        return count / 2;
+    }
+
+    static uint32_t bin_index(float c, float lo, float scale)
+    {
+        return std::min(static_cast<uint32_t>((c - lo) * scale), BIN_COUNT - 1);
+    }
+};
+
+/**
+ * Ray with precomputed reciprocal direction for slab tests. Zero direction
+ * components are replaced by a tiny value so 0 * inf never produces NaN.
+ */
+struct SlabRay
+{
+    Point3 o;
+    float  inv[3];
+
+    SlabRay(const Ray3 &ray) : o(ray.o)
+    {
+        const float d[3] = {ray.d.x, ray.d.y, ray.d.z};
+        for(int32_t i = 0; i < 3; i++)
+        {
+            float di = (std::abs(d[i]) > 1.0e-20f) ? d[i] : std::copysign(1.0e-20f, d[i]);
+            inv[i] = 1.0f / di;
+        }
+    }
+
+    // Returns true if the ray enters the box before t_max. t_entry is set
+    // to the entry distance (0 if the origin is inside).
+    bool hit(const AABB &b, float t_max, float &t_entry) const
+    {
+        float x0 = (b.min_corner.x - o.x) * inv[0], x1 = (b.max_corner.x - o.x) * inv[0];
+        float y0 = (b.min_corner.y - o.y) * inv[1], y1 = (b.max_corner.y - o.y) * inv[1];
+        float z0 = (b.min_corner.z - o.z) * inv[2], z1 = (b.max_corner.z - o.z) * inv[2];
+        float t_near = std::max(std::max(std::min(x0, x1), std::min(y0, y1)),
+                                std::max(std::min(z0, z1), 0.0f));
+        float t_far = std::min(std::min(std::max(x0, x1), std::max(y0, y1)), std::max(z0, z1));
+        t_entry = t_near;
+        return t_near <= t_far * ROBUST_SCALE && t_near <= t_max;
+    }
+};
+
+/**
+ * Traversal stack entry: node and the distance at which the ray enters it.
+ */
+struct StackEntry
+{
+    uint32_t node;
+    float    t_entry;
+};
+
+} // namespace
+
+BVH::BVH() {}
+
+BVH::BVH(const std::vector<Point3>   &vertex_list,
+         const std::vector<uint16_t> &face_list,
+         uint32_t                     max_leaf_size,
+         uint32_t                     thread_count)
+{
+    build(vertex_list, face_list, max_leaf_size, thread_count);
+}
+
+BVH::BVH(const std::vector<Point3>   &vertex_list,
+         const std::vector<uint32_t> &face_list,
+         uint32_t                     max_leaf_size,
+         uint32_t                     thread_count)
+{
+    build(vertex_list, face_list, max_leaf_size, thread_count);
+}
+
+BVH::BVH(const std::vector<Point3> &vertex_list,
+         const IndexBuffer         &face_list,
+         uint32_t                   max_leaf_size,
+         uint32_t                   thread_count)
+{
+    build(vertex_list, face_list, max_leaf_size, thread_count);
+}
+
+void BVH::build(const std::vector<Point3>   &vertex_list,
+                const std::vector<uint16_t> &face_list,
+                uint32_t                     max_leaf_size,
+                uint32_t                     thread_count)
+{
+    build_mesh(vertex_list, face_list, max_leaf_size, thread_count);
+}
+
+void BVH::build(const std::vector<Point3>   &vertex_list,
+                const std::vector<uint32_t> &face_list,
+                uint32_t                     max_leaf_size,
+                uint32_t                     thread_count)
+{
+    build_mesh(vertex_list, face_list, max_leaf_size, thread_count);
+}
+
+void BVH::build(const std::vector<Point3> &vertex_list,
+                const IndexBuffer         &face_list,
+                uint32_t                   max_leaf_size,
+                uint32_t                   thread_count)
+{
+    if(face_list.is_16_bit())
+        build_mesh(vertex_list, face_list.indices16(), max_leaf_size, thread_count);
+    else build_mesh(vertex_list, face_list.indices32(), max_leaf_size, thread_count);
+}
+
+template <typename Index>
+void BVH::build_mesh(const std::vector<Point3> &vertex_list,
+                     const std::vector<Index>  &face_list,
+                     uint32_t                   max_leaf_size,
+                     uint32_t                   thread_count)
+{
+    nodes_.clear();
+    vertices_.clear();
+    indices_.clear();
+    face_index_.clear();
+
+    uint32_t tri_count = static_cast<uint32_t>(face_list.size() / 3);
+    if(tri_count == 0) return;
+    thread_count = resolve_thread_count(thread_count);
+
+    // Bounds and centroid of each triangle
+    std::vector<BuildTriangle> tris(tri_count);
+    parallel_for(tri_count, thread_count, PARALLEL_MIN_TRIANGLES, [&](size_t first, size_t last) {
+        for(size_t t = first; t < last; t++)
+        {
+            AABB box;
+            box.merge(vertex_list[face_list[3 * t]]);
+            box.merge(vertex_list[face_list[3 * t + 1]]);
+            box.merge(vertex_list[face_list[3 * t + 2]]);
+            tris[t].bounds = box;
+            tris[t].centroid = box.min_corner.mid_point(box.max_corner);
+        }
+    });
+
+    // Build the tree. Each level below the root doubles the number of
+    // threads, so stop spawning once there is one subtree per thread.
+    std::vector<uint32_t> order(tri_count);
+    std::iota(order.begin(), order.end(), 0u);
+    uint32_t parallel_depth = 0;
+    while((1u << parallel_depth) < thread_count) parallel_depth++;
+    nodes_.reserve(2 * static_cast<size_t>(tri_count));
+    Builder builder{tris, order, std::max(1u, max_leaf_size)};
+    builder.build(0, tri_count, 0, parallel_depth, nodes_);
+    nodes_.shrink_to_fit();
+
+    // Store the triangles in leaf order so each leaf reads one contiguous block
+    vertices_.resize(3 * static_cast<size_t>(tri_count));
+    indices_.resize(3 * static_cast<size_t>(tri_count));
+    face_index_ = std::move(order);
+    parallel_for(tri_count, thread_count, PARALLEL_MIN_TRIANGLES, [&](size_t first, size_t last) {
+        for(size_t i = first; i < last; i++)
+        {
+            for(size_t k = 0; k < 3; k++)
+            {
+                uint32_t v = face_list[3 * static_cast<size_t>(face_index_[i]) + k];
+                indices_[3 * i + k] = v;
+                vertices_[3 * i + k] = vertex_list[v];
+            }
+        }
+    });
+}
+
+void BVH::refit(const std::vector<Point3> &vertex_list)
+{
+    for(size_t i = 0; i < indices_.size(); i++) vertices_[i] = vertex_list[indices_[i]];
+
+    // Children always follow their parent, so a reverse sweep sees both
+    // children before the parent
+    for(size_t i = nodes_.size(); i-- > 0;)
+    {
+        BVHNode &n = nodes_[i];
+        AABB     box;
+        if(n.is_leaf())
+        {
+            size_t first = 3 * static_cast<size_t>(n.offset);
+            size_t last = first + 3 * static_cast<size_t>(n.count);
+            for(size_t v = first; v < last; v++) box.merge(vertices_[v]);
+        }
+        else
+        {
+            box = nodes_[i + 1].bounds;
+            box.merge(nodes_[n.offset].bounds);
+        }
+        n.bounds = box;
+    }
+}
+
+RayMeshIntersectResult BVH::intersect(const Ray3 &ray, float t_min) const
+{
+    RayMeshIntersectResult result{false, t_min, 0.0f, 0.0f, 0};
+    SlabRay                slab(ray);
+    float                  t_entry;
+    if(nodes_.empty() || !slab.hit(nodes_[0].bounds, t_min, t_entry))
+    {
+        result.distance = 0.0f;
+        return result;
+    }
+
+    StackEntry stack[STACK_SIZE];
+    int32_t    top = 0;
+    stack[top++] = {0, t_entry};
+    while(top > 0)
+    {
+        StackEntry entry = stack[--top];
+        if(entry.t_entry > result.distance) continue;
+
+        // Descend, visiting the nearer child first
+        uint32_t node = entry.node;
+        while(!nodes_[node].is_leaf())
+        {
+            uint32_t left = node + 1;
+            uint32_t right = nodes_[node].offset;
+            float    t_left, t_right;
+            bool     hit_left = slab.hit(nodes_[left].bounds, result.distance, t_left);
+            bool     hit_right = slab.hit(nodes_[right].bounds, result.distance, t_right);
+            if(hit_left && hit_right)
+            {
+                if(t_right < t_left)
+                {
+                    std::swap(left, right);
+                    std::swap(t_left, t_right);
+                }
+                stack[top++] = {right, t_right};
+                node = left;
+            }
+            else if(hit_left) node = left;
+            else if(hit_right) node = right;
+            else break;
+        }
+
+        const BVHNode &leaf = nodes_[node];
+        if(!leaf.is_leaf()) continue;
+        for(uint32_t i = leaf.offset; i < leaf.offset + leaf.count; i++)
+        {
+            const Point3              *v = &vertices_[3 * static_cast<size_t>(i)];
+            RayTriangleIntersectResult hit = ray.intersect(v[0], v[1], v[2]);
+            if(!hit.intersects || hit.distance > result.distance) continue;
+
+            // On ties keep the lowest face index, as the brute force loop does
+            if(hit.distance == result.distance &&
+               (!result.intersects || face_index_[i] > result.face_index))
+                continue;
+            result = {true, hit.distance, hit.barycentric_u, hit.barycentric_v, face_index_[i]};
+        }
+    }
+    if(!result.intersects) result.distance = 0.0f;
+    return result;
+}
+
+bool BVH::does_intersect_exist(const Ray3 &ray, float t_min) const
+{
+    SlabRay slab(ray);
+    float   t_entry;
+    if(nodes_.empty() || !slab.hit(nodes_[0].bounds, t_min, t_entry)) return false;
+
+    uint32_t stack[STACK_SIZE];
+    int32_t  top = 0;
+    stack[top++] = 0;
+    while(top > 0)
+    {
+        const BVHNode &n = nodes_[stack[--top]];
+        if(n.is_leaf())
+        {
+            for(uint32_t i = n.offset; i < n.offset + n.count; i++)
+            {
+                const Point3              *v = &vertices_[3 * static_cast<size_t>(i)];
+                RayTriangleIntersectResult hit = ray.intersect(v[0], v[1], v[2]);
+                if(hit.intersects && hit.distance < t_min) return true;
+            }
+            continue;
+        }
+        uint32_t left = static_cast<uint32_t>(&n - nodes_.data()) + 1;
+        if(slab.hit(nodes_[left].bounds, t_min, t_entry)) stack[top++] = left;
+        if(slab.hit(nodes_[n.offset].bounds, t_min, t_entry)) stack[top++] = n.offset;
+    }
+    return false;
+}
+
+const std::vector<BVHNode> &BVH::nodes() const { return nodes_; }
+
+size_t BVH::triangle_count() const { return face_index_.size(); }
+
+} // namespace cg
@@ -0,0 +1,189 @@
+//============================================================================
+//	Johns Hopkins University Engineering for Professionals
+//	605.667 Computer Graphics and 605.767 Applied Computer Graphics
+//	Instructor:	Brian Russin
+//
+//	Author:  Kyle Meyer
+//	File:    bvh.hpp
+//	Purpose: Bounding volume hierarchy over a triangle mesh. Built with a
+//           binned surface area heuristic (SAH), optionally on several
+//           threads. Nodes are stored in one flat array in depth first
+//           order so traversal walks mostly forward through memory.
+//============================================================================
+
+#ifndef __GEOMETRY_BVH_HPP__
+#define __GEOMETRY_BVH_HPP__
+
+#include "geometry/aabb.hpp"
+#include "geometry/index_buffer.hpp"
+#include "geometry/point3.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace cg
+{
+
+// Forward Declarations
+struct Ray3;
+struct RayMeshIntersectResult;
+
+/**
+ * BVH node (32 bytes, two per cache line). The left child of an interior
+ * node immediately follows it; offset holds the index of the right child.
+ * For a leaf, offset is the first triangle and count the number of
+ * triangles.
+ */
+struct BVHNode
+{
+    AABB     bounds;
+    uint32_t offset;
+    uint32_t count;
+
+    /**
+     * Is this node a leaf?
+     * @return  Returns true if the node holds triangles.
+     */
+    bool is_leaf() const { return count > 0; }
+};
+
+/**
+ * Bounding volume hierarchy over a triangle mesh given as a vertex list and
+ * a face list (3 indices per triangle).
+ */
+class BVH
+{
+  public:
+    /**
+     * Default constructor. Creates an empty hierarchy.
+     */
+    BVH();
+
+    /**
+     * Constructor. Builds the hierarchy for a mesh.
+     * @param  vertex_list    Vertex list of the triangle mesh.
+     * @param  face_list      Face index list.
+     * @param  max_leaf_size  Largest number of triangles in a leaf.
+     * @param  thread_count   Number of build threads (0 = one per core).
+     */
+    BVH(const std::vector<Point3>   &vertex_list,
+        const std::vector<uint16_t> &face_list,
+        uint32_t                     max_leaf_size = 4,
+        uint32_t                     thread_count = 0);
+
+    /**
+     * Constructor for meshes with 32 bit indices.
+     * @param  vertex_list    Vertex list of the triangle mesh.
+     * @param  face_list      Face index list.
+     * @param  max_leaf_size  Largest number of triangles in a leaf.
+     * @param  thread_count   Number of build threads (0 = one per core).
+     */
+    BVH(const std::vector<Point3>   &vertex_list,
+        const std::vector<uint32_t> &face_list,
+        uint32_t                     max_leaf_size = 4,
+        uint32_t                     thread_count = 0);
+
+    /**
+     * Constructor for meshes with 16 or 32 bit indices.
+     * @param  vertex_list    Vertex list of the triangle mesh.
+     * @param  face_list      Face index list.
+     * @param  max_leaf_size  Largest number of triangles in a leaf.
+     * @param  thread_count   Number of build threads (0 = one per core).
+     */
+    BVH(const std::vector<Point3> &vertex_list,
+        const IndexBuffer         &face_list,
+        uint32_t                   max_leaf_size = 4,
+        uint32_t                   thread_count = 0);
+
+    /**
+     * Builds (or rebuilds) the hierarchy for a mesh.
+     * @param  vertex_list    Vertex list of the triangle mesh.
+     * @param  face_list      Face index list.
+     * @param  max_leaf_size  Largest number of triangles in a leaf.
+     * @param  thread_count   Number of build threads (0 = one per core).
+     */
+    void build(const std::vector<Point3>   &vertex_list,
+               const std::vector<uint16_t> &face_list,
+               uint32_t                     max_leaf_size = 4,
+               uint32_t                     thread_count = 0);
+
+    /**
+     * Builds (or rebuilds) the hierarchy for a mesh with 32 bit indices.
+     * @param  vertex_list    Vertex list of the triangle mesh.
+     * @param  face_list      Face index list.
+     * @param  max_leaf_size  Largest number of triangles in a leaf.
+     * @param  thread_count   Number of build threads (0 = one per core).
+     */
+    void build(const std::vector<Point3>   &vertex_list,
+               const std::vector<uint32_t> &face_list,
+               uint32_t                     max_leaf_size = 4,
+               uint32_t                     thread_count = 0);
+
+    /**
+     * Builds (or rebuilds) the hierarchy for a mesh with 16 or 32 bit indices.
+     * @param  vertex_list    Vertex list of the triangle mesh.
+     * @param  face_list      Face index list.
+     * @param  max_leaf_size  Largest number of triangles in a leaf.
+     * @param  thread_count   Number of build threads (0 = one per core).
+     */
+    void build(const std::vector<Point3> &vertex_list,
+               const IndexBuffer         &face_list,
+               uint32_t                   max_leaf_size = 4,
+               uint32_t                   thread_count = 0);
+
+    /**
+     * Updates the node bounds after vertices move. The tree structure is
+     * kept, so this is much faster than a rebuild but traversal slows down
+     * if the mesh deforms a lot. The face list must be the one used to
+     * build the hierarchy.
+     * @param  vertex_list  Updated vertex list (same size and order).
+     */
+    void refit(const std::vector<Point3> &vertex_list);
+
+    /**
+     * Finds the nearest intersection of a ray with the mesh. Same result as
+     * Ray3::intersect(vertex_list, face_list, t_min).
+     * @param  ray    Ray to intersect.
+     * @param  t_min  Only intersections closer than t_min are reported.
+     * @return Returns whether or not there is an intersection, the distance,
+     *         the barycentric coordinates and the face index.
+     */
+    RayMeshIntersectResult intersect(const Ray3 &ray, float t_min) const;
+
+    /**
+     * Does any intersection closer than t_min exist. Stops at the first
+     * one found.
+     * @param  ray    Ray to intersect.
+     * @param  t_min  t value for intersection.
+     * @return Returns true if an intersection exists, false if not.
+     */
+    bool does_intersect_exist(const Ray3 &ray, float t_min) const;
+
+    /**
+     * Gets the nodes. Node 0 is the root.
+     * @return  Returns the flattened node array.
+     */
+    const std::vector<BVHNode> &nodes() const;
+
+    /**
+     * Gets the number of triangles in the hierarchy.
+     * @return  Returns the triangle count.
+     */
+    size_t triangle_count() const;
+
+  protected:
+    std::vector<BVHNode>  nodes_;
+    std::vector<Point3>   vertices_;   // 3 per triangle, in leaf order
+    std::vector<uint32_t> indices_;    // Vertex indices of vertices_
+    std::vector<uint32_t> face_index_; // Face list triangle of each leaf triangle
+
+    template <typename Index>
+    void build_mesh(const std::vector<Point3> &vertex_list,
+                    const std::vector<Index>  &face_list,
+                    uint32_t                   max_leaf_size,
+                    uint32_t                   thread_count);
+};
+
+} // namespace cg
+
+#endif
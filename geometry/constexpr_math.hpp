@@ -0,0 +1,110 @@
+//============================================================================
+//	Johns Hopkins University Engineering for Professionals
+//	605.667 Computer Graphics and 605.767 Applied Computer Graphics
+//	Instructor:	Brian Russin
+//
+//	Author:  Kyle Meyer
+//	File:    constexpr_math.hpp
+//	Purpose: sqrt, sin, cos and tan usable in constant expressions (the
+//           std:: versions are not constexpr in C++17). Used to build
+//           transforms from literal values at compile time. Evaluated in
+//           double precision, so results match std:: to float precision.
+//============================================================================
+
+#ifndef __GEOMETRY_CONSTEXPR_MATH_HPP__
+#define __GEOMETRY_CONSTEXPR_MATH_HPP__
+
+#include "geometry/constants.hpp"
+
+#include <cstdint>
+
+namespace cg
+{
+
+/**
+ * Square root by Newton's method.
+ * @param   x   Value. Returns 0 for x <= 0.
+ * @return  Returns sqrt(x).
+ */
+constexpr double constexpr_sqrt(double x)
+{
+    if(!(x > 0.0)) return 0.0;
+    double r = (x > 1.0) ? x : 1.0;
+    for(int32_t i = 0; i < 100; i++)
+    {
+        double next = 0.5 * (r + x / r);
+        if(next >= r) break;
+        r = next;
+    }
+    return r;
+}
+
+/**
+ * Sine of an angle in radians. Reduces to [-pi, pi] and sums the Taylor
+ * series.
+ * @param   x   Angle in radians.
+ * @return  Returns sin(x).
+ */
+constexpr double constexpr_sin(double x)
+{
+    constexpr double TWO_PI = 2.0 * CG_PI;
+    double           k = x / TWO_PI;
+    x -= TWO_PI * static_cast<double>(static_cast<int64_t>(k < 0.0 ? k - 0.5 : k + 0.5));
+
+    double term = x;
+    double sum = x;
+    for(int32_t n = 1; n < 20; n++)
+    {
+        term *= -x * x / static_cast<double>((2 * n) * (2 * n + 1));
+        sum += term;
+    }
+    return sum;
+}
+
+/**
+ * Cosine of an angle in radians.
+ * @param   x   Angle in radians.
+ * @return  Returns cos(x).
+ */
+constexpr double constexpr_cos(double x) { return constexpr_sin(x + 0.5 * CG_PI); }
+
+/**
+ * Sine of an angle in degrees. Multiples of 90 degrees give exact results
+ * (e.g. sin(180) is 0 rather than a small round off value).
+ * @param   degrees   Angle in degrees.
+ * @return  Returns the sine of the angle.
+ */
+constexpr double constexpr_sin_deg(double degrees)
+{
+    double quadrant = degrees / 90.0;
+    if(quadrant == static_cast<double>(static_cast<int64_t>(quadrant)))
+    {
+        // Exact values: 0, 1, 0, -1 for 0, 90, 180, 270 degrees
+        int64_t q = static_cast<int64_t>(quadrant) % 4;
+        if(q < 0) q += 4;
+        return (q == 1) ? 1.0 : (q == 3) ? -1.0 : 0.0;
+    }
+    return constexpr_sin(degrees * (CG_PI / 180.0));
+}
+
+/**
+ * Cosine of an angle in degrees. Multiples of 90 degrees give exact
+ * results.
+ * @param   degrees   Angle in degrees.
+ * @return  Returns the cosine of the angle.
+ */
+constexpr double constexpr_cos_deg(double degrees) { return constexpr_sin_deg(degrees + 90.0); }
+
+/**
+ * Tangent of an angle in degrees.
+ * @param   degrees   Angle in degrees.
+ * @return  Returns the tangent of the angle.
+ */
+constexpr double constexpr_tan_deg(double degrees)
+{
+    return constexpr_sin_deg(degrees) / constexpr_cos_deg(degrees);
+}
+
+} // namespace cg
+
+#endif
@@ -0,0 +1,111 @@
+#include "geometry/cpu_features.hpp"
+
+#include <cstdint>
+
+#if defined(CG_SIMD_X86)
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+namespace cg
+{
+
+namespace
+{
+
+#if defined(CG_SIMD_X86)
+void cpuid(int32_t leaf, int32_t subleaf, uint32_t regs[4])
+{
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuidex(info, leaf, subleaf);
+    for(int i = 0; i < 4; i++) regs[i] = static_cast<uint32_t>(info[i]);
+#else
+    __cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+}
+
+// Reads the XCR0 register to check that the OS saves the AVX (YMM) state
+uint64_t xgetbv0()
+{
+#if defined(_MSC_VER)
+    return _xgetbv(0);
+#else
+    uint32_t eax, edx;
+    __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    return (static_cast<uint64_t>(edx) << 32) | eax;
+#endif
+}
+#endif
+
+CpuFeatures detect_cpu_features()
+{
+    CpuFeatures features{false, false, false, false};
+#if defined(CG_SIMD_X86)
+    uint32_t regs[4];
+    cpuid(0, 0, regs);
+    uint32_t max_leaf = regs[0];
+    if(max_leaf < 1) return features;
+
+    cpuid(1, 0, regs);
+    features.sse41 = (regs[2] & (1u << 19)) != 0;
+    bool os_xsave = (regs[2] & (1u << 27)) != 0;
+    bool cpu_avx = (regs[2] & (1u << 28)) != 0;
+    bool cpu_fma = (regs[2] & (1u << 12)) != 0;
+
+    // AVX also requires the OS to preserve the XMM and YMM registers
+    bool os_avx = os_xsave && ((xgetbv0() & 0x6) == 0x6);
+    features.avx = cpu_avx && os_avx;
+    features.fma = cpu_fma && features.avx;
+
+    if(max_leaf >= 7)
+    {
+        cpuid(7, 0, regs);
+        features.avx2 = features.avx && (regs[1] & (1u << 5)) != 0;
+    }
+#endif
+    return features;
+}
+
+} // namespace
+
+const CpuFeatures &cpu_features()
+{
+    static const CpuFeatures features = detect_cpu_features();
+    return features;
+}
+
+SimdLevel best_simd_level()
+{
+    if(is_simd_level_supported(SimdLevel::AVX2)) return SimdLevel::AVX2;
+    if(is_simd_level_supported(SimdLevel::SSE41)) return SimdLevel::SSE41;
+    return SimdLevel::SCALAR;
+}
+
+bool is_simd_level_supported(SimdLevel level)
+{
+    const CpuFeatures &f = cpu_features();
+    switch(level)
+    {
+        case SimdLevel::SCALAR: return true;
+        case SimdLevel::SSE41: return f.sse41;
+        case SimdLevel::AVX2: return f.sse41 && f.avx2;
+        default: return false;
+    }
+}
+
+const char *simd_level_name(SimdLevel level)
+{
+    switch(level)
+    {
+        case SimdLevel::SCALAR: return "scalar";
+        case SimdLevel::SSE41: return "sse4.1";
+        case SimdLevel::AVX2: return "avx2";
+        default: return "unknown";
+    }
+}
+
+} // namespace cg
@@ -0,0 +1,84 @@
+//============================================================================
+//	Johns Hopkins University Engineering for Professionals
+//	605.667 Computer Graphics and 605.767 Applied Computer Graphics
+//	Instructor:	Brian Russin
+//
+//	Author:  Kyle Meyer
+//	File:    cpu_features.hpp
+//	Purpose: Runtime detection of the SIMD instruction sets supported by
+//           the host CPU. Used to select vectorized geometry kernels.
+//============================================================================
+
+#ifndef __GEOMETRY_CPU_FEATURES_HPP__
+#define __GEOMETRY_CPU_FEATURES_HPP__
+
+// SIMD kernels are only compiled for x86 / x64 targets. Other targets (e.g.
+// Apple Silicon or Windows on ARM) always use the scalar code paths.
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define CG_SIMD_X86 1
+#endif
+
+// GCC and Clang require a target attribute to emit instructions beyond the
+// baseline ISA in a single function. MSVC allows intrinsics without it.
+#if defined(CG_SIMD_X86) && (defined(__GNUC__) || defined(__clang__))
+#define CG_TARGET_SSE41 __attribute__((target("sse4.1")))
+#define CG_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define CG_TARGET_SSE41
+#define CG_TARGET_AVX2
+#endif
+
+namespace cg
+{
+
+/**
+ * SIMD instruction set levels, in increasing order of capability.
+ */
+enum class SimdLevel
+{
+    SCALAR,
+    SSE41,
+    AVX2
+};
+
+/**
+ * Instruction sets supported by the host CPU (and enabled by the OS).
+ */
+struct CpuFeatures
+{
+    bool sse41;
+    bool avx;
+    bool avx2;
+    bool fma;
+};
+
+/**
+ * Gets the features of the host CPU. Detection (cpuid) runs once on the
+ * first call.
+ * @return  Returns the supported instruction sets.
+ */
+const CpuFeatures &cpu_features();
+
+/**
+ * Gets the highest SIMD level supported by the host CPU.
+ * @return  Returns the best supported SIMD level.
+ */
+SimdLevel best_simd_level();
+
+/**
+ * Tests whether a SIMD level is supported by the host CPU.
+ * @param  level  SIMD level to test.
+ * @return  Returns true if kernels compiled for the level may be run.
+ */
+bool is_simd_level_supported(SimdLevel level);
+
+/**
+ * Gets a printable name for a SIMD level.
+ * @param  level  SIMD level.
+ * @return  Returns the name of the level.
+ */
+const char *simd_level_name(SimdLevel level);
+
+} // namespace cg
+
+#endif
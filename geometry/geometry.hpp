@@ -11,25 +11,13 @@
 #ifndef __GEOMETRY_GEOMETRY_HPP__
 #define __GEOMETRY_GEOMETRY_HPP__
 
+#include "geometry/constants.hpp"
+
 #include <cmath>
 
 namespace cg
 {
 
-#ifndef CG_MATH_CONSTANTS
-#define CG_MATH_CONSTANTS
-#define CG_PI 3.141592653589793115997963468544185161590576171875
-#define CG_PHI 1.6180339887498948482072100296669248109537875279784202576
-#define CG_PHI_INV 0.6180339887498948482072100296669248109537875279784202576
-#endif
-
-constexpr float PI = static_cast<float>(CG_PI);
-constexpr float PHI = static_cast<float>(CG_PHI);
-constexpr float PHI_INV = static_cast<float>(CG_PHI_INV);
-constexpr float EPSILON = 0.000001f;
-constexpr float RADIANS_PER_DEGREE = static_cast<float>(180.0 / CG_PI);
-constexpr float DEGREES_PER_RADIAN = static_cast<float>(CG_PI / 180.0);
-
 /**
  * Degrees to radians conversion
  * @param   d   Angle in degrees.
@@ -45,13 +33,15 @@ float degrees_to_radians(float d);
 float radians_to_degrees(float r);
 
 /**
- * Get a random number between 0 and 1.
- * return  Returns a random floating point number betwen 0 and 1.
+ * Get a random number between 0 and 1. Draws from the calling thread's
+ * generator (thread_random()), so it is safe to call from worker threads.
+ * return  Returns a random floating point number in [0, 1).
  */
 float rand_0_1();
 
 /**
- * Fast inverse sqrt method. Originally used in Quake III
+ * Fast inverse sqrt method. Originally used in Quake III. Relative error is
+ * below 2e-3; see inverse_lengths / normalize_vectors for arrays.
  * @param  x  Value to find inverse sqrt for
  * @return  Returns 1/sqrt(x)
  */
@@ -67,15 +57,28 @@ float fast_inv_sqrt(float x);
 #include "geometry/point3.hpp"
 #include "geometry/vector2.hpp"
 #include "geometry/vector3.hpp"
+#include "geometry/vector3_packet.hpp"
+#include "geometry/predicates.hpp"
 #include "geometry/segment2.hpp"
+#include "geometry/polygon_grid.hpp"
+#include "geometry/prepared_polygon.hpp"
+#include "geometry/segment_intersections.hpp"
 #include "geometry/segment3.hpp"
 #include "geometry/plane.hpp"
 #include "geometry/aabb.hpp"
 #include "geometry/bounding_sphere.hpp"
+#include "geometry/index_buffer.hpp"
 #include "geometry/ray3.hpp"
+#include "geometry/ray_packet.hpp"
+#include "geometry/parallel.hpp"
+#include "geometry/bvh.hpp"
 #include "geometry/noise.hpp"
+#include "geometry/random.hpp"
 #include "geometry/matrix.hpp"
+#include "geometry/quaternion.hpp"
 #include "geometry/types.hpp"
+#include "geometry/transform_batch.hpp"
+#include "geometry/normalize_batch.hpp"
 // clang-format on
 
 #endif
@@ -12,8 +12,12 @@
 #ifndef __GEOMETRY_HPOINT2_HPP__
 #define __GEOMETRY_HPOINT2_HPP__
 
+#include "geometry/constants.hpp"
 #include "geometry/point2.hpp"
 
+#include <cmath>
+#include <type_traits>
+
 namespace cg
 {
 
@@ -29,7 +33,7 @@ struct HPoint2
     /**
      * Default constructor
      */
-    HPoint2();
+    constexpr HPoint2();
 
     /**
      * Constructor with initial values for x,y,w.
@@ -37,7 +41,7 @@ struct HPoint2
      * @param   iy   y coordinate position.
      * @param   iw   Homogeneous factor
      */
-    HPoint2(float ix, float iy, float iw);
+    constexpr HPoint2(float ix, float iy, float iw);
 
     /**
      * Convert to a cartesian representation.
@@ -46,6 +50,27 @@ struct HPoint2
     Point2 to_cartesian() const;
 };
 
+static_assert(sizeof(HPoint2) == 3 * sizeof(float), "HPoint2 must be tightly packed");
+static_assert(std::is_trivially_copyable<HPoint2>::value, "HPoint2 must be trivially copyable");
+
+// Inline definitions
+
+constexpr HPoint2::HPoint2() : x(0.0f), y(0.0f), w(1.0f) {}
+
+constexpr HPoint2::HPoint2(float ix, float iy, float iw) : x(ix), y(iy), w(iw) {}
+
+inline Point2 HPoint2::to_cartesian() const
+{
+
+    if(w == 1.0f) { return Point2(x, y); }
+    else
+    {
+        // Perform division through by w
+        float d = (std::abs(w) > EPSILON) ? (1.0f / w) : 1.0f;
+        return Point2(x * d, y * d);
+    }
+}
+
 } // namespace cg
 
 #endif
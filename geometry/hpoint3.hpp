@@ -12,8 +12,12 @@
 #ifndef __GEOMETRY_HPOINT3_HPP__
 #define __GEOMETRY_HPOINT3_HPP__
 
+#include "geometry/constants.hpp"
 #include "geometry/point3.hpp"
 
+#include <cmath>
+#include <type_traits>
+
 namespace cg
 {
 
@@ -30,7 +34,7 @@ struct HPoint3
     /**
      * Default constructor
      */
-    HPoint3();
+    constexpr HPoint3();
 
     /**
      * Constructor with initial values for x,y,z,w.
@@ -39,7 +43,7 @@ struct HPoint3
      * @param   iz   z coordinate position.
      * @param   iw   Homogeneous factor
      */
-    HPoint3(float ix, float iy, float iz, float iw);
+    constexpr HPoint3(float ix, float iy, float iz, float iw);
 
     /**
      * Convert to a cartesian representation
@@ -48,6 +52,26 @@ struct HPoint3
     Point3 to_cartesian() const;
 };
 
+static_assert(sizeof(HPoint3) == 4 * sizeof(float), "HPoint3 must be tightly packed");
+static_assert(std::is_trivially_copyable<HPoint3>::value, "HPoint3 must be trivially copyable");
+
+// Inline definitions
+
+constexpr HPoint3::HPoint3() : x(0.0f), y(0.0f), z(0.0f), w(1.0f) {}
+
+constexpr HPoint3::HPoint3(float ix, float iy, float iz, float iw) : x(ix), y(iy), z(iz), w(iw) {}
+
+inline Point3 HPoint3::to_cartesian() const
+{
+    if(w == 1.0f) { return Point3(x, y, z); }
+    else
+    {
+        // Perform division through by w
+        float d = (std::abs(w) > EPSILON) ? (1.0f / w) : 1.0f;
+        return Point3(x * d, y * d, z * d);
+    }
+}
+
 } // namespace cg
 
 #endif
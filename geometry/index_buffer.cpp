@@ -0,0 +1,59 @@
+#include "geometry/index_buffer.hpp"
+
+#include <algorithm>
+
+namespace cg
+{
+
+IndexBuffer::IndexBuffer() : is_16_bit_(true) {}
+
+IndexBuffer::IndexBuffer(const std::vector<uint32_t> &indices) { set(indices); }
+
+IndexBuffer::IndexBuffer(const std::vector<uint16_t> &indices)
+    : indices16_(indices), is_16_bit_(true)
+{
+}
+
+void IndexBuffer::set(const std::vector<uint32_t> &indices)
+{
+    uint32_t max_index = indices.empty() ? 0 : *std::max_element(indices.begin(), indices.end());
+    is_16_bit_ = (max_index < MAX_16_BIT_VERTICES);
+    if(is_16_bit_)
+    {
+        indices16_.assign(indices.begin(), indices.end());
+        indices32_.clear();
+        indices32_.shrink_to_fit();
+    }
+    else
+    {
+        indices32_ = indices;
+        indices16_.clear();
+        indices16_.shrink_to_fit();
+    }
+}
+
+bool IndexBuffer::is_16_bit() const { return is_16_bit_; }
+
+size_t IndexBuffer::index_size() const
+{
+    return is_16_bit_ ? sizeof(uint16_t) : sizeof(uint32_t);
+}
+
+size_t IndexBuffer::size() const { return is_16_bit_ ? indices16_.size() : indices32_.size(); }
+
+const void *IndexBuffer::data() const
+{
+    return is_16_bit_ ? static_cast<const void *>(indices16_.data())
+                      : static_cast<const void *>(indices32_.data());
+}
+
+uint32_t IndexBuffer::operator[](size_t i) const
+{
+    return is_16_bit_ ? indices16_[i] : indices32_[i];
+}
+
+const std::vector<uint16_t> &IndexBuffer::indices16() const { return indices16_; }
+
+const std::vector<uint32_t> &IndexBuffer::indices32() const { return indices32_; }
+
+} // namespace cg
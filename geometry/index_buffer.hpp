@@ -0,0 +1,109 @@
+//============================================================================
+//	Johns Hopkins University Engineering for Professionals
+//	605.667 Computer Graphics and 605.767 Applied Computer Graphics
+//	Instructor:	Brian Russin
+//
+//	Author:  Kyle Meyer
+//	File:    index_buffer.hpp
+//	Purpose: Mesh index list stored with the narrowest index type that
+//           fits: 16 bit when every index is below 65536, otherwise 32
+//           bit. Small meshes keep half the index bandwidth and memory;
+//           large meshes are not limited to 65536 vertices.
+//============================================================================
+
+#ifndef __GEOMETRY_INDEX_BUFFER_HPP__
+#define __GEOMETRY_INDEX_BUFFER_HPP__
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace cg
+{
+
+// Largest vertex count that can be addressed with 16 bit indices
+constexpr size_t MAX_16_BIT_VERTICES = 65536;
+
+/**
+ * Index list with automatic 16 / 32 bit storage. Exactly one of the two
+ * index vectors is in use.
+ */
+class IndexBuffer
+{
+  public:
+    /**
+     * Default constructor. Empty 16 bit buffer.
+     */
+    IndexBuffer();
+
+    /**
+     * Constructor given indices. Stores them as 16 bit if they all fit.
+     * @param  indices  Index list.
+     */
+    IndexBuffer(const std::vector<uint32_t> &indices);
+
+    /**
+     * Constructor given 16 bit indices.
+     * @param  indices  Index list.
+     */
+    IndexBuffer(const std::vector<uint16_t> &indices);
+
+    /**
+     * Sets the indices. Stores them as 16 bit if they all fit.
+     * @param  indices  Index list.
+     */
+    void set(const std::vector<uint32_t> &indices);
+
+    /**
+     * Are the indices stored as 16 bit?
+     * @return  Returns true for 16 bit storage, false for 32 bit.
+     */
+    bool is_16_bit() const;
+
+    /**
+     * Gets the size in bytes of one index (2 or 4). Use GL_UNSIGNED_SHORT
+     * for 2 and GL_UNSIGNED_INT for 4 when drawing.
+     * @return  Returns the index size in bytes.
+     */
+    size_t index_size() const;
+
+    /**
+     * Gets the number of indices.
+     * @return  Returns the index count.
+     */
+    size_t size() const;
+
+    /**
+     * Gets the raw index data, e.g. for glBufferData.
+     * @return  Returns a pointer to size() * index_size() bytes.
+     */
+    const void *data() const;
+
+    /**
+     * Gets one index regardless of storage.
+     * @param  i  Position in the list.
+     * @return  Returns the index.
+     */
+    uint32_t operator[](size_t i) const;
+
+    /**
+     * Gets the 16 bit indices (empty unless is_16_bit()).
+     * @return  Returns the 16 bit index list.
+     */
+    const std::vector<uint16_t> &indices16() const;
+
+    /**
+     * Gets the 32 bit indices (empty if is_16_bit()).
+     * @return  Returns the 32 bit index list.
+     */
+    const std::vector<uint32_t> &indices32() const;
+
+  protected:
+    std::vector<uint16_t> indices16_;
+    std::vector<uint32_t> indices32_;
+    bool                  is_16_bit_;
+};
+
+} // namespace cg
+
+#endif
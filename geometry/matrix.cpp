@@ -1,6 +1,7 @@
 #include "geometry/matrix.hpp"
 
 #include "geometry/geometry.hpp"
+#include "geometry/matrix_kernels.hpp"
 
 #include <cmath>
 
@@ -10,166 +11,11 @@ namespace cg
 // Forward declare logging function
 void logmsg(const char *message, ...);
 
-Matrix4x4::Matrix4x4() { set_identity(); }
-
-void Matrix4x4::set_identity()
-{
-    a_[0] = 1.0f;
-    a_[4] = 0.0f;
-    a_[8] = 0.0f;
-    a_[12] = 0.0f;
-    a_[1] = 0.0f;
-    a_[5] = 1.0f;
-    a_[9] = 0.0f;
-    a_[13] = 0.0f;
-    a_[2] = 0.0f;
-    a_[6] = 0.0f;
-    a_[10] = 1.0f;
-    a_[14] = 0.0f;
-    a_[3] = 0.0f;
-    a_[7] = 0.0f;
-    a_[11] = 0.0f;
-    a_[15] = 1.0f;
-}
-
-Matrix4x4::Matrix4x4(const Matrix4x4 &n)
-{
-    m00() = n.m00();
-    m01() = n.m01();
-    m02() = n.m02();
-    m03() = n.m03();
-    m10() = n.m10();
-    m11() = n.m11();
-    m12() = n.m12();
-    m13() = n.m13();
-    m20() = n.m20();
-    m21() = n.m21();
-    m22() = n.m22();
-    m23() = n.m23();
-    m30() = n.m30();
-    m31() = n.m31();
-    m32() = n.m32();
-    m33() = n.m33();
-}
-
-Matrix4x4 &Matrix4x4::operator=(const Matrix4x4 &n)
-{
-    m00() = n.m00();
-    m01() = n.m01();
-    m02() = n.m02();
-    m03() = n.m03();
-    m10() = n.m10();
-    m11() = n.m11();
-    m12() = n.m12();
-    m13() = n.m13();
-    m20() = n.m20();
-    m21() = n.m21();
-    m22() = n.m22();
-    m23() = n.m23();
-    m30() = n.m30();
-    m31() = n.m31();
-    m32() = n.m32();
-    m33() = n.m33();
-    return *this;
-}
-
-bool Matrix4x4::operator==(const Matrix4x4 &n) const
-{
-    return (m00() == n.m00() && m01() == n.m01() && m02() == n.m02() && m03() == n.m03() &&
-            m10() == n.m10() && m11() == n.m11() && m12() == n.m12() && m13() == n.m13() &&
-            m20() == n.m20() && m21() == n.m21() && m22() == n.m22() && m23() == n.m23() &&
-            m30() == n.m30() && m31() == n.m31() && m32() == n.m32() && m33() == n.m33());
-}
-
-void Matrix4x4::set(const float *m)
-{
-    for(size_t i = 0; i < 16; i++) a_[i] = m[i];
-}
-
-const float *Matrix4x4::get() const { return a_.data(); }
-
-// Read-only access functions
-float Matrix4x4::m00() const { return a_[0]; }
-float Matrix4x4::m01() const { return a_[4]; }
-float Matrix4x4::m02() const { return a_[8]; }
-float Matrix4x4::m03() const { return a_[12]; }
-float Matrix4x4::m10() const { return a_[1]; }
-float Matrix4x4::m11() const { return a_[5]; }
-float Matrix4x4::m12() const { return a_[9]; }
-float Matrix4x4::m13() const { return a_[13]; }
-float Matrix4x4::m20() const { return a_[2]; }
-float Matrix4x4::m21() const { return a_[6]; }
-float Matrix4x4::m22() const { return a_[10]; }
-float Matrix4x4::m23() const { return a_[14]; }
-float Matrix4x4::m30() const { return a_[3]; }
-float Matrix4x4::m31() const { return a_[7]; }
-float Matrix4x4::m32() const { return a_[11]; }
-float Matrix4x4::m33() const { return a_[15]; }
-
-// Read-write access functions
-float &Matrix4x4::m00() { return a_[0]; }
-float &Matrix4x4::m01() { return a_[4]; }
-float &Matrix4x4::m02() { return a_[8]; }
-float &Matrix4x4::m03() { return a_[12]; }
-float &Matrix4x4::m10() { return a_[1]; }
-float &Matrix4x4::m11() { return a_[5]; }
-float &Matrix4x4::m12() { return a_[9]; }
-float &Matrix4x4::m13() { return a_[13]; }
-float &Matrix4x4::m20() { return a_[2]; }
-float &Matrix4x4::m21() { return a_[6]; }
-float &Matrix4x4::m22() { return a_[10]; }
-float &Matrix4x4::m23() { return a_[14]; }
-float &Matrix4x4::m30() { return a_[3]; }
-float &Matrix4x4::m31() { return a_[7]; }
-float &Matrix4x4::m32() { return a_[11]; }
-float &Matrix4x4::m33() { return a_[15]; }
-
-float Matrix4x4::m(uint32_t row, uint32_t col) const
-{
-    return (row < 4 && col < 4) ? a_[col * 4 + row] : 0.0f;
-}
-
-float &Matrix4x4::m(uint32_t row, uint32_t col)
-{
-    return (row < 4 && col < 4) ? a_[col * 4 + row] : a_[0];
-}
-
 Matrix4x4 Matrix4x4::operator*(const Matrix4x4 &n) const
 {
-    // Unroll the loop, do 1 row at a time.
+    // Use the kernel selected for this CPU (SSE4.1 / AVX2 or scalar fallback)
     Matrix4x4 t;
-    float     a0 = m00();
-    float     a1 = m01();
-    float     a2 = m02();
-    float     a3 = m03();
-    t.m00() = a0 * n.m00() + a1 * n.m10() + a2 * n.m20() + a3 * n.m30();
-    t.m01() = a0 * n.m01() + a1 * n.m11() + a2 * n.m21() + a3 * n.m31();
-    t.m02() = a0 * n.m02() + a1 * n.m12() + a2 * n.m22() + a3 * n.m32();
-    t.m03() = a0 * n.m03() + a1 * n.m13() + a2 * n.m23() + a3 * n.m33();
-    a0 = m10();
-    a1 = m11();
-    a2 = m12();
-    a3 = m13();
-    t.m10() = a0 * n.m00() + a1 * n.m10() + a2 * n.m20() + a3 * n.m30();
-    t.m11() = a0 * n.m01() + a1 * n.m11() + a2 * n.m21() + a3 * n.m31();
-    t.m12() = a0 * n.m02() + a1 * n.m12() + a2 * n.m22() + a3 * n.m32();
-    t.m13() = a0 * n.m03() + a1 * n.m13() + a2 * n.m23() + a3 * n.m33();
-    a0 = m20();
-    a1 = m21();
-    a2 = m22();
-    a3 = m23();
-    t.m20() = a0 * n.m00() + a1 * n.m10() + a2 * n.m20() + a3 * n.m30();
-    t.m21() = a0 * n.m01() + a1 * n.m11() + a2 * n.m21() + a3 * n.m31();
-    t.m22() = a0 * n.m02() + a1 * n.m12() + a2 * n.m22() + a3 * n.m32();
-    t.m23() = a0 * n.m03() + a1 * n.m13() + a2 * n.m23() + a3 * n.m33();
-    a0 = m30();
-    a1 = m31();
-    a2 = m32();
-    a3 = m33();
-    t.m30() = a0 * n.m00() + a1 * n.m10() + a2 * n.m20() + a3 * n.m30();
-    t.m31() = a0 * n.m01() + a1 * n.m11() + a2 * n.m21() + a3 * n.m31();
-    t.m32() = a0 * n.m02() + a1 * n.m12() + a2 * n.m22() + a3 * n.m32();
-    t.m33() = a0 * n.m03() + a1 * n.m13() + a2 * n.m23() + a3 * n.m33();
+    matrix_kernels().multiply(a_.data(), n.a_.data(), t.a_.data());
     return t;
 }
 
@@ -187,27 +33,25 @@ Matrix4x4 &Matrix4x4::operator*=(float s)
 
 HPoint3 Matrix4x4::operator*(const HPoint3 &v) const
 {
-    return HPoint3((a_[0] * v.x + a_[4] * v.y + a_[8] * v.z + a_[12] * v.w),
-                   (a_[1] * v.x + a_[5] * v.y + a_[9] * v.z + a_[13] * v.w),
-                   (a_[2] * v.x + a_[6] * v.y + a_[10] * v.z + a_[14] * v.w),
-                   (a_[3] * v.x + a_[7] * v.y + a_[11] * v.z + a_[15] * v.w));
+    HPoint3 t;
+    matrix_kernels().transform_hpoint(a_.data(), &v.x, &t.x);
+    return t;
 }
 
 HPoint3 Matrix4x4::operator*(const Point3 &v) const
 {
-    return HPoint3((a_[0] * v.x + a_[4] * v.y + a_[8] * v.z + a_[12]),
-                   (a_[1] * v.x + a_[5] * v.y + a_[9] * v.z + a_[13]),
-                   (a_[2] * v.x + a_[6] * v.y + a_[10] * v.z + a_[14]),
-                   (a_[3] * v.x + a_[7] * v.y + a_[11] * v.z + a_[15]));
+    HPoint3 t;
+    matrix_kernels().transform_point(a_.data(), &v.x, &t.x);
+    return t;
 }
 
 Vector3 Matrix4x4::operator*(const Vector3 &v) const
 {
   // For vectors, we only use the upper 3x3 portion (no translation)
   // Vectors have implicit w=0, so translation components are ignored
-  return Vector3((a_[0] * v.x + a_[4] * v.y + a_[8] * v.z),
-                 (a_[1] * v.x + a_[5] * v.y + a_[9] * v.z),
-                 (a_[2] * v.x + a_[6] * v.y + a_[10] * v.z));
+  Vector3 t;
+  matrix_kernels().transform_vector(a_.data(), &v.x, &t.x);
+  return t;
 }
 
 Ray3 Matrix4x4::operator*(const Ray3 &ray) const
@@ -223,175 +67,247 @@ Ray3 Matrix4x4::operator*(const Ray3 &ray) const
 
 Matrix4x4 &Matrix4x4::transpose()
 {
-    *this = get_transpose();
+    matrix_kernels().transpose(a_.data(), a_.data());
     return *this;
 }
 
 Matrix4x4 Matrix4x4::get_transpose() const
 {
     Matrix4x4 t;
-    t.m00() = m00();
-    t.m01() = m10();
-    t.m02() = m20();
-    t.m03() = m30();
-    t.m10() = m01();
-    t.m11() = m11();
-    t.m12() = m21();
-    t.m13() = m31();
-    t.m20() = m02();
-    t.m21() = m12();
-    t.m22() = m22();
-    t.m23() = m32();
-    t.m30() = m03();
-    t.m31() = m13();
-    t.m32() = m23();
-    t.m33() = m33();
+    matrix_kernels().transpose(a_.data(), t.a_.data());
     return t;
 }
 
 void Matrix4x4::translate(float x, float y, float z)
 {
-   Matrix4x4 translation;
-   translation.m03() = x;  // a_[12]
-   translation.m13() = y;  // a_[13]
-   translation.m23() = z;  // a_[14]
-   
-   *this *= translation;
+    // Right-multiplying by a translation only changes the last column:
+    // col3 = x * col0 + y * col1 + z * col2 + col3
+    for(int32_t r = 0; r < 4; r++)
+    {
+        a_[12 + r] = a_[r] * x + a_[4 + r] * y + a_[8 + r] * z + a_[12 + r];
+    }
 }
 
 void Matrix4x4::scale(float x, float y, float z)
 {
-  Matrix4x4 scaling;
-  scaling.m00() = x;
-  scaling.m11() = y;
-  scaling.m22() = z;
-  
-  *this *= scaling;
+    // Right-multiplying by a scale scales the first 3 columns
+    for(int32_t r = 0; r < 4; r++)
+    {
+        a_[r] *= x;
+        a_[4 + r] *= y;
+        a_[8 + r] *= z;
+    }
 }
 
 void Matrix4x4::rotate(float angle, float x, float y, float z)
 {
     // Normalize the axis vector
-    float length = std::sqrt(x*x + y*y + z*z);
-    if (length == 0.0f) return; // Invalid axis
-    
+    float length = std::sqrt(x * x + y * y + z * z);
+    if(length == 0.0f) return; // Invalid axis
+
     x /= length;
     y /= length;
     z /= length;
-    
+
     // Convert angle from degrees to radians
     float radians = angle * M_PI / 180.0f;
     float c = std::cos(radians);
     float s = std::sin(radians);
-    float oneMinusC = 1.0f - c;
-    
-    // Direct axis-angle rotation matrix
-    // Detailed here: https://en.wikipedia.org/wiki/Rotation_matrix
-    // ... wait this was on the SLERP slide
-    Matrix4x4 rotation;
-    rotation.m00() = c + x*x*oneMinusC;
-    rotation.m01() = x*y*oneMinusC - z*s;
-    rotation.m02() = x*z*oneMinusC + y*s;
-    rotation.m03() = 0.0f;
-    
-    rotation.m10() = y*x*oneMinusC + z*s;
-    rotation.m11() = c + y*y*oneMinusC;
-    rotation.m12() = y*z*oneMinusC - x*s;
-    rotation.m13() = 0.0f;
-    
-    rotation.m20() = z*x*oneMinusC - y*s;
-    rotation.m21() = z*y*oneMinusC + x*s;
-    rotation.m22() = c + z*z*oneMinusC;
-    rotation.m23() = 0.0f;
-    
-    rotation.m30() = 0.0f;
-    rotation.m31() = 0.0f;
-    rotation.m32() = 0.0f;
-    rotation.m33() = 1.0f;
-    
-    *this *= rotation;
+    float one_minus_c = 1.0f - c;
+
+    // Axis-angle rotation matrix (row, col)
+    // See https://en.wikipedia.org/wiki/Rotation_matrix
+    float r[3][3] = {{c + x * x * one_minus_c, x * y * one_minus_c - z * s,
+                      x * z * one_minus_c + y * s},
+                     {y * x * one_minus_c + z * s, c + y * y * one_minus_c,
+                      y * z * one_minus_c - x * s},
+                     {z * x * one_minus_c - y * s, z * y * one_minus_c + x * s,
+                      c + z * z * one_minus_c}};
+
+    // Only the first 3 columns change: colj = sum(colk * r[k][j])
+    for(int32_t row = 0; row < 4; row++)
+    {
+        float a0 = a_[row], a1 = a_[4 + row], a2 = a_[8 + row];
+        for(int32_t j = 0; j < 3; j++)
+        {
+            a_[j * 4 + row] = a0 * r[0][j] + a1 * r[1][j] + a2 * r[2][j];
+        }
+    }
 }
 
 void Matrix4x4::rotate_x(float angle)
 {
     // Convert angle from degrees to radians
     float radians = angle * M_PI / 180.0f;
-    float c = std::cos(radians);
-    float s = std::sin(radians);
-
-    Matrix4x4 rotation;
-    rotation.m11() = c;
-    rotation.m12() = -s;
-    rotation.m21() = s;
-    rotation.m22() = c;
-    
-    *this *= rotation;
+    rotate_columns(1, 2, std::cos(radians), std::sin(radians));
 }
 
 void Matrix4x4::rotate_y(float angle)
 {
     // Convert angle from degrees to radians
     float radians = angle * M_PI / 180.0f;
-    float c = std::cos(radians);
-    float s = std::sin(radians);
-    
-    Matrix4x4 rotation;
-    rotation.m00() = c;
-    rotation.m02() = s;
-    rotation.m20() = -s;
-    rotation.m22() = c;
-    
-    *this *= rotation;
+    rotate_columns(2, 0, std::cos(radians), std::sin(radians));
 }
 
 void Matrix4x4::rotate_z(float angle)
 {
     // Convert angle from degrees to radians
     float radians = angle * M_PI / 180.0f;
-    float c = std::cos(radians);
-    float s = std::sin(radians);
-    
-    Matrix4x4 rotation;
-    rotation.m00() = c;
-    rotation.m01() = -s;
-    rotation.m10() = s;
-    rotation.m11() = c;
-    
-    *this *= rotation;
+    rotate_columns(0, 1, std::cos(radians), std::sin(radians));
+}
+
+void Matrix4x4::rotate_columns(int32_t i, int32_t j, float c, float s)
+{
+    // Right-multiplying by a rotation in the plane of axes i and j
+    // changes only columns i and j
+    float *ci = &a_[i * 4];
+    float *cj = &a_[j * 4];
+    for(int32_t r = 0; r < 4; r++)
+    {
+        float ai = ci[r];
+        float aj = cj[r];
+        ci[r] = ai * c + aj * s;
+        cj[r] = ai * -s + aj * c;
+    }
+}
+
+Matrix4x4 Matrix4x4::compose_trs(const Vector3 &t, const Matrix4x4 &r, const Vector3 &s)
+{
+    // T * R * S: the rotation columns scaled by s, with t in the last column
+    Matrix4x4 m;
+    for(int32_t row = 0; row < 3; row++)
+    {
+        m.a_[row] = r.a_[row] * s.x;
+        m.a_[4 + row] = r.a_[4 + row] * s.y;
+        m.a_[8 + row] = r.a_[8 + row] * s.z;
+    }
+    m.a_[12] = t.x;
+    m.a_[13] = t.y;
+    m.a_[14] = t.z;
+    return m;
+}
+
+MatrixType Matrix4x4::classify() const
+{
+    // Tolerance on the dot products of the upper 3x3 columns. Rotation
+    // matrices built from float sin/cos are orthonormal to about 1e-7.
+    constexpr float RIGID_TOLERANCE = 1.0e-5f;
+
+    if(a_[3] != 0.0f || a_[7] != 0.0f || a_[11] != 0.0f || a_[15] != 1.0f)
+        return MatrixType::GENERAL;
+
+    for(int32_t i = 0; i < 3; i++)
+    {
+        for(int32_t j = 0; j <= i; j++)
+        {
+            float d = a_[i * 4] * a_[j * 4] + a_[i * 4 + 1] * a_[j * 4 + 1] +
+                      a_[i * 4 + 2] * a_[j * 4 + 2];
+            float expected = (i == j) ? 1.0f : 0.0f;
+            if(std::abs(d - expected) > RIGID_TOLERANCE) return MatrixType::AFFINE;
+        }
+    }
+    return MatrixType::RIGID;
+}
+
+Matrix4x4 Matrix4x4::get_inverse() const { return get_inverse(classify()); }
+
+Matrix4x4 Matrix4x4::get_inverse(MatrixType type) const
+{
+    switch(type)
+    {
+        case MatrixType::RIGID: return get_rigid_inverse();
+        case MatrixType::AFFINE: return get_affine_inverse();
+        default: return get_general_inverse();
+    }
+}
+
+Matrix4x4 Matrix4x4::get_rigid_inverse() const
+{
+    // Inverse of [R t] is [R^T -R^T t]
+    Matrix4x4 b;
+    for(int32_t c = 0; c < 3; c++)
+    {
+        for(int32_t r = 0; r < 3; r++) b.a_[c * 4 + r] = a_[r * 4 + c];
+        b.a_[12 + c] = -(a_[c * 4] * a_[12] + a_[c * 4 + 1] * a_[13] + a_[c * 4 + 2] * a_[14]);
+    }
+    return b;
+}
+
+Matrix4x4 Matrix4x4::get_affine_inverse() const
+{
+    // Inverse of [A t] is [A^-1 -A^-1 t]. The rows of A^-1 are the cross
+    // products of pairs of columns of A divided by the determinant.
+    const float *c0 = &a_[0];
+    const float *c1 = &a_[4];
+    const float *c2 = &a_[8];
+    float        rows[3][3] = {{c1[1] * c2[2] - c1[2] * c2[1],
+                                c1[2] * c2[0] - c1[0] * c2[2],
+                                c1[0] * c2[1] - c1[1] * c2[0]},
+                               {c2[1] * c0[2] - c2[2] * c0[1],
+                                c2[2] * c0[0] - c2[0] * c0[2],
+                                c2[0] * c0[1] - c2[1] * c0[0]},
+                               {c0[1] * c1[2] - c0[2] * c1[1],
+                                c0[2] * c1[0] - c0[0] * c1[2],
+                                c0[0] * c1[1] - c0[1] * c1[0]}};
+
+    Matrix4x4 b;
+    float     det = c0[0] * rows[0][0] + c0[1] * rows[0][1] + c0[2] * rows[0][2];
+    if(det == 0.0f)
+    {
+        logmsg("InvertMatrix: Singular matrix");
+        return b;
+    }
+
+    float inv_det = 1.0f / det;
+    for(int32_t r = 0; r < 3; r++)
+    {
+        float x = rows[r][0] * inv_det;
+        float y = rows[r][1] * inv_det;
+        float z = rows[r][2] * inv_det;
+        b.a_[r] = x;
+        b.a_[4 + r] = y;
+        b.a_[8 + r] = z;
+        b.a_[12 + r] = -(x * a_[12] + y * a_[13] + z * a_[14]);
+    }
+    return b;
 }
 
-Matrix4x4 Matrix4x4::get_inverse() const
+Matrix4x4 Matrix4x4::get_general_inverse() const
 {
+    // Gauss-Jordan elimination with partial pivoting. Elements (row, col)
+    // are accessed directly at [col * 4 + row].
     int32_t   j, k;
     int32_t   ind;
     float     v1, v2;
-    Matrix4x4 t = *this;
+    Matrix4x4 tm = *this;
     Matrix4x4 b;
+    float    *t = tm.a_.data();
+    float    *bi = b.a_.data();
     for(int32_t i = 0; i < 4; i++)
     {
         // Find pivot
-        v1 = t.m(i, i);
+        v1 = t[i * 4 + i];
         ind = i;
         for(j = i + 1; j < 4; j++)
         {
-            if(std::abs(t.m(j, i)) > std::abs(v1))
+            if(std::abs(t[i * 4 + j]) > std::abs(v1))
             {
                 ind = j;
-                v1 = t.m(j, i);
+                v1 = t[i * 4 + j];
             }
         }
 
-        // Swap columns
+        // Swap rows
         if(ind != i)
         {
             for(j = 0; j < 4; j++)
             {
-                v2 = b.m(i, j);
-                b.m(i, j) = b.m(ind, j);
-                b.m(ind, j) = v2;
-                v2 = t.m(i, j);
-                t.m(i, j) = t.m(ind, j);
-                t.m(ind, j) = v2;
+                v2 = bi[j * 4 + i];
+                bi[j * 4 + i] = bi[j * 4 + ind];
+                bi[j * 4 + ind] = v2;
+                v2 = t[j * 4 + i];
+                t[j * 4 + i] = t[j * 4 + ind];
+                t[j * 4 + ind] = v2;
             }
         }
 
@@ -406,8 +322,8 @@ Matrix4x4 Matrix4x4::get_inverse() const
 
         for(j = 0; j < 4; j++)
         {
-            t.m(i, j) /= v1;
-            b.m(i, j) /= v1;
+            t[j * 4 + i] /= v1;
+            bi[j * 4 + i] /= v1;
         }
 
         // Eliminate column
@@ -415,11 +331,11 @@ Matrix4x4 Matrix4x4::get_inverse() const
         {
             if(j == i) continue;
 
-            v1 = t.m(j, i);
+            v1 = t[i * 4 + j];
             for(k = 0; k < 4; k++)
             {
-                t.m(j, k) -= t.m(i, k) * v1;
-                b.m(j, k) -= b.m(i, k) * v1;
+                t[k * 4 + j] -= t[k * 4 + i] * v1;
+                bi[k * 4 + j] -= bi[k * 4 + i] * v1;
             }
         }
     }
@@ -435,4 +351,9 @@ void Matrix4x4::log(const char *str) const
     logmsg("%.3f %.3f %.3f %.3f", m30(), m31(), m32(), m33());
 }
 
+void invert_matrices(const Matrix4x4 *in, Matrix4x4 *out, size_t count)
+{
+    for(size_t i = 0; i < count; i++) out[i] = in[i].get_inverse();
+}
+
 } // namespace cg
@@ -15,13 +15,30 @@
 #include "point3.hpp"
 #include "ray3.hpp"
 #include "vector3.hpp"
+#include "geometry/constexpr_math.hpp"
 
 #include <array>
+#include <cstddef>
 #include <cstdint>
+#include <type_traits>
 
 namespace cg
 {
 
+/**
+ * Classification of a 4x4 matrix, used to select the cheapest inverse.
+ *   RIGID   - Bottom row is (0,0,0,1) and the upper 3x3 is orthonormal
+ *             (rotations, reflections and translations only).
+ *   AFFINE  - Bottom row is (0,0,0,1) (e.g. any TRS composite).
+ *   GENERAL - Anything else (e.g. perspective projections).
+ */
+enum class MatrixType
+{
+    RIGID,
+    AFFINE,
+    GENERAL
+};
+
 /**
  * 4x4 matrix. All matrix elements (row, col) are indexed base 0.
  */
@@ -31,81 +48,81 @@ class Matrix4x4
     /**
      * Constructor.  Sets the matrix to the identity matrix
      */
-    Matrix4x4();
+    constexpr Matrix4x4();
 
     /**
      * Sets the matrix to the identity matrix.
      */
-    void set_identity();
+    constexpr void set_identity();
 
     /**
      * Copy constructor
      * @param  n  Matrix to copy
      */
-    Matrix4x4(const Matrix4x4 &n);
+    Matrix4x4(const Matrix4x4 &n) = default;
 
     /**
      * Assignment operator
      * @param   n  Matrix to assign to this matrix
      * @return  Returns the address of this matrix.
      */
-    Matrix4x4 &operator=(const Matrix4x4 &n);
+    Matrix4x4 &operator=(const Matrix4x4 &n) = default;
 
     /**
      * Equality operator
      * @param   n  Matrix to test for equality with this matrix.
      * @return  Returns true if hte matrices are equal, false otherwise..
      */
-    bool operator==(const Matrix4x4 &n) const;
+    constexpr bool operator==(const Matrix4x4 &n) const;
 
     /**
      * Set the matrix to the values specified in the array.
      * @param  m  Array of float values to fill in this matrix. The
      *            elements are arranged in column order.
      */
-    void set(const float *m);
+    constexpr void set(const float *m);
 
     /**
      * Gets the matrix (can be passed to OpenGL - GLSL mat4)
      * @return   Returns the elements of this matrix in column order.
      */
-    const float *get() const;
+    constexpr const float *get() const;
 
     // Read-only access functions
-    float m00() const;
-    float m01() const;
-    float m02() const;
-    float m03() const;
-    float m10() const;
-    float m11() const;
-    float m12() const;
-    float m13() const;
-    float m20() const;
-    float m21() const;
-    float m22() const;
-    float m23() const;
-    float m30() const;
-    float m31() const;
-    float m32() const;
-    float m33() const;
+    constexpr float m00() const;
+    constexpr float m01() const;
+    constexpr float m02() const;
+    constexpr float m03() const;
+    constexpr float m10() const;
+    constexpr float m11() const;
+    constexpr float m12() const;
+    constexpr float m13() const;
+    constexpr float m20() const;
+    constexpr float m21() const;
+    constexpr float m22() const;
+    constexpr float m23() const;
+    constexpr float m30() const;
+    constexpr float m31() const;
+    constexpr float m32() const;
+    constexpr float m33() const;
 
     // Read-write access functions
-    float &m00();
-    float &m01();
-    float &m02();
-    float &m03();
-    float &m10();
-    float &m11();
-    float &m12();
-    float &m13();
-    float &m20();
-    float &m21();
-    float &m22();
-    float &m23();
-    float &m30();
-    float &m31();
-    float &m32();
-    float &m33();
+    constexpr float &m00();
+    constexpr float &m01();
+    constexpr float &m02();
+    constexpr float &m03();
+    constexpr float &m10();
+    constexpr float &m11();
+    constexpr float &m12();
+    constexpr float &m13();
+    constexpr float &m20();
+    constexpr float &m21();
+    constexpr float &m22();
+    constexpr float &m23();
+    constexpr float &m30();
+    constexpr float &m31();
+    constexpr float &m32();
+    constexpr float &m33();
 
     /**
      * Gets a matrix element given by row,column.
@@ -113,7 +130,7 @@ class Matrix4x4
      * @param  col   Matrix column
      * @return Returns the element at the specified row,col.
      */
-    float m(uint32_t row, uint32_t col) const;
+    constexpr float m(uint32_t row, uint32_t col) const;
 
     /**
      * Gets a matrix element given by row,column.
@@ -121,7 +138,7 @@ class Matrix4x4
      * @param  col   Matrix col (0-based)
      * @return Returns the address of the element at the specified row,col.
      */
-    float &m(uint32_t row, uint32_t col);
+    constexpr float &m(uint32_t row, uint32_t col);
 
     /**
      * Matrix multiplication.  Multiplies the current matrix by the matrix n
@@ -193,7 +210,8 @@ class Matrix4x4
 
     // The following convenience methods allow creation of a composite
     // modeling transfomation. Each method right-multiplies the curent
-    // matrix (similar to OpenGL)
+    // matrix (similar to OpenGL). Only the affected columns are updated
+    // in place; no temporary matrix or full multiply is used.
 
     /**
      * Applies a translation to the current transformation matrix.
@@ -207,7 +225,7 @@ class Matrix4x4
 
     /**
      * Applies a scaling to the current transformation matrix.
-     * Right-multiplies the current matrix.
+     * Right-multiplies the current matrix by scaling the first 3 columns.
      * @param	x	   x scaling
      * @param	y	   y scaling
      * @param	z	   z scaling
@@ -245,12 +263,140 @@ class Matrix4x4
      */
     void rotate_z(float angle);
 
+    /**
+     * Builds the composite T * R * S directly (translation, rotation, then
+     * scale as in successive translate, rotate and scale calls).
+     * @param   t   Translation.
+     * @param   r   Rotation matrix. Only the upper 3x3 is used.
+     * @param   s   Scale factors along x, y and z.
+     * @return  Returns the composite matrix.
+     */
+    static Matrix4x4 compose_trs(const Vector3 &t, const Matrix4x4 &r, const Vector3 &s);
+
+    // The following builders are constexpr so that fixed transforms can be
+    // computed at compile time, e.g.
+    //   constexpr Matrix4x4 M = Matrix4x4::product(Matrix4x4::make_translation(0, 0, 5),
+    //                                              Matrix4x4::make_rotation_z(45.0f));
+    // Trigonometry uses constexpr_math.hpp, so angles that are multiples of
+    // 90 degrees give exact results.
+
+    /**
+     * Builds a translation matrix.
+     * @param   x   x translation
+     * @param   y   y translation
+     * @param   z   z translation
+     * @return  Returns the translation matrix.
+     */
+    static constexpr Matrix4x4 make_translation(float x, float y, float z);
+
+    /**
+     * Builds a scaling matrix.
+     * @param   x   x scaling
+     * @param   y   y scaling
+     * @param   z   z scaling
+     * @return  Returns the scaling matrix.
+     */
+    static constexpr Matrix4x4 make_scale(float x, float y, float z);
+
+    /**
+     * Builds a counterclockwise rotation about the x axis.
+     * @param   angle    Angle (degrees) for the rotation.
+     * @return  Returns the rotation matrix.
+     */
+    static constexpr Matrix4x4 make_rotation_x(float angle);
+
+    /**
+     * Builds a counterclockwise rotation about the y axis.
+     * @param   angle    Angle (degrees) for the rotation.
+     * @return  Returns the rotation matrix.
+     */
+    static constexpr Matrix4x4 make_rotation_y(float angle);
+
+    /**
+     * Builds a counterclockwise rotation about the z axis.
+     * @param   angle    Angle (degrees) for the rotation.
+     * @return  Returns the rotation matrix.
+     */
+    static constexpr Matrix4x4 make_rotation_z(float angle);
+
+    /**
+     * Builds a counterclockwise rotation about a general axis.
+     * @param   angle    Angle (degrees) for the rotation.
+     * @param   x        x coordinate of the axis of rotation
+     * @param   y        y coordinate of the axis of rotation
+     * @param   z        z coordinate of the axis of rotation
+     * @return  Returns the rotation matrix (identity if the axis is 0).
+     */
+    static constexpr Matrix4x4 make_rotation(float angle, float x, float y, float z);
+
+    /**
+     * Builds a perspective projection matrix (as gluPerspective).
+     * @param   fov      Vertical field of view (degrees).
+     * @param   aspect   Aspect ratio (width / height).
+     * @param   z_near   Distance to the near clipping plane.
+     * @param   z_far    Distance to the far clipping plane.
+     * @return  Returns the projection matrix.
+     */
+    static constexpr Matrix4x4 make_perspective(float fov, float aspect, float z_near,
+                                                float z_far);
+
+    /**
+     * Builds a viewing matrix (as gluLookAt).
+     * @param   eye      Camera position.
+     * @param   center   Point the camera looks at.
+     * @param   up       Up direction.
+     * @return  Returns the viewing matrix.
+     */
+    static constexpr Matrix4x4 make_look_at(const Point3 &eye, const Point3 &center,
+                                            const Vector3 &up);
+
+    /**
+     * Multiplies matrices: a * b. Same result as operator* but usable in
+     * constant expressions.
+     * @param   a   Left matrix.
+     * @param   b   Right matrix.
+     * @return  Returns the product.
+     */
+    static constexpr Matrix4x4 product(const Matrix4x4 &a, const Matrix4x4 &b);
+
+    /**
+     * Multiplies 3 or more matrices left to right: ((a * b) * c) ...
+     * @param   a      First matrix.
+     * @param   b      Second matrix.
+     * @param   rest   Remaining matrices.
+     * @return  Returns the product.
+     */
+    template <typename... Rest>
+    static constexpr Matrix4x4 product(const Matrix4x4 &a, const Matrix4x4 &b,
+                                       const Matrix4x4 &c, const Rest &...rest)
+    {
+        return product(product(a, b), c, rest...);
+    }
+
+    /**
+     * Classifies the matrix as rigid, affine or general. The orthonormal
+     * test for rigid matrices allows a small tolerance for round off.
+     * @return  Returns the matrix type.
+     */
+    MatrixType classify() const;
+
     /**
      * Calculates the inverse of the current 4x4 matrix and returns it.
+     * Rigid and affine matrices are inverted in closed form. Other matrices
+     * use Gauss-Jordan elimination with partial pivoting.
      * @return  Returns the inverse of the current matrix.
      */
     Matrix4x4 get_inverse() const;
 
+    /**
+     * Calculates the inverse of the current 4x4 matrix when the caller
+     * already knows its type, skipping classification. Passing a type that
+     * the matrix does not satisfy gives an incorrect result.
+     * @param   type  Type of the matrix.
+     * @return  Returns the inverse of the current matrix.
+     */
+    Matrix4x4 get_inverse(MatrixType type) const;
+
     /**
      * Logs a message followed by the matrix.
      * @param   str   String to print to log file
@@ -260,8 +406,249 @@ class Matrix4x4
   private:
     // Elements of the matrix. Column order.
     std::array<float, 16> a_;
+
+    // Right-multiplies by a rotation in the plane of axes i and j
+    void rotate_columns(int32_t i, int32_t j, float c, float s);
+
+    Matrix4x4 get_rigid_inverse() const;
+    Matrix4x4 get_affine_inverse() const;
+    Matrix4x4 get_general_inverse() const;
 };
 
+static_assert(sizeof(Matrix4x4) == 16 * sizeof(float), "Matrix4x4 must be tightly packed");
+static_assert(std::is_trivially_copyable<Matrix4x4>::value, "Matrix4x4 must be trivially copyable");
+
+/**
+ * Inverts an array of matrices. Each matrix is classified and inverted
+ * with the cheapest applicable method.
+ * @param  in     Input matrices.
+ * @param  out    Output inverses. May be the same array as in.
+ * @param  count  Number of matrices.
+ */
+void invert_matrices(const Matrix4x4 *in, Matrix4x4 *out, size_t count);
+
+// Inline definitions
+
+constexpr Matrix4x4::Matrix4x4() : a_{} { set_identity(); }
+
+constexpr void Matrix4x4::set_identity()
+{
+    a_[0] = 1.0f;
+    a_[4] = 0.0f;
+    a_[8] = 0.0f;
+    a_[12] = 0.0f;
+    a_[1] = 0.0f;
+    a_[5] = 1.0f;
+    a_[9] = 0.0f;
+    a_[13] = 0.0f;
+    a_[2] = 0.0f;
+    a_[6] = 0.0f;
+    a_[10] = 1.0f;
+    a_[14] = 0.0f;
+    a_[3] = 0.0f;
+    a_[7] = 0.0f;
+    a_[11] = 0.0f;
+    a_[15] = 1.0f;
+}
+
+constexpr bool Matrix4x4::operator==(const Matrix4x4 &n) const
+{
+    return (m00() == n.m00() && m01() == n.m01() && m02() == n.m02() && m03() == n.m03() &&
+            m10() == n.m10() && m11() == n.m11() && m12() == n.m12() && m13() == n.m13() &&
+            m20() == n.m20() && m21() == n.m21() && m22() == n.m22() && m23() == n.m23() &&
+            m30() == n.m30() && m31() == n.m31() && m32() == n.m32() && m33() == n.m33());
+}
+
+constexpr void Matrix4x4::set(const float *m)
+{
+    for(size_t i = 0; i < 16; i++) a_[i] = m[i];
+}
+
+constexpr const float *Matrix4x4::get() const { return a_.data(); }
+
+// Read-only access functions
+constexpr float Matrix4x4::m00() const { return a_[0]; }
+constexpr float Matrix4x4::m01() const { return a_[4]; }
+constexpr float Matrix4x4::m02() const { return a_[8]; }
+constexpr float Matrix4x4::m03() const { return a_[12]; }
+constexpr float Matrix4x4::m10() const { return a_[1]; }
+constexpr float Matrix4x4::m11() const { return a_[5]; }
+constexpr float Matrix4x4::m12() const { return a_[9]; }
+constexpr float Matrix4x4::m13() const { return a_[13]; }
+constexpr float Matrix4x4::m20() const { return a_[2]; }
+constexpr float Matrix4x4::m21() const { return a_[6]; }
+constexpr float Matrix4x4::m22() const { return a_[10]; }
+constexpr float Matrix4x4::m23() const { return a_[14]; }
+constexpr float Matrix4x4::m30() const { return a_[3]; }
+constexpr float Matrix4x4::m31() const { return a_[7]; }
+constexpr float Matrix4x4::m32() const { return a_[11]; }
+constexpr float Matrix4x4::m33() const { return a_[15]; }
+
+// Read-write access functions
+constexpr float &Matrix4x4::m00() { return a_[0]; }
+constexpr float &Matrix4x4::m01() { return a_[4]; }
+constexpr float &Matrix4x4::m02() { return a_[8]; }
+constexpr float &Matrix4x4::m03() { return a_[12]; }
+constexpr float &Matrix4x4::m10() { return a_[1]; }
+constexpr float &Matrix4x4::m11() { return a_[5]; }
+constexpr float &Matrix4x4::m12() { return a_[9]; }
+constexpr float &Matrix4x4::m13() { return a_[13]; }
+constexpr float &Matrix4x4::m20() { return a_[2]; }
+constexpr float &Matrix4x4::m21() { return a_[6]; }
+constexpr float &Matrix4x4::m22() { return a_[10]; }
+constexpr float &Matrix4x4::m23() { return a_[14]; }
+constexpr float &Matrix4x4::m30() { return a_[3]; }
+constexpr float &Matrix4x4::m31() { return a_[7]; }
+constexpr float &Matrix4x4::m32() { return a_[11]; }
+constexpr float &Matrix4x4::m33() { return a_[15]; }
+
+constexpr float Matrix4x4::m(uint32_t row, uint32_t col) const
+{
+    return (row < 4 && col < 4) ? a_[col * 4 + row] : 0.0f;
+}
+
+constexpr float &Matrix4x4::m(uint32_t row, uint32_t col)
+{
+    return (row < 4 && col < 4) ? a_[col * 4 + row] : a_[0];
+}
+
+constexpr Matrix4x4 Matrix4x4::make_translation(float x, float y, float z)
+{
+    Matrix4x4 m;
+    m.a_[12] = x;
+    m.a_[13] = y;
+    m.a_[14] = z;
+    return m;
+}
+
+constexpr Matrix4x4 Matrix4x4::make_scale(float x, float y, float z)
+{
+    Matrix4x4 m;
+    m.a_[0] = x;
+    m.a_[5] = y;
+    m.a_[10] = z;
+    return m;
+}
+
+constexpr Matrix4x4 Matrix4x4::make_rotation_x(float angle)
+{
+    float     c = static_cast<float>(constexpr_cos_deg(angle));
+    float     s = static_cast<float>(constexpr_sin_deg(angle));
+    Matrix4x4 m;
+    m.a_[5] = c;
+    m.a_[6] = s;
+    m.a_[9] = -s;
+    m.a_[10] = c;
+    return m;
+}
+
+constexpr Matrix4x4 Matrix4x4::make_rotation_y(float angle)
+{
+    float     c = static_cast<float>(constexpr_cos_deg(angle));
+    float     s = static_cast<float>(constexpr_sin_deg(angle));
+    Matrix4x4 m;
+    m.a_[0] = c;
+    m.a_[2] = -s;
+    m.a_[8] = s;
+    m.a_[10] = c;
+    return m;
+}
+
+constexpr Matrix4x4 Matrix4x4::make_rotation_z(float angle)
+{
+    float     c = static_cast<float>(constexpr_cos_deg(angle));
+    float     s = static_cast<float>(constexpr_sin_deg(angle));
+    Matrix4x4 m;
+    m.a_[0] = c;
+    m.a_[1] = s;
+    m.a_[4] = -s;
+    m.a_[5] = c;
+    return m;
+}
+
+constexpr Matrix4x4 Matrix4x4::make_rotation(float angle, float x, float y, float z)
+{
+    Matrix4x4 m;
+    float     length = static_cast<float>(constexpr_sqrt(x * x + y * y + z * z));
+    if(length == 0.0f) return m; // Invalid axis
+
+    x /= length;
+    y /= length;
+    z /= length;
+    float c = static_cast<float>(constexpr_cos_deg(angle));
+    float s = static_cast<float>(constexpr_sin_deg(angle));
+    float one_minus_c = 1.0f - c;
+
+    // Same axis-angle matrix as rotate(), stored in column order
+    m.a_[0] = c + x * x * one_minus_c;
+    m.a_[1] = y * x * one_minus_c + z * s;
+    m.a_[2] = z * x * one_minus_c - y * s;
+    m.a_[4] = x * y * one_minus_c - z * s;
+    m.a_[5] = c + y * y * one_minus_c;
+    m.a_[6] = z * y * one_minus_c + x * s;
+    m.a_[8] = x * z * one_minus_c + y * s;
+    m.a_[9] = y * z * one_minus_c - x * s;
+    m.a_[10] = c + z * z * one_minus_c;
+    return m;
+}
+
+constexpr Matrix4x4 Matrix4x4::make_perspective(float fov, float aspect, float z_near,
+                                                float z_far)
+{
+    float     f = static_cast<float>(1.0 / constexpr_tan_deg(0.5 * static_cast<double>(fov)));
+    Matrix4x4 m;
+    m.a_[0] = f / aspect;
+    m.a_[5] = f;
+    m.a_[10] = (z_far + z_near) / (z_near - z_far);
+    m.a_[11] = -1.0f;
+    m.a_[14] = (2.0f * z_far * z_near) / (z_near - z_far);
+    m.a_[15] = 0.0f;
+    return m;
+}
+
+constexpr Matrix4x4 Matrix4x4::make_look_at(const Point3 &eye, const Point3 &center,
+                                            const Vector3 &up)
+{
+    // Forward, side and (corrected) up axes of the camera
+    Vector3 f(eye, center);
+    f *= static_cast<float>(1.0 / constexpr_sqrt(f.norm_squared()));
+    Vector3 s = f.cross(up);
+    s *= static_cast<float>(1.0 / constexpr_sqrt(s.norm_squared()));
+    Vector3 u = s.cross(f);
+
+    // Rows are s, u, -f, with the eye moved to the origin
+    Vector3   e(eye);
+    Matrix4x4 m;
+    m.a_[0] = s.x;
+    m.a_[4] = s.y;
+    m.a_[8] = s.z;
+    m.a_[12] = -s.dot(e);
+    m.a_[1] = u.x;
+    m.a_[5] = u.y;
+    m.a_[9] = u.z;
+    m.a_[13] = -u.dot(e);
+    m.a_[2] = -f.x;
+    m.a_[6] = -f.y;
+    m.a_[10] = -f.z;
+    m.a_[14] = f.dot(e);
+    return m;
+}
+
+constexpr Matrix4x4 Matrix4x4::product(const Matrix4x4 &a, const Matrix4x4 &b)
+{
+    // Same summation order as the matrix kernels
+    Matrix4x4 m;
+    for(int32_t c = 0; c < 4; c++)
+    {
+        for(int32_t r = 0; r < 4; r++)
+        {
+            m.a_[c * 4 + r] = a.a_[r] * b.a_[c * 4] + a.a_[4 + r] * b.a_[c * 4 + 1] +
+                              a.a_[8 + r] * b.a_[c * 4 + 2] + a.a_[12 + r] * b.a_[c * 4 + 3];
+        }
+    }
+    return m;
+}
+
 } // namespace cg
 
 #endif
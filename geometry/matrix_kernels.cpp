@@ -0,0 +1,225 @@
+#include "geometry/matrix_kernels.hpp"
+
+#if defined(CG_SIMD_X86)
+#include <immintrin.h>
+#endif
+
+namespace cg
+{
+
+namespace
+{
+
+// ---------------------------- Scalar kernels ----------------------------- //
+
+void multiply_scalar(const float *a, const float *b, float *out)
+{
+    // Accumulate into a temporary so out may alias a or b
+    float t[16];
+    for(int c = 0; c < 4; c++)
+    {
+        const float *bc = b + c * 4;
+        for(int r = 0; r < 4; r++)
+        {
+            t[c * 4 + r] = a[r] * bc[0] + a[4 + r] * bc[1] + a[8 + r] * bc[2] + a[12 + r] * bc[3];
+        }
+    }
+    for(int i = 0; i < 16; i++) out[i] = t[i];
+}
+
+void transform_hpoint_scalar(const float *m, const float *v, float *out)
+{
+    float x = v[0], y = v[1], z = v[2], w = v[3];
+    out[0] = m[0] * x + m[4] * y + m[8] * z + m[12] * w;
+    out[1] = m[1] * x + m[5] * y + m[9] * z + m[13] * w;
+    out[2] = m[2] * x + m[6] * y + m[10] * z + m[14] * w;
+    out[3] = m[3] * x + m[7] * y + m[11] * z + m[15] * w;
+}
+
+void transform_point_scalar(const float *m, const float *v, float *out)
+{
+    float x = v[0], y = v[1], z = v[2];
+    out[0] = m[0] * x + m[4] * y + m[8] * z + m[12];
+    out[1] = m[1] * x + m[5] * y + m[9] * z + m[13];
+    out[2] = m[2] * x + m[6] * y + m[10] * z + m[14];
+    out[3] = m[3] * x + m[7] * y + m[11] * z + m[15];
+}
+
+void transform_vector_scalar(const float *m, const float *v, float *out)
+{
+    float x = v[0], y = v[1], z = v[2];
+    out[0] = m[0] * x + m[4] * y + m[8] * z;
+    out[1] = m[1] * x + m[5] * y + m[9] * z;
+    out[2] = m[2] * x + m[6] * y + m[10] * z;
+}
+
+void transpose_scalar(const float *m, float *out)
+{
+    float t[16];
+    for(int c = 0; c < 4; c++)
+    {
+        for(int r = 0; r < 4; r++) t[r * 4 + c] = m[c * 4 + r];
+    }
+    for(int i = 0; i < 16; i++) out[i] = t[i];
+}
+
+#if defined(CG_SIMD_X86)
+
+// ----------------------------- SSE4.1 kernels ---------------------------- //
+
+// Each output column is a linear combination of the columns of a, weighted
+// by the elements of the matching column of b. Summation order matches the
+// scalar kernel so results are bit-identical.
+CG_TARGET_SSE41 void multiply_sse41(const float *a, const float *b, float *out)
+{
+    __m128 a0 = _mm_loadu_ps(a);
+    __m128 a1 = _mm_loadu_ps(a + 4);
+    __m128 a2 = _mm_loadu_ps(a + 8);
+    __m128 a3 = _mm_loadu_ps(a + 12);
+    for(int c = 0; c < 4; c++)
+    {
+        __m128 bc = _mm_loadu_ps(b + c * 4);
+        __m128 r = _mm_mul_ps(a0, _mm_shuffle_ps(bc, bc, _MM_SHUFFLE(0, 0, 0, 0)));
+        r = _mm_add_ps(r, _mm_mul_ps(a1, _mm_shuffle_ps(bc, bc, _MM_SHUFFLE(1, 1, 1, 1))));
+        r = _mm_add_ps(r, _mm_mul_ps(a2, _mm_shuffle_ps(bc, bc, _MM_SHUFFLE(2, 2, 2, 2))));
+        r = _mm_add_ps(r, _mm_mul_ps(a3, _mm_shuffle_ps(bc, bc, _MM_SHUFFLE(3, 3, 3, 3))));
+        _mm_storeu_ps(out + c * 4, r);
+    }
+}
+
+CG_TARGET_SSE41 void transform_hpoint_sse41(const float *m, const float *v, float *out)
+{
+    __m128 p = _mm_loadu_ps(v);
+    __m128 x = _mm_shuffle_ps(p, p, _MM_SHUFFLE(0, 0, 0, 0));
+    __m128 y = _mm_shuffle_ps(p, p, _MM_SHUFFLE(1, 1, 1, 1));
+    __m128 z = _mm_shuffle_ps(p, p, _MM_SHUFFLE(2, 2, 2, 2));
+    __m128 w = _mm_shuffle_ps(p, p, _MM_SHUFFLE(3, 3, 3, 3));
+    __m128 r = _mm_mul_ps(_mm_loadu_ps(m), x);
+    r = _mm_add_ps(r, _mm_mul_ps(_mm_loadu_ps(m + 4), y));
+    r = _mm_add_ps(r, _mm_mul_ps(_mm_loadu_ps(m + 8), z));
+    r = _mm_add_ps(r, _mm_mul_ps(_mm_loadu_ps(m + 12), w));
+    _mm_storeu_ps(out, r);
+}
+
+// Loads x,y,z without reading past the end of a 3 float array
+CG_TARGET_SSE41 inline __m128 load_xyz(const float *v)
+{
+    __m128 xy = _mm_loadl_pi(_mm_setzero_ps(), reinterpret_cast<const __m64 *>(v));
+    return _mm_insert_ps(xy, _mm_load_ss(v + 2), 0x20);
+}
+
+CG_TARGET_SSE41 void transform_point_sse41(const float *m, const float *v, float *out)
+{
+    __m128 p = load_xyz(v);
+    __m128 x = _mm_shuffle_ps(p, p, _MM_SHUFFLE(0, 0, 0, 0));
+    __m128 y = _mm_shuffle_ps(p, p, _MM_SHUFFLE(1, 1, 1, 1));
+    __m128 z = _mm_shuffle_ps(p, p, _MM_SHUFFLE(2, 2, 2, 2));
+    __m128 r = _mm_mul_ps(_mm_loadu_ps(m), x);
+    r = _mm_add_ps(r, _mm_mul_ps(_mm_loadu_ps(m + 4), y));
+    r = _mm_add_ps(r, _mm_mul_ps(_mm_loadu_ps(m + 8), z));
+    r = _mm_add_ps(r, _mm_loadu_ps(m + 12));
+    _mm_storeu_ps(out, r);
+}
+
+CG_TARGET_SSE41 void transform_vector_sse41(const float *m, const float *v, float *out)
+{
+    __m128 p = load_xyz(v);
+    __m128 x = _mm_shuffle_ps(p, p, _MM_SHUFFLE(0, 0, 0, 0));
+    __m128 y = _mm_shuffle_ps(p, p, _MM_SHUFFLE(1, 1, 1, 1));
+    __m128 z = _mm_shuffle_ps(p, p, _MM_SHUFFLE(2, 2, 2, 2));
+    __m128 r = _mm_mul_ps(_mm_loadu_ps(m), x);
+    r = _mm_add_ps(r, _mm_mul_ps(_mm_loadu_ps(m + 4), y));
+    r = _mm_add_ps(r, _mm_mul_ps(_mm_loadu_ps(m + 8), z));
+
+    // Store x,y,z only (the output is a 3 float array)
+    _mm_storel_pi(reinterpret_cast<__m64 *>(out), r);
+    _MM_EXTRACT_FLOAT(out[2], r, 2);
+}
+
+CG_TARGET_SSE41 void transpose_sse41(const float *m, float *out)
+{
+    __m128 c0 = _mm_loadu_ps(m);
+    __m128 c1 = _mm_loadu_ps(m + 4);
+    __m128 c2 = _mm_loadu_ps(m + 8);
+    __m128 c3 = _mm_loadu_ps(m + 12);
+    _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+    _mm_storeu_ps(out, c0);
+    _mm_storeu_ps(out + 4, c1);
+    _mm_storeu_ps(out + 8, c2);
+    _mm_storeu_ps(out + 12, c3);
+}
+
+// ------------------------------ AVX2 kernels ----------------------------- //
+
+// Computes 2 output columns per iteration. Each 256 bit register holds a
+// column of a duplicated in both 128 bit lanes; the in-lane shuffle of b
+// broadcasts element k of output column c (low lane) and c+1 (high lane).
+// Multiply and add are kept separate (no FMA) so results stay bit-identical
+// to the scalar kernel on every CPU.
+CG_TARGET_AVX2 void multiply_avx2(const float *a, const float *b, float *out)
+{
+    __m256 a0 = _mm256_broadcast_ps(reinterpret_cast<const __m128 *>(a));
+    __m256 a1 = _mm256_broadcast_ps(reinterpret_cast<const __m128 *>(a + 4));
+    __m256 a2 = _mm256_broadcast_ps(reinterpret_cast<const __m128 *>(a + 8));
+    __m256 a3 = _mm256_broadcast_ps(reinterpret_cast<const __m128 *>(a + 12));
+    for(int c = 0; c < 4; c += 2)
+    {
+        __m256 bc = _mm256_loadu_ps(b + c * 4);
+        __m256 r = _mm256_mul_ps(a0, _mm256_shuffle_ps(bc, bc, _MM_SHUFFLE(0, 0, 0, 0)));
+        r = _mm256_add_ps(r, _mm256_mul_ps(a1, _mm256_shuffle_ps(bc, bc, _MM_SHUFFLE(1, 1, 1, 1))));
+        r = _mm256_add_ps(r, _mm256_mul_ps(a2, _mm256_shuffle_ps(bc, bc, _MM_SHUFFLE(2, 2, 2, 2))));
+        r = _mm256_add_ps(r, _mm256_mul_ps(a3, _mm256_shuffle_ps(bc, bc, _MM_SHUFFLE(3, 3, 3, 3))));
+        _mm256_storeu_ps(out + c * 4, r);
+    }
+}
+
+#endif
+
+const MatrixKernels SCALAR_KERNELS = {SimdLevel::SCALAR,
+                                      multiply_scalar,
+                                      transform_hpoint_scalar,
+                                      transform_point_scalar,
+                                      transform_vector_scalar,
+                                      transpose_scalar};
+
+#if defined(CG_SIMD_X86)
+const MatrixKernels SSE41_KERNELS = {SimdLevel::SSE41,
+                                     multiply_sse41,
+                                     transform_hpoint_sse41,
+                                     transform_point_sse41,
+                                     transform_vector_sse41,
+                                     transpose_sse41};
+
+// A single point or vector fills only one 128 bit register, so the AVX2
+// set reuses the SSE4.1 transform and transpose kernels.
+const MatrixKernels AVX2_KERNELS = {SimdLevel::AVX2,
+                                    multiply_avx2,
+                                    transform_hpoint_sse41,
+                                    transform_point_sse41,
+                                    transform_vector_sse41,
+                                    transpose_sse41};
+#endif
+
+} // namespace
+
+const MatrixKernels &matrix_kernels()
+{
+    static const MatrixKernels &kernels = *matrix_kernels(best_simd_level());
+    return kernels;
+}
+
+const MatrixKernels *matrix_kernels(SimdLevel level)
+{
+    if(!is_simd_level_supported(level)) return nullptr;
+    switch(level)
+    {
+#if defined(CG_SIMD_X86)
+        case SimdLevel::AVX2: return &AVX2_KERNELS;
+        case SimdLevel::SSE41: return &SSE41_KERNELS;
+#endif
+        case SimdLevel::SCALAR: return &SCALAR_KERNELS;
+        default: return nullptr;
+    }
+}
+
+} // namespace cg
@@ -0,0 +1,63 @@
+//============================================================================
+//	Johns Hopkins University Engineering for Professionals
+//	605.667 Computer Graphics and 605.767 Applied Computer Graphics
+//	Instructor:	Brian Russin
+//
+//	Author:  Kyle Meyer
+//	File:    matrix_kernels.hpp
+//	Purpose: Scalar and SIMD kernels for 4x4 matrix operations. The best
+//           kernel set for the host CPU is selected at startup.
+//============================================================================
+
+#ifndef __GEOMETRY_MATRIX_KERNELS_HPP__
+#define __GEOMETRY_MATRIX_KERNELS_HPP__
+
+#include "geometry/cpu_features.hpp"
+
+namespace cg
+{
+
+/**
+ * Set of 4x4 matrix kernels for one SIMD level. All matrices are 16 floats
+ * in column order (the layout used by Matrix4x4 and OpenGL). Output arrays
+ * may alias the input arrays.
+ */
+struct MatrixKernels
+{
+    SimdLevel level;
+
+    // out = a * b
+    void (*multiply)(const float *a, const float *b, float *out);
+
+    // out (x,y,z,w) = m * v (x,y,z,w)
+    void (*transform_hpoint)(const float *m, const float *v, float *out);
+
+    // out (x,y,z,w) = m * v (x,y,z,1)
+    void (*transform_point)(const float *m, const float *v, float *out);
+
+    // out (x,y,z) = upper 3x3 of m * v (x,y,z)
+    void (*transform_vector)(const float *m, const float *v, float *out);
+
+    // out = transpose of m
+    void (*transpose)(const float *m, float *out);
+};
+
+/**
+ * Gets the kernels selected for the host CPU (highest supported SIMD level).
+ * Selection happens once, on the first call.
+ * @return  Returns the active matrix kernels.
+ */
+const MatrixKernels &matrix_kernels();
+
+/**
+ * Gets the kernels for a specific SIMD level. Used for benchmarking and to
+ * verify SIMD results against the scalar kernels.
+ * @param  level  SIMD level.
+ * @return  Returns the kernels or nullptr if the level is not supported by
+ *          the host CPU.
+ */
+const MatrixKernels *matrix_kernels(SimdLevel level);
+
+} // namespace cg
+
+#endif
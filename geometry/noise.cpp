@@ -1,24 +1,282 @@
 #include "geometry/noise.hpp"
 
 #include "geometry/geometry.hpp"
+#include "geometry/parallel.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define CG_NOISE_SSE2 1
+#endif
 
 namespace cg
 {
 
-// NOTE - not required until 605.767!
+namespace
+{
+
+// Seed for the default constructor
+constexpr uint32_t DEFAULT_SEED = 1;
+
+// Bake grids with fewer samples than this on the calling thread
+constexpr size_t PARALLEL_MIN_SAMPLES = 65536;
+
+// Samples per tile when baking (kept in cache while noise is evaluated)
+constexpr size_t TILE_SAMPLES = 4096;
+
+// Quintic fade 6t^5 - 15t^4 + 10t^3
+float fade(float t) { return t * t * t * (t * (t * 6.0f - 15.0f) + 10.0f); }
+
+float lerp(float t, float a, float b) { return a + t * (b - a); }
+
+// Dot product of (x, y, z) with one of 12 edge gradients (Perlin 2002)
+float grad(uint32_t hash, float x, float y, float z)
+{
+    uint32_t h = hash & 15;
+    float    u = (h < 8) ? x : y;
+    float    v = (h < 4) ? y : ((h == 12 || h == 14) ? x : z);
+    return ((h & 1) ? -u : u) + ((h & 2) ? -v : v);
+}
+
+// Maps signed gradient noise to [0, 1]
+float to_unit(float g) { return std::min(1.0f, std::max(0.0f, 0.5f * (g + 1.0f))); }
+
+#if defined(CG_NOISE_SSE2)
+
+// SSE2 versions of the helpers above; same operations in the same order
+// so results match the scalar path exactly
+
+__m128 fade4(__m128 t)
+{
+    __m128 r = _mm_sub_ps(_mm_mul_ps(t, _mm_set1_ps(6.0f)), _mm_set1_ps(15.0f));
+    r = _mm_add_ps(_mm_mul_ps(t, r), _mm_set1_ps(10.0f));
+    return _mm_mul_ps(_mm_mul_ps(_mm_mul_ps(t, t), t), r);
+}
+
+__m128 lerp4(__m128 t, __m128 a, __m128 b)
+{
+    return _mm_add_ps(a, _mm_mul_ps(t, _mm_sub_ps(b, a)));
+}
+
+__m128 blend4(__m128 mask, __m128 a, __m128 b)
+{
+    return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+
+__m128 grad4(__m128i hash, __m128 x, __m128 y, __m128 z)
+{
+    __m128i h = _mm_and_si128(hash, _mm_set1_epi32(15));
+    __m128  lt8 = _mm_castsi128_ps(_mm_cmplt_epi32(h, _mm_set1_epi32(8)));
+    __m128  lt4 = _mm_castsi128_ps(_mm_cmplt_epi32(h, _mm_set1_epi32(4)));
+    __m128  use_x = _mm_castsi128_ps(_mm_or_si128(_mm_cmpeq_epi32(h, _mm_set1_epi32(12)),
+                                                  _mm_cmpeq_epi32(h, _mm_set1_epi32(14))));
+    __m128  u = blend4(lt8, x, y);
+    __m128  v = blend4(lt4, y, blend4(use_x, x, z));
+
+    // Negate by flipping the sign bit, as scalar unary minus does
+    __m128 u_sign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(h, _mm_set1_epi32(1)), 31));
+    __m128 v_sign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(h, _mm_set1_epi32(2)), 30));
+    return _mm_add_ps(_mm_xor_ps(u, u_sign), _mm_xor_ps(v, v_sign));
+}
+
+// Floor for |x| < 2^31 (SSE2 has no round instruction)
+__m128 floor4(__m128 x)
+{
+    __m128 t = _mm_cvtepi32_ps(_mm_cvttps_epi32(x));
+    return _mm_sub_ps(t, _mm_and_ps(_mm_cmpgt_ps(t, x), _mm_set1_ps(1.0f)));
+}
+
+#endif
+
+} // namespace
+
+Noise::Noise() : Noise(DEFAULT_SEED) {}
+
+Noise::Noise(uint32_t seed, uint32_t octaves) : octaves_(std::max(1u, octaves))
+{
+    std::array<uint8_t, 256> p;
+    std::iota(p.begin(), p.end(), static_cast<uint8_t>(0));
+    std::mt19937 rng(seed);
+    std::shuffle(p.begin(), p.end(), rng);
+    for(size_t i = 0; i < perm_.size(); i++) perm_[i] = p[i & 255];
+}
+
+float Noise::noise(const Point3 &p, float scale) const { return to_unit(gradient_noise(p, scale)); }
+
+float Noise::turbulence(float scale, const Point3 &p) const
+{
+    float sum = 0.0f, total = 0.0f, amplitude = 1.0f;
+    for(uint32_t k = 0; k < octaves_; k++)
+    {
+        sum += std::abs(gradient_noise(p, scale)) * amplitude;
+        total += amplitude;
+        amplitude *= 0.5f;
+        scale *= 2.0f;
+    }
+    return std::min(1.0f, sum / total);
+}
 
-Noise::Noise() {}
+void Noise::noise(const Point3 *points, size_t count, float scale, float *out) const
+{
+    gradient_noise(points, count, scale, out);
+    for(size_t i = 0; i < count; i++) out[i] = to_unit(out[i]);
+}
 
-float Noise::noise(const Point3 &p, float scale)
+void Noise::turbulence(float scale, const Point3 *points, size_t count, float *out) const
 {
-    // Complete in 605.767
-    return 1.0f;
+    // Octaves are evaluated a block at a time so the scratch stays in cache
+    constexpr size_t BLOCK = 1024;
+    float            octave[BLOCK];
+    for(size_t first = 0; first < count; first += BLOCK)
+    {
+        size_t n = std::min(BLOCK, count - first);
+        float *sum = out + first;
+        std::fill(sum, sum + n, 0.0f);
+        float total = 0.0f, amplitude = 1.0f, s = scale;
+        for(uint32_t k = 0; k < octaves_; k++)
+        {
+            gradient_noise(points + first, n, s, octave);
+            for(size_t i = 0; i < n; i++) sum[i] += std::abs(octave[i]) * amplitude;
+            total += amplitude;
+            amplitude *= 0.5f;
+            s *= 2.0f;
+        }
+        for(size_t i = 0; i < n; i++) sum[i] = std::min(1.0f, sum[i] / total);
+    }
 }
 
-float Noise::turbulence(float scale, const Point3 &p)
+void Noise::bake(NoiseType      type,
+                 float          scale,
+                 const Point3  &origin,
+                 const Vector3 &spacing,
+                 uint32_t       nx,
+                 uint32_t       ny,
+                 uint32_t       nz,
+                 float         *out,
+                 uint32_t       thread_count) const
 {
-    // Complete in 605.767
-    return 1.0f;
+    if(nx == 0) return;
+    size_t rows = static_cast<size_t>(ny) * nz;
+    size_t tile_rows = std::max<size_t>(1, TILE_SAMPLES / nx);
+    size_t min_rows = std::max<size_t>(1, PARALLEL_MIN_SAMPLES / nx);
+    parallel_for(rows, thread_count, min_rows, [&](size_t first, size_t last) {
+        std::vector<Point3> positions(std::min(last - first, tile_rows) * nx);
+        for(size_t row = first; row < last; row += tile_rows)
+        {
+            size_t row_end = std::min(last, row + tile_rows);
+            size_t n = 0;
+            for(size_t r = row; r < row_end; r++)
+            {
+                float y = origin.y + spacing.y * static_cast<float>(r % ny);
+                float z = origin.z + spacing.z * static_cast<float>(r / ny);
+                for(uint32_t i = 0; i < nx; i++)
+                {
+                    positions[n++].set(origin.x + spacing.x * static_cast<float>(i), y, z);
+                }
+            }
+            float *dst = out + row * nx;
+            if(type == NoiseType::TURBULENCE)
+                turbulence(scale, positions.data(), n, dst);
+            else
+                noise(positions.data(), n, scale, dst);
+        }
+    });
+}
+
+float Noise::gradient_noise(const Point3 &p, float scale) const
+{
+    float x = p.x * scale, y = p.y * scale, z = p.z * scale;
+    float fx = std::floor(x), fy = std::floor(y), fz = std::floor(z);
+    x -= fx;
+    y -= fy;
+    z -= fz;
+
+    // Hash the 8 lattice corners
+    uint32_t xi = static_cast<uint32_t>(static_cast<int32_t>(fx)) & 255;
+    uint32_t yi = static_cast<uint32_t>(static_cast<int32_t>(fy)) & 255;
+    uint32_t zi = static_cast<uint32_t>(static_cast<int32_t>(fz)) & 255;
+    uint32_t a = perm_[xi] + yi, aa = perm_[a] + zi, ab = perm_[a + 1] + zi;
+    uint32_t b = perm_[xi + 1] + yi, ba = perm_[b] + zi, bb = perm_[b + 1] + zi;
+
+    float u = fade(x), v = fade(y), w = fade(z);
+    float y1 = lerp(v,
+                    lerp(u, grad(perm_[aa], x, y, z), grad(perm_[ba], x - 1.0f, y, z)),
+                    lerp(u,
+                         grad(perm_[ab], x, y - 1.0f, z),
+                         grad(perm_[bb], x - 1.0f, y - 1.0f, z)));
+    float y2 = lerp(v,
+                    lerp(u,
+                         grad(perm_[aa + 1], x, y, z - 1.0f),
+                         grad(perm_[ba + 1], x - 1.0f, y, z - 1.0f)),
+                    lerp(u,
+                         grad(perm_[ab + 1], x, y - 1.0f, z - 1.0f),
+                         grad(perm_[bb + 1], x - 1.0f, y - 1.0f, z - 1.0f)));
+    return lerp(w, y1, y2);
+}
+
+void Noise::gradient_noise(const Point3 *points, size_t count, float scale, float *out) const
+{
+    size_t done = 0;
+#if defined(CG_NOISE_SSE2)
+    // 4 positions per step. Only the permutation lookups are scalar (SSE2
+    // has no gather); the fade, gradient and interpolation math is SIMD.
+    const __m128 s = _mm_set1_ps(scale);
+    const __m128 one = _mm_set1_ps(1.0f);
+    for(; done + 4 <= count; done += 4)
+    {
+        const Point3 *p = points + done;
+        __m128        x = _mm_mul_ps(_mm_setr_ps(p[0].x, p[1].x, p[2].x, p[3].x), s);
+        __m128        y = _mm_mul_ps(_mm_setr_ps(p[0].y, p[1].y, p[2].y, p[3].y), s);
+        __m128        z = _mm_mul_ps(_mm_setr_ps(p[0].z, p[1].z, p[2].z, p[3].z), s);
+        __m128        fx = floor4(x), fy = floor4(y), fz = floor4(z);
+        x = _mm_sub_ps(x, fx);
+        y = _mm_sub_ps(y, fy);
+        z = _mm_sub_ps(z, fz);
+
+        const __m128i mask = _mm_set1_epi32(255);
+        alignas(16) uint32_t xi[4], yi[4], zi[4];
+        _mm_store_si128(reinterpret_cast<__m128i *>(xi),
+                        _mm_and_si128(_mm_cvttps_epi32(fx), mask));
+        _mm_store_si128(reinterpret_cast<__m128i *>(yi),
+                        _mm_and_si128(_mm_cvttps_epi32(fy), mask));
+        _mm_store_si128(reinterpret_cast<__m128i *>(zi),
+                        _mm_and_si128(_mm_cvttps_epi32(fz), mask));
+        alignas(16) uint32_t h[8][4];
+        for(int32_t i = 0; i < 4; i++)
+        {
+            uint32_t a = perm_[xi[i]] + yi[i], aa = perm_[a] + zi[i], ab = perm_[a + 1] + zi[i];
+            uint32_t b = perm_[xi[i] + 1] + yi[i], ba = perm_[b] + zi[i],
+                     bb = perm_[b + 1] + zi[i];
+            h[0][i] = perm_[aa];
+            h[1][i] = perm_[ba];
+            h[2][i] = perm_[ab];
+            h[3][i] = perm_[bb];
+            h[4][i] = perm_[aa + 1];
+            h[5][i] = perm_[ba + 1];
+            h[6][i] = perm_[ab + 1];
+            h[7][i] = perm_[bb + 1];
+        }
+        auto hash = [&](int32_t corner) {
+            return _mm_load_si128(reinterpret_cast<const __m128i *>(h[corner]));
+        };
+
+        __m128 u = fade4(x), v = fade4(y), w = fade4(z);
+        __m128 x1 = _mm_sub_ps(x, one), y1 = _mm_sub_ps(y, one), z1 = _mm_sub_ps(z, one);
+        __m128 near_z = lerp4(v,
+                              lerp4(u, grad4(hash(0), x, y, z), grad4(hash(1), x1, y, z)),
+                              lerp4(u, grad4(hash(2), x, y1, z), grad4(hash(3), x1, y1, z)));
+        __m128 far_z = lerp4(v,
+                             lerp4(u, grad4(hash(4), x, y, z1), grad4(hash(5), x1, y, z1)),
+                             lerp4(u, grad4(hash(6), x, y1, z1), grad4(hash(7), x1, y1, z1)));
+        _mm_storeu_ps(out + done, lerp4(w, near_z, far_z));
+    }
+#endif
+    for(; done < count; done++) out[done] = gradient_noise(points[done], scale);
 }
 
 } // namespace cg
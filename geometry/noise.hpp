@@ -5,46 +5,122 @@
 //
 //	Author:  David W. Nesbitt
 //	File:    noise.hpp
-//	Purpose: Noise generation methods.
+//	Purpose: Noise generation methods. Gradient (Perlin) noise over a
+//           permutation lattice, multi-octave turbulence, batched
+//           evaluation over position arrays and multithreaded baking of
+//           2D / 3D noise grids.
 //============================================================================
 
 #ifndef __GEOMETRY_NOISE_HPP__
 #define __GEOMETRY_NOISE_HPP__
 
 #include "geometry/point3.hpp"
+#include "geometry/vector3.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
 
 namespace cg
 {
 
-// NOTE - not required until 605.767!
+/**
+ * Which function Noise::bake fills a grid with.
+ */
+enum class NoiseType
+{
+    NOISE,
+    TURBULENCE
+};
 
 /**
- * Noise generation methods
+ * Noise generation methods. The batched and baked results are identical to
+ * calling noise() / turbulence() for each position. Positions are expected
+ * to stay within +/- 2^31 after scaling.
  */
 class Noise
 {
   public:
     /**
-     * Constructor
+     * Constructor. Uses a fixed permutation and 4 turbulence octaves.
      */
     Noise();
 
     /**
-     * Finds the noise at a specific 3D position. Linearly interpolates
-     * lattice noise.
+     * Constructor given a seed for the lattice permutation.
+     * @param  seed     Permutation seed. Equal seeds give equal noise.
+     * @param  octaves  Number of octaves summed by turbulence (at least 1).
+     */
+    Noise(uint32_t seed, uint32_t octaves = 4);
+
+    /**
+     * Finds the noise at a specific 3D position. Interpolates gradients
+     * on the integer lattice of p * scale with a quintic fade.
      * @param  p       Position
      * @param  scale   Scale
-     * @return  Returns linearly interpolated noise value.
+     * @return  Returns the noise value in [0, 1].
      */
-    float noise(const Point3 &p, float scale);
+    float noise(const Point3 &p, float scale) const;
 
     /**
-     * Find turbelence value.
-     * @param  scale   Scale
+     * Find turbelence value: sum of |gradient noise| over octaves of
+     * doubling frequency and halving amplitude.
+     * @param  scale   Scale of the first octave
      * @param  p       Position
-     * @return  Returns a turbulence value
+     * @return  Returns a turbulence value in [0, 1]
      */
-    float turbulence(float scale, const Point3 &p);
+    float turbulence(float scale, const Point3 &p) const;
+
+    /**
+     * Finds the noise at an array of positions, 4 at a time with SIMD
+     * where available.
+     * @param  points  Positions.
+     * @param  count   Number of positions.
+     * @param  scale   Scale
+     * @param  out     Receives count noise values.
+     */
+    void noise(const Point3 *points, size_t count, float scale, float *out) const;
+
+    /**
+     * Finds the turbulence at an array of positions.
+     * @param  scale   Scale of the first octave
+     * @param  points  Positions.
+     * @param  count   Number of positions.
+     * @param  out     Receives count turbulence values.
+     */
+    void turbulence(float scale, const Point3 *points, size_t count, float *out) const;
+
+    /**
+     * Fills a grid of nx * ny * nz samples (x fastest, then y, then z) at
+     * origin + (i, j, k) * spacing. Use nz = 1 for a 2D grid. The grid is
+     * split into tiles of rows that are shared out across threads.
+     * @param  type          Noise or turbulence.
+     * @param  scale         Scale
+     * @param  origin        Position of sample (0, 0, 0).
+     * @param  spacing       Distance between samples along each axis.
+     * @param  nx            Samples along x.
+     * @param  ny            Samples along y.
+     * @param  nz            Samples along z.
+     * @param  out           Receives nx * ny * nz values.
+     * @param  thread_count  Number of threads (0 = one per core).
+     */
+    void bake(NoiseType      type,
+              float          scale,
+              const Point3  &origin,
+              const Vector3 &spacing,
+              uint32_t       nx,
+              uint32_t       ny,
+              uint32_t       nz,
+              float         *out,
+              uint32_t       thread_count = 0) const;
+
+  protected:
+    std::array<uint8_t, 512> perm_; // Permutation of 0-255, repeated
+    uint32_t                 octaves_;
+
+    // Signed gradient noise at p * scale (roughly [-1, 1])
+    float gradient_noise(const Point3 &p, float scale) const;
+    void  gradient_noise(const Point3 *points, size_t count, float scale, float *out) const;
 };
 
 } // namespace cg
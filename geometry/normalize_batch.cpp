@@ -0,0 +1,316 @@
+#include "geometry/normalize_batch.hpp"
+
+#include "geometry/geometry.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define CG_NORMALIZE_SSE2 1
+#endif
+
+namespace cg
+{
+
+namespace
+{
+
+// Vectors are read as flat float arrays
+static_assert(sizeof(Vector2) == 2 * sizeof(float), "Vector2 must be 2 packed floats");
+static_assert(sizeof(Vector3) == 3 * sizeof(float), "Vector3 must be 3 packed floats");
+static_assert(sizeof(Quaternion) == 4 * sizeof(float), "Quaternion must be 4 packed floats");
+
+constexpr float MIN_LENGTH_SQUARED = EPSILON * EPSILON;
+
+// Number of normals staged through the stack by normalize_normals
+constexpr size_t TILE_SIZE = 256;
+
+#if defined(CG_NORMALIZE_SSE2)
+
+__m128 select4(__m128 mask, __m128 a, __m128 b)
+{
+    return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+
+// 1 / sqrt(len2) for 4 lanes. valid receives the lanes longer than EPSILON;
+// the others are 0.
+__m128 inv_length4(__m128 len2, NormalizeAccuracy accuracy, __m128 &valid)
+{
+    if(accuracy == NormalizeAccuracy::EXACT)
+    {
+        __m128 n = _mm_sqrt_ps(len2);
+        valid = _mm_cmpgt_ps(n, _mm_set1_ps(EPSILON));
+        return _mm_and_ps(valid, _mm_div_ps(_mm_set1_ps(1.0f), n));
+    }
+    valid = _mm_cmpgt_ps(len2, _mm_set1_ps(MIN_LENGTH_SQUARED));
+    __m128 y = _mm_rsqrt_ps(len2);
+    if(accuracy == NormalizeAccuracy::REFINED)
+    {
+        // Newton-Raphson step y (1.5 - 0.5 x y^2) roughly squares the error
+        __m128 half_x = _mm_mul_ps(_mm_set1_ps(0.5f), len2);
+        y = _mm_mul_ps(y, _mm_sub_ps(_mm_set1_ps(1.5f), _mm_mul_ps(half_x, _mm_mul_ps(y, y))));
+    }
+    return _mm_and_ps(valid, y);
+}
+
+// Squared lengths of the 4 vectors in 8 floats (x0 y0 x1 y1 | x2 y2 x3 y3),
+// summed in the same order as Vector2::norm_squared
+__m128 length_squared2x4(__m128 a, __m128 b)
+{
+    __m128 sa = _mm_mul_ps(a, a);
+    __m128 sb = _mm_mul_ps(b, b);
+    return _mm_add_ps(_mm_shuffle_ps(sa, sb, _MM_SHUFFLE(2, 0, 2, 0)),
+                      _mm_shuffle_ps(sa, sb, _MM_SHUFFLE(3, 1, 3, 1)));
+}
+
+// Squared lengths of the 4 vectors in 12 floats (x0 y0 z0 x1 | y1 z1 x2 y2 |
+// z2 x3 y3 z3), summed in the same order as Vector3::norm_squared
+__m128 length_squared3x4(__m128 a, __m128 b, __m128 c)
+{
+    __m128 sa = _mm_mul_ps(a, a);
+    __m128 sb = _mm_mul_ps(b, b);
+    __m128 sc = _mm_mul_ps(c, c);
+    __m128 t = _mm_shuffle_ps(sb, sc, _MM_SHUFFLE(1, 0, 3, 2));
+    __m128 x = _mm_shuffle_ps(sa, t, _MM_SHUFFLE(3, 0, 3, 0));
+    __m128 u = _mm_shuffle_ps(sa, sb, _MM_SHUFFLE(0, 0, 1, 1));
+    __m128 v = _mm_shuffle_ps(sb, sc, _MM_SHUFFLE(2, 2, 3, 3));
+    __m128 y = _mm_shuffle_ps(u, v, _MM_SHUFFLE(2, 0, 2, 0));
+    u = _mm_shuffle_ps(sa, sb, _MM_SHUFFLE(1, 1, 2, 2));
+    v = _mm_shuffle_ps(sc, sc, _MM_SHUFFLE(3, 3, 0, 0));
+    __m128 z = _mm_shuffle_ps(u, v, _MM_SHUFFLE(2, 0, 2, 0));
+    return _mm_add_ps(_mm_add_ps(x, y), z);
+}
+
+void inverse_lengths2x4(const float *in, float *out, NormalizeAccuracy accuracy)
+{
+    __m128 valid;
+    __m128 len2 = length_squared2x4(_mm_loadu_ps(in), _mm_loadu_ps(in + 4));
+    _mm_storeu_ps(out, inv_length4(len2, accuracy, valid));
+}
+
+void inverse_lengths3x4(const float *in, float *out, NormalizeAccuracy accuracy)
+{
+    __m128 valid;
+    __m128 len2 = length_squared3x4(_mm_loadu_ps(in), _mm_loadu_ps(in + 4), _mm_loadu_ps(in + 8));
+    _mm_storeu_ps(out, inv_length4(len2, accuracy, valid));
+}
+
+void normalize2x4(const float *in, float *out, NormalizeAccuracy accuracy)
+{
+    __m128 a = _mm_loadu_ps(in);
+    __m128 b = _mm_loadu_ps(in + 4);
+    __m128 len2 = length_squared2x4(a, b);
+    __m128 one = _mm_set1_ps(1.0f);
+    if(accuracy == NormalizeAccuracy::EXACT)
+    {
+        // Vector2::normalize divides by the length
+        __m128 n = _mm_sqrt_ps(len2);
+        __m128 d = select4(_mm_cmpgt_ps(n, _mm_set1_ps(EPSILON)), n, one);
+        a = _mm_div_ps(a, _mm_shuffle_ps(d, d, _MM_SHUFFLE(1, 1, 0, 0)));
+        b = _mm_div_ps(b, _mm_shuffle_ps(d, d, _MM_SHUFFLE(3, 3, 2, 2)));
+    }
+    else
+    {
+        __m128 valid;
+        __m128 inv = inv_length4(len2, accuracy, valid);
+        __m128 s = select4(valid, inv, one);
+        a = _mm_mul_ps(a, _mm_shuffle_ps(s, s, _MM_SHUFFLE(1, 1, 0, 0)));
+        b = _mm_mul_ps(b, _mm_shuffle_ps(s, s, _MM_SHUFFLE(3, 3, 2, 2)));
+    }
+    _mm_storeu_ps(out, a);
+    _mm_storeu_ps(out + 4, b);
+}
+
+void normalize3x4(const float *in, float *out, NormalizeAccuracy accuracy)
+{
+    __m128 a = _mm_loadu_ps(in);
+    __m128 b = _mm_loadu_ps(in + 4);
+    __m128 c = _mm_loadu_ps(in + 8);
+    __m128 valid;
+    __m128 inv = inv_length4(length_squared3x4(a, b, c), accuracy, valid);
+
+    // Scale each vector by its own lane: (s0 s0 s0 s1 | s1 s1 s2 s2 | s2 s3 s3 s3)
+    __m128 s = select4(valid, inv, _mm_set1_ps(1.0f));
+    _mm_storeu_ps(out, _mm_mul_ps(a, _mm_shuffle_ps(s, s, _MM_SHUFFLE(1, 0, 0, 0))));
+    _mm_storeu_ps(out + 4, _mm_mul_ps(b, _mm_shuffle_ps(s, s, _MM_SHUFFLE(2, 2, 1, 1))));
+    _mm_storeu_ps(out + 8, _mm_mul_ps(c, _mm_shuffle_ps(s, s, _MM_SHUFFLE(3, 3, 3, 2))));
+}
+
+void normalize4x4(const float *in, float *out, NormalizeAccuracy accuracy)
+{
+    __m128 q[4], s[4];
+    for(int32_t k = 0; k < 4; k++)
+    {
+        q[k] = _mm_loadu_ps(in + 4 * k);
+        s[k] = _mm_mul_ps(q[k], q[k]);
+    }
+
+    // Columns are the x, y, z and w squares; summed in the same order as
+    // Quaternion::norm_squared
+    _MM_TRANSPOSE4_PS(s[0], s[1], s[2], s[3]);
+    __m128 len2 = _mm_add_ps(_mm_add_ps(_mm_add_ps(s[0], s[1]), s[2]), s[3]);
+    __m128 valid;
+    __m128 inv = inv_length4(len2, accuracy, valid);
+    __m128 m = select4(valid, inv, _mm_set1_ps(1.0f));
+    _mm_storeu_ps(out, _mm_mul_ps(q[0], _mm_shuffle_ps(m, m, _MM_SHUFFLE(0, 0, 0, 0))));
+    _mm_storeu_ps(out + 4, _mm_mul_ps(q[1], _mm_shuffle_ps(m, m, _MM_SHUFFLE(1, 1, 1, 1))));
+    _mm_storeu_ps(out + 8, _mm_mul_ps(q[2], _mm_shuffle_ps(m, m, _MM_SHUFFLE(2, 2, 2, 2))));
+    _mm_storeu_ps(out + 12, _mm_mul_ps(q[3], _mm_shuffle_ps(m, m, _MM_SHUFFLE(3, 3, 3, 3))));
+}
+
+// Runs a 4 vector kernel over count vectors of dim floats each. The last
+// partial group goes through a zero padded copy so every vector gets the
+// same result wherever it is in the array.
+template <typename Kernel>
+void run4(const float *in, float *out, size_t count, size_t dim, size_t out_dim, Kernel kernel)
+{
+    size_t n4 = count & ~static_cast<size_t>(3);
+    for(size_t i = 0; i < n4; i += 4) kernel(in + i * dim, out + i * out_dim);
+    if(n4 < count)
+    {
+        float in_tail[16] = {};
+        float out_tail[16];
+        std::memcpy(in_tail, in + n4 * dim, (count - n4) * dim * sizeof(float));
+        kernel(in_tail, out_tail);
+        std::memcpy(out + n4 * out_dim, out_tail, (count - n4) * out_dim * sizeof(float));
+    }
+}
+
+#else
+
+// Scalar versions for targets without SSE
+float inv_length(float len2, NormalizeAccuracy accuracy)
+{
+    if(accuracy == NormalizeAccuracy::EXACT)
+    {
+        float n = std::sqrt(len2);
+        return (n > EPSILON) ? 1.0f / n : 0.0f;
+    }
+    if(len2 <= MIN_LENGTH_SQUARED) return 0.0f;
+    float y = fast_inv_sqrt(len2);
+    if(accuracy == NormalizeAccuracy::REFINED) y *= 1.5f - 0.5f * len2 * y * y;
+    return y;
+}
+
+#endif
+
+} // namespace
+
+void inverse_lengths(const Vector2 *in, float *out, size_t count, NormalizeAccuracy accuracy)
+{
+#if defined(CG_NORMALIZE_SSE2)
+    run4(reinterpret_cast<const float *>(in), out, count, 2, 1, [&](const float *i, float *o) {
+        inverse_lengths2x4(i, o, accuracy);
+    });
+#else
+    for(size_t i = 0; i < count; i++) out[i] = inv_length(in[i].norm_squared(), accuracy);
+#endif
+}
+
+void inverse_lengths(const Vector3 *in, float *out, size_t count, NormalizeAccuracy accuracy)
+{
+#if defined(CG_NORMALIZE_SSE2)
+    run4(reinterpret_cast<const float *>(in), out, count, 3, 1, [&](const float *i, float *o) {
+        inverse_lengths3x4(i, o, accuracy);
+    });
+#else
+    for(size_t i = 0; i < count; i++) out[i] = inv_length(in[i].norm_squared(), accuracy);
+#endif
+}
+
+void normalize_vectors(const Vector2 *in, Vector2 *out, size_t count, NormalizeAccuracy accuracy)
+{
+#if defined(CG_NORMALIZE_SSE2)
+    run4(reinterpret_cast<const float *>(in),
+         reinterpret_cast<float *>(out),
+         count,
+         2,
+         2,
+         [&](const float *i, float *o) { normalize2x4(i, o, accuracy); });
+#else
+    for(size_t i = 0; i < count; i++)
+    {
+        out[i] = in[i];
+        if(accuracy == NormalizeAccuracy::EXACT)
+        {
+            out[i].normalize();
+            continue;
+        }
+        float inv = inv_length(in[i].norm_squared(), accuracy);
+        if(inv != 0.0f) out[i] *= inv;
+    }
+#endif
+}
+
+void normalize_vectors(const Vector3 *in, Vector3 *out, size_t count, NormalizeAccuracy accuracy)
+{
+#if defined(CG_NORMALIZE_SSE2)
+    run4(reinterpret_cast<const float *>(in),
+         reinterpret_cast<float *>(out),
+         count,
+         3,
+         3,
+         [&](const float *i, float *o) { normalize3x4(i, o, accuracy); });
+#else
+    for(size_t i = 0; i < count; i++)
+    {
+        out[i] = in[i];
+        if(accuracy == NormalizeAccuracy::EXACT)
+        {
+            out[i].normalize();
+            continue;
+        }
+        float inv = inv_length(in[i].norm_squared(), accuracy);
+        if(inv != 0.0f) out[i] *= inv;
+    }
+#endif
+}
+
+void normalize_quaternions(const Quaternion *in,
+                           Quaternion       *out,
+                           size_t            count,
+                           NormalizeAccuracy accuracy)
+{
+#if defined(CG_NORMALIZE_SSE2)
+    run4(reinterpret_cast<const float *>(in),
+         reinterpret_cast<float *>(out),
+         count,
+         4,
+         4,
+         [&](const float *i, float *o) { normalize4x4(i, o, accuracy); });
+#else
+    for(size_t i = 0; i < count; i++)
+    {
+        out[i] = in[i];
+        if(accuracy == NormalizeAccuracy::EXACT)
+        {
+            out[i].normalize();
+            continue;
+        }
+        float inv = inv_length(in[i].norm_squared(), accuracy);
+        if(inv != 0.0f)
+        {
+            out[i].x *= inv;
+            out[i].y *= inv;
+            out[i].z *= inv;
+            out[i].w *= inv;
+        }
+    }
+#endif
+}
+
+void normalize_normals(VertexAndNormal *vertices, size_t count, NormalizeAccuracy accuracy)
+{
+    Vector3 normals[TILE_SIZE];
+    for(size_t first = 0; first < count; first += TILE_SIZE)
+    {
+        size_t n = std::min(TILE_SIZE, count - first);
+        for(size_t i = 0; i < n; i++) normals[i] = vertices[first + i].normal;
+        normalize_vectors(normals, normals, n, accuracy);
+        for(size_t i = 0; i < n; i++) vertices[first + i].normal = normals[i];
+    }
+}
+
+} // namespace cg
@@ -0,0 +1,125 @@
+//============================================================================
+//	Johns Hopkins University Engineering for Professionals
+//	605.667 Computer Graphics and 605.767 Applied Computer Graphics
+//	Instructor:	Brian Russin
+//
+//	Author:  Kyle Meyer
+//	File:    normalize_batch.hpp
+//	Purpose: Normalize arrays of vectors and quaternions and compute their inverse lengths,
+//           4 at a time with SSE. The accuracy is chosen per call: the
+//           hardware reciprocal square root estimate, the estimate refined
+//           by a Newton-Raphson step, or a full sqrt and divide.
+//============================================================================
+
+#ifndef __GEOMETRY_NORMALIZE_BATCH_HPP__
+#define __GEOMETRY_NORMALIZE_BATCH_HPP__
+
+#include "geometry/quaternion.hpp"
+#include "geometry/types.hpp"
+#include "geometry/vector2.hpp"
+#include "geometry/vector3.hpp"
+
+#include <cstddef>
+
+namespace cg
+{
+
+/**
+ * Accuracy of the batched inverse length and normalize kernels.
+ *  FAST     Reciprocal square root estimate (rsqrtps): relative error below
+ *           4e-4 (2e-3 on targets without SSE, which use fast_inv_sqrt).
+ *           Fine for shading normals.
+ *  REFINED  Estimate plus one Newton-Raphson step: relative error below
+ *           1e-6 (5e-6 without SSE).
+ *  EXACT    sqrt and divide: identical to Vector2::normalize /
+ *           Vector3::normalize / Quaternion::normalize.
+ * The estimate is not specified exactly by the instruction set, so FAST
+ * and REFINED results can differ in the last bits between CPU models.
+ */
+enum class NormalizeAccuracy
+{
+    FAST,
+    REFINED,
+    EXACT
+};
+
+/**
+ * Computes 1 / length of an array of vectors.
+ * @param  in        Input vectors.
+ * @param  out       Receives count inverse lengths. 0 for vectors no longer
+ *                   than EPSILON, so scaling by it never gives inf or NaN.
+ * @param  count     Number of vectors.
+ * @param  accuracy  Accuracy of the result.
+ */
+void inverse_lengths(const Vector2    *in,
+                     float            *out,
+                     size_t            count,
+                     NormalizeAccuracy accuracy = NormalizeAccuracy::REFINED);
+
+/**
+ * Computes 1 / length of an array of vectors.
+ * @param  in        Input vectors.
+ * @param  out       Receives count inverse lengths. 0 for vectors no longer
+ *                   than EPSILON, so scaling by it never gives inf or NaN.
+ * @param  count     Number of vectors.
+ * @param  accuracy  Accuracy of the result.
+ */
+void inverse_lengths(const Vector3    *in,
+                     float            *out,
+                     size_t            count,
+                     NormalizeAccuracy accuracy = NormalizeAccuracy::REFINED);
+
+/**
+ * Normalizes an array of vectors. Vectors no longer than EPSILON are left
+ * unchanged, as with Vector2::normalize.
+ * @param  in        Input vectors.
+ * @param  out       Output vectors. May be the same array as in.
+ * @param  count     Number of vectors.
+ * @param  accuracy  Accuracy of the result.
+ */
+void normalize_vectors(const Vector2    *in,
+                       Vector2          *out,
+                       size_t            count,
+                       NormalizeAccuracy accuracy = NormalizeAccuracy::REFINED);
+
+/**
+ * Normalizes an array of vectors. Vectors no longer than EPSILON are left
+ * unchanged, as with Vector3::normalize.
+ * @param  in        Input vectors.
+ * @param  out       Output vectors. May be the same array as in.
+ * @param  count     Number of vectors.
+ * @param  accuracy  Accuracy of the result.
+ */
+void normalize_vectors(const Vector3    *in,
+                       Vector3          *out,
+                       size_t            count,
+                       NormalizeAccuracy accuracy = NormalizeAccuracy::REFINED);
+
+/**
+ * Normalizes an array of quaternions, e.g. after nlerp blending or
+ * accumulating many products. Quaternions of norm EPSILON or less are left
+ * unchanged, as with Quaternion::normalize.
+ * @param  in        Input quaternions.
+ * @param  out       Output quaternions. May be the same array as in.
+ * @param  count     Number of quaternions.
+ * @param  accuracy  Accuracy of the result.
+ */
+void normalize_quaternions(const Quaternion *in,
+                           Quaternion       *out,
+                           size_t            count,
+                           NormalizeAccuracy accuracy = NormalizeAccuracy::REFINED);
+
+/**
+ * Renormalizes the normals of an array of vertices in place (e.g. after
+ * transform_vertices, skinning or displacement).
+ * @param  vertices  Vertices whose normals are normalized.
+ * @param  count     Number of vertices.
+ * @param  accuracy  Accuracy of the result.
+ */
+void normalize_normals(VertexAndNormal  *vertices,
+                       size_t            count,
+                       NormalizeAccuracy accuracy = NormalizeAccuracy::REFINED);
+
+} // namespace cg
+
+#endif
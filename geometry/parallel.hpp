@@ -0,0 +1,65 @@
+//============================================================================
+//	Johns Hopkins University Engineering for Professionals
+//	605.667 Computer Graphics and 605.767 Applied Computer Graphics
+//	Instructor:	Brian Russin
+//
+//	Author:  Kyle Meyer
+//	File:    parallel.hpp
+//	Purpose: Minimal fork / join helper for splitting large loops over
+//           geometry (bounds, BVH builds) across std::threads.
+//============================================================================
+
+#ifndef __GEOMETRY_PARALLEL_HPP__
+#define __GEOMETRY_PARALLEL_HPP__
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+namespace cg
+{
+
+/**
+ * Gets the number of threads to use when the caller asks for 0 (one per
+ * core).
+ * @param  thread_count  Requested thread count, 0 for one per core.
+ * @return  Returns the thread count (at least 1).
+ */
+inline uint32_t resolve_thread_count(uint32_t thread_count)
+{
+    return (thread_count > 0) ? thread_count : std::max(1u, std::thread::hardware_concurrency());
+}
+
+/**
+ * Splits [0, count) into one contiguous range per thread and calls
+ * fn(first, last) for each. The calling thread handles the first range.
+ * Loops shorter than min_count run entirely on the calling thread.
+ * @param  count         Number of items.
+ * @param  thread_count  Number of threads (0 = one per core).
+ * @param  min_count     Smallest loop worth splitting.
+ * @param  fn            Function called as fn(size_t first, size_t last).
+ */
+template <typename Fn>
+void parallel_for(size_t count, uint32_t thread_count, size_t min_count, Fn fn)
+{
+    thread_count = resolve_thread_count(thread_count);
+    if(thread_count <= 1 || count < min_count)
+    {
+        fn(size_t(0), count);
+        return;
+    }
+    std::vector<std::thread> workers;
+    size_t                   chunk = (count + thread_count - 1) / thread_count;
+    for(size_t first = chunk; first < count; first += chunk)
+    {
+        workers.emplace_back(fn, first, std::min(count, first + chunk));
+    }
+    fn(size_t(0), std::min(count, chunk));
+    for(std::thread &w : workers) w.join();
+}
+
+} // namespace cg
+
+#endif
@@ -0,0 +1,327 @@
+#include "geometry/polygon_grid.hpp"
+
+#include "geometry/geometry.hpp"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define CG_GRID_SSE2 1
+#endif
+
+namespace cg
+{
+
+namespace
+{
+
+// Largest number of cells along each grid axis
+constexpr uint32_t MAX_CELLS_PER_AXIS = 4096;
+
+// Edges are padded to a multiple of this so the SIMD loop has no remainder
+constexpr uint32_t EDGE_GROUP = 4;
+
+uint32_t cell_coord(float x, float origin, float cell_size, uint32_t cells)
+{
+    float c = std::floor((x - origin) / cell_size);
+    if(!(c > 0.0f)) return 0; // Also catches NaN
+    return std::min(static_cast<uint32_t>(std::min(c, 1.0e9f)), cells - 1);
+}
+
+} // namespace
+
+PolygonGrid::PolygonGrid() : cell_size_(1.0f), cells_x_(0), cells_y_(0) {}
+
+PolygonGrid::PolygonGrid(const std::vector<std::vector<Point2>> &polygons, float cell_size)
+{
+    build(polygons, cell_size);
+}
+
+void PolygonGrid::build(const std::vector<std::vector<Point2>> &polygons, float cell_size)
+{
+    size_t n = polygons.size();
+    edge_start_.resize(n);
+    edge_count_.resize(n);
+    poly_min_.assign(n, Point2(FLT_MAX, FLT_MAX));
+    poly_max_.assign(n, Point2(-FLT_MAX, -FLT_MAX));
+    edge_x0_.clear();
+    edge_y0_.clear();
+    edge_x1_.clear();
+    edge_y1_.clear();
+
+    // Flatten the edges and find the bounds
+    Point2 lo(FLT_MAX, FLT_MAX), hi(-FLT_MAX, -FLT_MAX);
+    for(size_t i = 0; i < n; i++)
+    {
+        const std::vector<Point2> &poly = polygons[i];
+        edge_start_[i] = static_cast<uint32_t>(edge_x0_.size());
+        edge_count_[i] = static_cast<uint32_t>(poly.size());
+        for(size_t j = 0; j < poly.size(); j++)
+        {
+            const Point2 &p1 = poly[(j == 0) ? poly.size() - 1 : j - 1];
+            const Point2 &p2 = poly[j];
+            edge_x0_.push_back(p1.x);
+            edge_y0_.push_back(p1.y);
+            edge_x1_.push_back(p2.x);
+            edge_y1_.push_back(p2.y);
+
+            poly_min_[i].set(std::min(poly_min_[i].x, p2.x), std::min(poly_min_[i].y, p2.y));
+            poly_max_[i].set(std::max(poly_max_[i].x, p2.x), std::max(poly_max_[i].y, p2.y));
+        }
+        for(size_t k = edge_start_[i]; edge_x0_.size() % EDGE_GROUP != 0; k++)
+        {
+            edge_x0_.push_back(edge_x0_[k]);
+            edge_y0_.push_back(edge_y0_[k]);
+            edge_x1_.push_back(edge_x1_[k]);
+            edge_y1_.push_back(edge_y1_[k]);
+        }
+        if(!poly.empty())
+        {
+            lo.set(std::min(lo.x, poly_min_[i].x), std::min(lo.y, poly_min_[i].y));
+            hi.set(std::max(hi.x, poly_max_[i].x), std::max(hi.y, poly_max_[i].y));
+        }
+    }
+
+    cell_start_.assign(1, 0);
+    cell_items_.clear();
+    cells_x_ = cells_y_ = 0;
+    if(lo.x > hi.x) return;
+
+    // Size the cells so there are about as many cells as polygons
+    float width = std::max(hi.x - lo.x, EPSILON);
+    float height = std::max(hi.y - lo.y, EPSILON);
+    if(cell_size <= 0.0f) cell_size = std::sqrt(width * height / static_cast<float>(n));
+    cell_size = std::max({cell_size,
+                          width / static_cast<float>(MAX_CELLS_PER_AXIS),
+                          height / static_cast<float>(MAX_CELLS_PER_AXIS)});
+    origin_ = lo;
+    cell_size_ = cell_size;
+    cells_x_ = std::min(MAX_CELLS_PER_AXIS, static_cast<uint32_t>(width / cell_size) + 1);
+    cells_y_ = std::min(MAX_CELLS_PER_AXIS, static_cast<uint32_t>(height / cell_size) + 1);
+
+    // Count the polygons per cell, then fill (compressed rows)
+    auto for_each_cell = [&](uint32_t i, auto fn) {
+        if(edge_count_[i] == 0) return;
+        uint32_t x0 = cell_coord(poly_min_[i].x, origin_.x, cell_size_, cells_x_);
+        uint32_t x1 = cell_coord(poly_max_[i].x, origin_.x, cell_size_, cells_x_);
+        uint32_t y0 = cell_coord(poly_min_[i].y, origin_.y, cell_size_, cells_y_);
+        uint32_t y1 = cell_coord(poly_max_[i].y, origin_.y, cell_size_, cells_y_);
+        for(uint32_t y = y0; y <= y1; y++)
+        {
+            for(uint32_t x = x0; x <= x1; x++) fn(y * cells_x_ + x);
+        }
+    };
+    cell_start_.assign(static_cast<size_t>(cells_x_) * cells_y_ + 1, 0);
+    for(uint32_t i = 0; i < n; i++)
+    {
+        for_each_cell(i, [&](uint32_t c) { cell_start_[c + 1]++; });
+    }
+    for(size_t c = 1; c < cell_start_.size(); c++) cell_start_[c] += cell_start_[c - 1];
+    cell_items_.resize(cell_start_.back());
+    std::vector<uint32_t> fill(cell_start_.begin(), cell_start_.end() - 1);
+    for(uint32_t i = 0; i < n; i++)
+    {
+        for_each_cell(i, [&](uint32_t c) { cell_items_[fill[c]++] = i; });
+    }
+}
+
+size_t PolygonGrid::polygon_count() const { return edge_count_.size(); }
+
+void PolygonGrid::query(const LineSegment2 &segment, std::vector<uint32_t> &candidates) const
+{
+    candidates.clear();
+    if(cells_x_ == 0) return;
+
+    // Clip the segment to the grid rectangle
+    Vector2 c = segment.b - segment.a;
+    float   t0 = 0.0f, t1 = 1.0f;
+    float   a[2] = {segment.a.x, segment.a.y};
+    float   d[2] = {c.x, c.y};
+    float   lo[2] = {origin_.x, origin_.y};
+    float   hi[2] = {origin_.x + cell_size_ * static_cast<float>(cells_x_),
+                     origin_.y + cell_size_ * static_cast<float>(cells_y_)};
+    for(int32_t k = 0; k < 2; k++)
+    {
+        if(d[k] == 0.0f)
+        {
+            if(a[k] < lo[k] || a[k] > hi[k]) return;
+            continue;
+        }
+        float ta = (lo[k] - a[k]) / d[k];
+        float tb = (hi[k] - a[k]) / d[k];
+        t0 = std::max(t0, std::min(ta, tb));
+        t1 = std::min(t1, std::max(ta, tb));
+    }
+    if(t0 > t1) return;
+
+    // Walk the cells the segment crosses (Amanatides and Woo)
+    uint32_t x = cell_coord(a[0] + d[0] * t0, origin_.x, cell_size_, cells_x_);
+    uint32_t y = cell_coord(a[1] + d[1] * t0, origin_.y, cell_size_, cells_y_);
+    uint32_t end_x = cell_coord(a[0] + d[0] * t1, origin_.x, cell_size_, cells_x_);
+    uint32_t end_y = cell_coord(a[1] + d[1] * t1, origin_.y, cell_size_, cells_y_);
+    int32_t  step_x = (d[0] > 0.0f) ? 1 : -1;
+    int32_t  step_y = (d[1] > 0.0f) ? 1 : -1;
+    float    t_max_x = FLT_MAX, t_max_y = FLT_MAX, t_delta_x = FLT_MAX, t_delta_y = FLT_MAX;
+    if(d[0] != 0.0f)
+    {
+        float edge = origin_.x + cell_size_ * static_cast<float>(x + (step_x > 0 ? 1 : 0));
+        t_max_x = (edge - a[0]) / d[0];
+        t_delta_x = cell_size_ / std::abs(d[0]);
+    }
+    if(d[1] != 0.0f)
+    {
+        float edge = origin_.y + cell_size_ * static_cast<float>(y + (step_y > 0 ? 1 : 0));
+        t_max_y = (edge - a[1]) / d[1];
+        t_delta_y = cell_size_ / std::abs(d[1]);
+    }
+    for(uint32_t steps = 0; steps <= cells_x_ + cells_y_; steps++)
+    {
+        uint32_t cell = y * cells_x_ + x;
+        candidates.insert(candidates.end(),
+                          cell_items_.begin() + cell_start_[cell],
+                          cell_items_.begin() + cell_start_[cell + 1]);
+        if(x == end_x && y == end_y) break;
+        if(t_max_x < t_max_y)
+        {
+            if((step_x < 0 && x == 0) || (step_x > 0 && x + 1 == cells_x_)) break;
+            x += step_x;
+            t_max_x += t_delta_x;
+        }
+        else
+        {
+            if((step_y < 0 && y == 0) || (step_y > 0 && y + 1 == cells_y_)) break;
+            y += step_y;
+            t_max_y += t_delta_y;
+        }
+    }
+    std::sort(candidates.begin(), candidates.end());
+    candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+}
+
+Segment2ClipResult PolygonGrid::clip(const LineSegment2 &segment, uint32_t polygon) const
+{
+    float t_in, t_out;
+    if(!clip_interval(segment, polygon, t_in, t_out))
+    {
+        // Set clip segment to 0s
+        LineSegment2 clip_segment;
+        clip_segment.a.set(0.0f, 0.0f);
+        clip_segment.b.set(0.0f, 0.0f);
+        return {false, clip_segment};
+    }
+    Vector2      c = segment.b - segment.a;
+    LineSegment2 clip_segment;
+    clip_segment.a = segment.a + c * t_in;
+    clip_segment.b = segment.a + c * t_out;
+    return {true, clip_segment};
+}
+
+void PolygonGrid::clip_segments_to_polygons(const LineSegment2             *segments,
+                                            size_t                          count,
+                                            std::vector<SegmentPolygonClip> &clips) const
+{
+    clips.clear();
+    std::vector<uint32_t> candidates;
+    for(size_t s = 0; s < count; s++)
+    {
+        const LineSegment2 &seg = segments[s];
+        Vector2             c = seg.b - seg.a;
+        float               min_x = std::min(seg.a.x, seg.b.x), max_x = std::max(seg.a.x, seg.b.x);
+        float               min_y = std::min(seg.a.y, seg.b.y), max_y = std::max(seg.a.y, seg.b.y);
+        query(seg, candidates);
+        for(uint32_t p : candidates)
+        {
+            // Bounds reject before the edge loop
+            if(poly_min_[p].x > max_x || poly_max_[p].x < min_x || poly_min_[p].y > max_y ||
+               poly_max_[p].y < min_y)
+                continue;
+            SegmentPolygonClip clip;
+            if(!clip_interval(seg, p, clip.t_in, clip.t_out)) continue;
+            clip.segment = static_cast<uint32_t>(s);
+            clip.polygon = p;
+            clip.clip_segment.a = seg.a + c * clip.t_in;
+            clip.clip_segment.b = seg.a + c * clip.t_out;
+            clips.push_back(clip);
+        }
+    }
+}
+
+bool PolygonGrid::clip_interval(const LineSegment2 &segment,
+                                uint32_t            polygon,
+                                float              &t_in,
+                                float              &t_out) const
+{
+    // Same side tests and arithmetic as LineSegment2::clip_to_polygon. The
+    // only early out is both endpoints outside an edge, which gives the
+    // same answer: t_in only grows and t_out only shrinks.
+    t_in = 0.0f;
+    t_out = 1.0f;
+    if(edge_count_[polygon] == 0) return false;
+    uint32_t first = edge_start_[polygon];
+    uint32_t last = first + edge_count_[polygon];
+    auto     exact_side = [&](uint32_t e, const Point2 &q) {
+        return orient2d(Point2(static_cast<float>(edge_x0_[e]), static_cast<float>(edge_y0_[e])),
+                        Point2(static_cast<float>(edge_x1_[e]), static_cast<float>(edge_y1_[e])),
+                        q);
+    };
+    double lo = 0.0, hi = 1.0;
+#if defined(CG_GRID_SSE2)
+    // orient2d's filter 2 edges at a time. Lanes the filter cannot decide
+    // go through orient2d itself, so the values match it exactly.
+    const __m128d ax = _mm_set1_pd(segment.a.x), ay = _mm_set1_pd(segment.a.y);
+    const __m128d bx = _mm_set1_pd(segment.b.x), by = _mm_set1_pd(segment.b.y);
+    const __m128d bound = _mm_set1_pd(ORIENT2D_FILTER_BOUND);
+    const __m128d sign = _mm_set1_pd(-0.0);
+    const __m128d zero = _mm_setzero_pd();
+    __m128d       lo2 = zero, hi2 = _mm_set1_pd(1.0);
+    for(uint32_t e = first; e < last; e += 2)
+    {
+        __m128d x0 = _mm_loadu_pd(&edge_x0_[e]), y0 = _mm_loadu_pd(&edge_y0_[e]);
+        __m128d x1 = _mm_loadu_pd(&edge_x1_[e]), y1 = _mm_loadu_pd(&edge_y1_[e]);
+        __m128d side[2], unsure = zero;
+        const __m128d qx[2] = {ax, bx}, qy[2] = {ay, by};
+        for(int32_t k = 0; k < 2; k++)
+        {
+            __m128d l = _mm_mul_pd(_mm_sub_pd(x0, qx[k]), _mm_sub_pd(y1, qy[k]));
+            __m128d r = _mm_mul_pd(_mm_sub_pd(y0, qy[k]), _mm_sub_pd(x1, qx[k]));
+            side[k] = _mm_sub_pd(l, r);
+            __m128d err = _mm_mul_pd(bound,
+                                     _mm_add_pd(_mm_andnot_pd(sign, l), _mm_andnot_pd(sign, r)));
+            unsure = _mm_or_pd(unsure, _mm_cmplt_pd(_mm_andnot_pd(sign, side[k]), err));
+        }
+        if(_mm_movemask_pd(unsure) != 0)
+        {
+            side[0] = _mm_set_pd(exact_side(e + 1, segment.a), exact_side(e, segment.a));
+            side[1] = _mm_set_pd(exact_side(e + 1, segment.b), exact_side(e, segment.b));
+        }
+        __m128d out_a = _mm_cmplt_pd(side[0], zero), out_b = _mm_cmplt_pd(side[1], zero);
+        if(_mm_movemask_pd(_mm_and_pd(out_a, out_b)) != 0) return false;
+        __m128d t_hit = _mm_div_pd(side[0], _mm_sub_pd(side[0], side[1]));
+        __m128d entering = _mm_andnot_pd(out_b, out_a), exiting = _mm_andnot_pd(out_a, out_b);
+        lo2 = _mm_or_pd(_mm_and_pd(entering, _mm_max_pd(lo2, t_hit)), _mm_andnot_pd(entering, lo2));
+        hi2 = _mm_or_pd(_mm_and_pd(exiting, _mm_min_pd(hi2, t_hit)), _mm_andnot_pd(exiting, hi2));
+    }
+
+    // Fold the 2 lanes
+    lo = _mm_cvtsd_f64(_mm_max_sd(lo2, _mm_unpackhi_pd(lo2, lo2)));
+    hi = _mm_cvtsd_f64(_mm_min_sd(hi2, _mm_unpackhi_pd(hi2, hi2)));
+#else
+    for(uint32_t e = first; e < last; e++)
+    {
+        double side_a = exact_side(e, segment.a);
+        double side_b = exact_side(e, segment.b);
+        if(side_a < 0.0 && side_b < 0.0) return false;
+        if(side_a >= 0.0 && side_b >= 0.0) continue;
+        double t_hit = side_a / (side_a - side_b);
+        if(side_a < 0.0) lo = (lo > t_hit) ? lo : t_hit;
+        else hi = (hi < t_hit) ? hi : t_hit;
+    }
+#endif
+    t_in = static_cast<float>(lo);
+    t_out = static_cast<float>(hi);
+    return lo <= hi;
+}
+
+} // namespace cg
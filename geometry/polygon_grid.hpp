@@ -0,0 +1,138 @@
+//============================================================================
+//	Johns Hopkins University Engineering for Professionals
+//	605.667 Computer Graphics and 605.767 Applied Computer Graphics
+//	Instructor:	Brian Russin
+//
+//	Author:  Kyle Meyer
+//	File:    polygon_grid.hpp
+//	Purpose: Uniform grid over the bounds of many convex polygons for
+//           batched segment clipping. A segment only visits the cells it
+//           crosses, so clipping cost depends on the polygons near the
+//           segment rather than the total count. Polygon edges are stored
+//           as structure of arrays so the edge side tests run 2 edges at a
+//           time.
+//============================================================================
+
+#ifndef __GEOMETRY_POLYGON_GRID_HPP__
+#define __GEOMETRY_POLYGON_GRID_HPP__
+
+#include "geometry/point2.hpp"
+#include "geometry/segment2.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace cg
+{
+
+/**
+ * One segment / polygon overlap. clip_segment.a is the entry point and
+ * clip_segment.b the exit point (equal to the segment endpoints when those
+ * are inside the polygon).
+ */
+struct SegmentPolygonClip
+{
+    uint32_t     segment; // Index into the segment array
+    uint32_t     polygon; // Index into the polygon list
+    float        t_in;    // Segment parameter of the entry point
+    float        t_out;   // Segment parameter of the exit point
+    LineSegment2 clip_segment;
+};
+
+/**
+ * Uniform grid of convex, counter-clockwise polygons.
+ */
+class PolygonGrid
+{
+  public:
+    /**
+     * Default constructor. Creates an empty grid.
+     */
+    PolygonGrid();
+
+    /**
+     * Constructor. Builds the grid for a list of polygons.
+     * @param  polygons   Convex, counter-clockwise polygons.
+     * @param  cell_size  Cell width and height (0 = pick one so there are
+     *                    about as many cells as polygons).
+     */
+    PolygonGrid(const std::vector<std::vector<Point2>> &polygons, float cell_size = 0.0f);
+
+    /**
+     * Builds (or rebuilds) the grid for a list of polygons.
+     * @param  polygons   Convex, counter-clockwise polygons.
+     * @param  cell_size  Cell width and height (0 = pick one so there are
+     *                    about as many cells as polygons).
+     */
+    void build(const std::vector<std::vector<Point2>> &polygons, float cell_size = 0.0f);
+
+    /**
+     * Gets the number of polygons in the grid.
+     * @return  Returns the polygon count.
+     */
+    size_t polygon_count() const;
+
+    /**
+     * Finds the polygons whose bounds overlap grid cells crossed by a
+     * segment.
+     * @param  segment     Segment to test.
+     * @param  candidates  Receives the polygon indices, sorted and unique.
+     */
+    void query(const LineSegment2 &segment, std::vector<uint32_t> &candidates) const;
+
+    /**
+     * Clips a segment to one polygon in the grid. Same result as
+     * LineSegment2::clip_to_polygon with the polygon's vertex list.
+     * @param  segment  Segment to clip.
+     * @param  polygon  Polygon index.
+     * @return Returns true if any part of the segment remains and
+     *         the clipped segment.
+     */
+    Segment2ClipResult clip(const LineSegment2 &segment, uint32_t polygon) const;
+
+    /**
+     * Clips each segment to every polygon it overlaps. Results are ordered
+     * by segment, then by polygon index.
+     * @param  segments  Segments to clip.
+     * @param  count     Number of segments.
+     * @param  clips     Receives one entry per segment / polygon overlap
+     *                   (cleared first).
+     */
+    void clip_segments_to_polygons(const LineSegment2             *segments,
+                                   size_t                          count,
+                                   std::vector<SegmentPolygonClip> &clips) const;
+
+  protected:
+    // Per polygon: edge range in the edge arrays (padded to a multiple of
+    // 4 by repeating the first edge, which does not change the clip) and
+    // bounds
+    std::vector<uint32_t> edge_start_;
+    std::vector<uint32_t> edge_count_;
+    std::vector<Point2>   poly_min_;
+    std::vector<Point2>   poly_max_;
+
+    // Edge start and end points, one array per component. Widened to
+    // double for the orient2d filter.
+    std::vector<double> edge_x0_;
+    std::vector<double> edge_y0_;
+    std::vector<double> edge_x1_;
+    std::vector<double> edge_y1_;
+
+    // Cell c holds polygons cell_items_[cell_start_[c], cell_start_[c + 1])
+    Point2                origin_;
+    float                 cell_size_;
+    uint32_t              cells_x_;
+    uint32_t              cells_y_;
+    std::vector<uint32_t> cell_start_;
+    std::vector<uint32_t> cell_items_;
+
+    bool clip_interval(const LineSegment2 &segment,
+                       uint32_t            polygon,
+                       float              &t_in,
+                       float              &t_out) const;
+};
+
+} // namespace cg
+
+#endif
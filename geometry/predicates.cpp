@@ -0,0 +1,210 @@
+#include "geometry/predicates.hpp"
+
+#include <cmath>
+#include <vector>
+
+namespace cg
+{
+
+namespace
+{
+
+// Exact arithmetic below assumes IEEE double with round to nearest and no
+// extended precision (SSE2 / x64 / ARM64 builds). Where the compiler may
+// contract a * b - c into a fused multiply-add, two_product uses fma
+// directly rather than Dekker's split, which contraction would break.
+
+constexpr double EPS = 0.5 * std::numeric_limits<double>::epsilon(); // 2^-53
+constexpr double SPLITTER = 134217729.0;                              // 2^27 + 1
+constexpr double ORIENT3D_FILTER_BOUND = (7.0 + 56.0 * EPS) * EPS;
+constexpr double INCIRCLE_FILTER_BOUND = (10.0 + 96.0 * EPS) * EPS;
+
+// Expansion: sum of nonoverlapping doubles in increasing magnitude, with
+// zero components removed (empty = 0)
+using Expansion = std::vector<double>;
+
+// x + y = a + b exactly, x = fl(a + b)
+void two_sum(double a, double b, double &x, double &y)
+{
+    x = a + b;
+    double b_virtual = x - a;
+    double a_virtual = x - b_virtual;
+    y = (a - a_virtual) + (b - b_virtual);
+}
+
+// x + y = a * b exactly, x = fl(a * b)
+void two_product(double a, double b, double &x, double &y)
+{
+    x = a * b;
+#if defined(FP_FAST_FMA)
+    y = std::fma(a, b, -x);
+#else
+    auto split = [](double v, double &hi, double &lo) {
+        double c = SPLITTER * v;
+        double big = c - v;
+        hi = c - big;
+        lo = v - hi;
+    };
+    double a_hi, a_lo, b_hi, b_lo;
+    split(a, a_hi, a_lo);
+    split(b, b_hi, b_lo);
+    double err1 = x - (a_hi * b_hi);
+    double err2 = err1 - (a_lo * b_hi);
+    double err3 = err2 - (a_hi * b_lo);
+    y = (a_lo * b_lo) - err3;
+#endif
+}
+
+// Exact a - b as an expansion
+Expansion difference(double a, double b)
+{
+    double x, y;
+    two_sum(a, -b, x, y);
+    Expansion h;
+    if(y != 0.0) h.push_back(y);
+    if(x != 0.0) h.push_back(x);
+    return h;
+}
+
+// e + f (Shewchuk's GROW-EXPANSION applied per component of f)
+Expansion sum(const Expansion &e, const Expansion &f)
+{
+    Expansion h = e;
+    Expansion next;
+    for(double b : f)
+    {
+        next.clear();
+        double q = b;
+        for(double component : h)
+        {
+            double hh;
+            two_sum(q, component, q, hh);
+            if(hh != 0.0) next.push_back(hh);
+        }
+        if(q != 0.0) next.push_back(q);
+        h.swap(next);
+    }
+    return h;
+}
+
+Expansion negate(Expansion e)
+{
+    for(double &component : e) component = -component;
+    return e;
+}
+
+// e * b (Shewchuk's SCALE-EXPANSION with zero elimination)
+Expansion scale(const Expansion &e, double b)
+{
+    Expansion h;
+    if(e.empty() || b == 0.0) return h;
+    double q, hh;
+    two_product(e[0], b, q, hh);
+    if(hh != 0.0) h.push_back(hh);
+    for(size_t i = 1; i < e.size(); i++)
+    {
+        double product1, product0, s;
+        two_product(e[i], b, product1, product0);
+        two_sum(q, product0, s, hh);
+        if(hh != 0.0) h.push_back(hh);
+        two_sum(product1, s, q, hh); // |product1| >= |s|, so this is exact
+        if(hh != 0.0) h.push_back(hh);
+    }
+    if(q != 0.0) h.push_back(q);
+    return h;
+}
+
+Expansion product(const Expansion &e, const Expansion &f)
+{
+    Expansion h;
+    for(double b : f) h = sum(h, scale(e, b));
+    return h;
+}
+
+// Approximate value of an expansion. The largest component dominates, so
+// the sign is exact.
+double estimate(const Expansion &e)
+{
+    double value = 0.0;
+    for(double component : e) value += component;
+    return value;
+}
+
+// l * r - m * s for expansions
+Expansion cross(const Expansion &l, const Expansion &r, const Expansion &m, const Expansion &s)
+{
+    return sum(product(l, r), negate(product(m, s)));
+}
+
+double orient3d_exact(const Point3 &a, const Point3 &b, const Point3 &c, const Point3 &d)
+{
+    Expansion adx = difference(a.x, d.x), ady = difference(a.y, d.y), adz = difference(a.z, d.z);
+    Expansion bdx = difference(b.x, d.x), bdy = difference(b.y, d.y), bdz = difference(b.z, d.z);
+    Expansion cdx = difference(c.x, d.x), cdy = difference(c.y, d.y), cdz = difference(c.z, d.z);
+    Expansion det = product(adz, cross(bdx, cdy, cdx, bdy));
+    det = sum(det, product(bdz, cross(cdx, ady, adx, cdy)));
+    det = sum(det, product(cdz, cross(adx, bdy, bdx, ady)));
+    return estimate(det);
+}
+
+double incircle_exact(const Point2 &a, const Point2 &b, const Point2 &c, const Point2 &d)
+{
+    Expansion adx = difference(a.x, d.x), ady = difference(a.y, d.y);
+    Expansion bdx = difference(b.x, d.x), bdy = difference(b.y, d.y);
+    Expansion cdx = difference(c.x, d.x), cdy = difference(c.y, d.y);
+    Expansion alift = sum(product(adx, adx), product(ady, ady));
+    Expansion blift = sum(product(bdx, bdx), product(bdy, bdy));
+    Expansion clift = sum(product(cdx, cdx), product(cdy, cdy));
+    Expansion det = product(alift, cross(bdx, cdy, cdx, bdy));
+    det = sum(det, product(blift, cross(cdx, ady, adx, cdy)));
+    det = sum(det, product(clift, cross(adx, bdy, bdx, ady)));
+    return estimate(det);
+}
+
+} // namespace
+
+double orient2d_exact(const Point2 &a, const Point2 &b, const Point2 &c)
+{
+    Expansion acx = difference(a.x, c.x), bcy = difference(b.y, c.y);
+    Expansion acy = difference(a.y, c.y), bcx = difference(b.x, c.x);
+    return estimate(cross(acx, bcy, acy, bcx));
+}
+
+double orient3d(const Point3 &a, const Point3 &b, const Point3 &c, const Point3 &d)
+{
+    double adx = static_cast<double>(a.x) - d.x, ady = static_cast<double>(a.y) - d.y;
+    double adz = static_cast<double>(a.z) - d.z;
+    double bdx = static_cast<double>(b.x) - d.x, bdy = static_cast<double>(b.y) - d.y;
+    double bdz = static_cast<double>(b.z) - d.z;
+    double cdx = static_cast<double>(c.x) - d.x, cdy = static_cast<double>(c.y) - d.y;
+    double cdz = static_cast<double>(c.z) - d.z;
+
+    double bdxcdy = bdx * cdy, cdxbdy = cdx * bdy;
+    double cdxady = cdx * ady, adxcdy = adx * cdy;
+    double adxbdy = adx * bdy, bdxady = bdx * ady;
+    double det = adz * (bdxcdy - cdxbdy) + bdz * (cdxady - adxcdy) + cdz * (adxbdy - bdxady);
+    double permanent = (std::abs(bdxcdy) + std::abs(cdxbdy)) * std::abs(adz) +
+                       (std::abs(cdxady) + std::abs(adxcdy)) * std::abs(bdz) +
+                       (std::abs(adxbdy) + std::abs(bdxady)) * std::abs(cdz);
+    if(std::abs(det) > ORIENT3D_FILTER_BOUND * permanent || permanent == 0.0) return det;
+    return orient3d_exact(a, b, c, d);
+}
+
+double incircle(const Point2 &a, const Point2 &b, const Point2 &c, const Point2 &d)
+{
+    double adx = static_cast<double>(a.x) - d.x, ady = static_cast<double>(a.y) - d.y;
+    double bdx = static_cast<double>(b.x) - d.x, bdy = static_cast<double>(b.y) - d.y;
+    double cdx = static_cast<double>(c.x) - d.x, cdy = static_cast<double>(c.y) - d.y;
+
+    double bdxcdy = bdx * cdy, cdxbdy = cdx * bdy, alift = adx * adx + ady * ady;
+    double cdxady = cdx * ady, adxcdy = adx * cdy, blift = bdx * bdx + bdy * bdy;
+    double adxbdy = adx * bdy, bdxady = bdx * ady, clift = cdx * cdx + cdy * cdy;
+    double det = alift * (bdxcdy - cdxbdy) + blift * (cdxady - adxcdy) + clift * (adxbdy - bdxady);
+    double permanent = (std::abs(bdxcdy) + std::abs(cdxbdy)) * alift +
+                       (std::abs(cdxady) + std::abs(adxcdy)) * blift +
+                       (std::abs(adxbdy) + std::abs(bdxady)) * clift;
+    if(std::abs(det) > INCIRCLE_FILTER_BOUND * permanent || permanent == 0.0) return det;
+    return incircle_exact(a, b, c, d);
+}
+
+} // namespace cg
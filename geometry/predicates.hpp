@@ -0,0 +1,96 @@
+//============================================================================
+//	Johns Hopkins University Engineering for Professionals
+//	605.667 Computer Graphics and 605.767 Applied Computer Graphics
+//	Instructor:	Brian Russin
+//
+//	Author:  Kyle Meyer
+//	File:    predicates.hpp
+//	Purpose: Robust orientation and in-circle predicates (after Shewchuk).
+//           Each is evaluated in double precision with a forward error
+//           bound; only when the result is too close to 0 for the bound
+//           is it recomputed exactly with floating-point expansions. The
+//           sign of the result is always exact for the float inputs.
+//============================================================================
+
+#ifndef __GEOMETRY_PREDICATES_HPP__
+#define __GEOMETRY_PREDICATES_HPP__
+
+#include "geometry/point2.hpp"
+#include "geometry/point3.hpp"
+
+#include <cmath>
+#include <limits>
+
+namespace cg
+{
+
+/**
+ * Relative error bound of the orient2d filter (Shewchuk's ccwerrboundA).
+ * orient2d returns the filtered determinant det = l - r, l = (a.x - c.x) *
+ * (b.y - c.y), r = (a.y - c.y) * (b.x - c.x), whenever |det| >= bound *
+ * (|l| + |r|). SIMD code that applies the same test gets the same values.
+ */
+constexpr double ORIENT2D_FILTER_BOUND =
+    (3.0 + 8.0 * std::numeric_limits<double>::epsilon()) * 0.5 *
+    std::numeric_limits<double>::epsilon();
+
+/**
+ * Orientation of 3 points in the plane, computed exactly. orient2d calls
+ * this when its filter fails.
+ * @param  a  First point.
+ * @param  b  Second point.
+ * @param  c  Test point.
+ * @return Returns a value with the sign of the orientation (see orient2d).
+ */
+double orient2d_exact(const Point2 &a, const Point2 &b, const Point2 &c);
+
+/**
+ * Orientation of 3 points in the plane. The filter is inline as it is
+ * called in the inner loops of the segment and polygon routines.
+ * @param  a  First point.
+ * @param  b  Second point.
+ * @param  c  Test point.
+ * @return Returns a positive value if a, b, c are in counter-clockwise
+ *         order (c is left of the directed line ab), negative if clockwise
+ *         and 0 if collinear. The value approximates twice the signed area
+ *         of the triangle; its sign is exact.
+ */
+inline double orient2d(const Point2 &a, const Point2 &b, const Point2 &c)
+{
+    double detleft = (static_cast<double>(a.x) - c.x) * (static_cast<double>(b.y) - c.y);
+    double detright = (static_cast<double>(a.y) - c.y) * (static_cast<double>(b.x) - c.x);
+    double det = detleft - detright;
+    if(std::abs(det) >= ORIENT2D_FILTER_BOUND * (std::abs(detleft) + std::abs(detright)))
+        return det;
+    return orient2d_exact(a, b, c);
+}
+
+/**
+ * Orientation of 4 points in space.
+ * @param  a  First point.
+ * @param  b  Second point.
+ * @param  c  Third point.
+ * @param  d  Test point.
+ * @return Returns a positive value if d lies below the plane through a, b
+ *         and c, where below means a, b, c appear counter-clockwise when
+ *         viewed from above. Negative if above, 0 if coplanar. The value
+ *         approximates 6 times the signed volume of the tetrahedron; its
+ *         sign is exact.
+ */
+double orient3d(const Point3 &a, const Point3 &b, const Point3 &c, const Point3 &d);
+
+/**
+ * In-circle test.
+ * @param  a  First point on the circle.
+ * @param  b  Second point on the circle.
+ * @param  c  Third point on the circle (a, b, c counter-clockwise).
+ * @param  d  Test point.
+ * @return Returns a positive value if d lies inside the circle through a, b
+ *         and c, negative if outside and 0 if on it. The sign is reversed
+ *         if a, b, c are clockwise. The sign is exact.
+ */
+double incircle(const Point2 &a, const Point2 &b, const Point2 &c, const Point2 &d);
+
+} // namespace cg
+
+#endif
@@ -0,0 +1,310 @@
+#include "geometry/prepared_polygon.hpp"
+
+#include "geometry/geometry.hpp"
+#include "geometry/parallel.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cfloat>
+#include <cmath>
+
+namespace cg
+{
+
+namespace
+{
+
+// Largest number of slabs (a polygon gets about one per edge)
+constexpr uint32_t MAX_SLABS = 4096;
+
+// Fewer slabs are used if edges would be stored in more than this many
+// slabs on average (tall edges, as in star shapes)
+constexpr size_t MAX_SLABS_PER_EDGE = 32;
+
+// Smallest batch worth splitting across threads
+constexpr size_t PARALLEL_MIN_POINTS = 4096;
+
+float component(const Point3 &p, uint32_t axis)
+{
+    return (axis == 0) ? p.x : ((axis == 1) ? p.y : p.z);
+}
+
+} // namespace
+
+PreparedPolygon::PreparedPolygon()
+    : u_axis_(0), v_axis_(1), min_(FLT_MAX, FLT_MAX), max_(-FLT_MAX, -FLT_MAX), slab_scale_(0.0f),
+      slab_count_(0), span_start_(1, 0), end_start_(1, 0)
+{
+}
+
+PreparedPolygon::PreparedPolygon(const std::vector<Point2> &polygon) { build(polygon); }
+
+PreparedPolygon::PreparedPolygon(const std::vector<Point3> &polygon, const Vector3 &n)
+{
+    build(polygon, n);
+}
+
+void PreparedPolygon::build(const std::vector<Point3> &polygon, const Vector3 &n)
+{
+    // Same choice of axis plane as Point3::is_in_polygon
+    if(std::abs(n.x) >= std::abs(n.y) && std::abs(n.x) >= std::abs(n.z))
+    {
+        u_axis_ = 1; // Drop the x component
+        v_axis_ = 2;
+    }
+    else if(std::abs(n.y) >= std::abs(n.x) && std::abs(n.y) >= std::abs(n.z))
+    {
+        u_axis_ = 0; // Drop the y component
+        v_axis_ = 2;
+    }
+    else
+    {
+        u_axis_ = 0; // Drop the z component
+        v_axis_ = 1;
+    }
+    std::vector<Point2> projected(polygon.size());
+    for(size_t i = 0; i < polygon.size(); i++) projected[i] = project(polygon[i]);
+
+    // build(Point2) resets the axes for 2D use, so restore them after
+    uint32_t u_axis = u_axis_, v_axis = v_axis_;
+    build(projected);
+    u_axis_ = u_axis;
+    v_axis_ = v_axis;
+}
+
+void PreparedPolygon::build(const std::vector<Point2> &polygon)
+{
+    u_axis_ = 0;
+    v_axis_ = 1;
+    slab_count_ = 0;
+    slab_scale_ = 0.0f;
+    span_start_.assign(1, 0);
+    span_edges_.clear();
+    span_up_.clear();
+    span_sorted_.clear();
+    end_start_.assign(1, 0);
+    end_edges_.clear();
+    min_.set(FLT_MAX, FLT_MAX);
+    max_.set(-FLT_MAX, -FLT_MAX);
+    if(polygon.empty()) return;
+
+    for(const Point2 &p : polygon)
+    {
+        min_.set(std::min(min_.x, p.x), std::min(min_.y, p.y));
+        max_.set(std::max(max_.x, p.x), std::max(max_.y, p.y));
+    }
+    float height = max_.y - min_.y;
+    for(slab_count_ = std::min(MAX_SLABS, static_cast<uint32_t>(polygon.size()));;
+        slab_count_ /= 2)
+    {
+        slab_scale_ = (height > 0.0f) ? static_cast<float>(slab_count_) / height : 0.0f;
+        size_t entries = 0;
+        auto   pt1 = polygon.end() - 1;
+        for(auto pt2 = polygon.begin(); pt2 != polygon.end(); pt1 = pt2, pt2++)
+        {
+            entries += slab(std::max(pt1->y, pt2->y)) - slab(std::min(pt1->y, pt2->y)) + 1;
+        }
+        if(slab_count_ == 1 || entries <= MAX_SLABS_PER_EDGE * polygon.size()) break;
+    }
+
+    // Count the edges per slab, then fill (compressed rows). Horizontal
+    // edges never cross the test ray, so they are left out. An edge spans
+    // the slabs strictly between those of its endpoints.
+    auto for_each_edge = [&](auto fn) {
+        auto pt1 = polygon.end() - 1;
+        auto pt2 = polygon.begin();
+        for(; pt2 != polygon.end(); pt1 = pt2, pt2++)
+        {
+            if(pt1->y == pt2->y) continue;
+            uint32_t first = slab(std::min(pt1->y, pt2->y));
+            uint32_t last = slab(std::max(pt1->y, pt2->y));
+            for(uint32_t s = first; s <= last; s++) fn(s, s > first && s < last, *pt1, *pt2);
+        }
+    };
+    span_start_.assign(slab_count_ + 1, 0);
+    end_start_.assign(slab_count_ + 1, 0);
+    for_each_edge([&](uint32_t s, bool spans, const Point2 &, const Point2 &) {
+        (spans ? span_start_ : end_start_)[s + 1]++;
+    });
+    for(uint32_t s = 1; s <= slab_count_; s++)
+    {
+        span_start_[s] += span_start_[s - 1];
+        end_start_[s] += end_start_[s - 1];
+    }
+    span_edges_.resize(2 * static_cast<size_t>(span_start_.back()));
+    span_up_.resize(span_start_.back());
+    end_edges_.resize(2 * static_cast<size_t>(end_start_.back()));
+    std::vector<uint32_t> span_fill(span_start_.begin(), span_start_.end() - 1);
+    std::vector<uint32_t> end_fill(end_start_.begin(), end_start_.end() - 1);
+    for_each_edge([&](uint32_t s, bool spans, const Point2 &p1, const Point2 &p2) {
+        if(spans)
+        {
+            uint32_t k = span_fill[s]++;
+            bool     up = (p2.y > p1.y);
+            span_edges_[2 * k] = up ? p1 : p2;
+            span_edges_[2 * k + 1] = up ? p2 : p1;
+            span_up_[k] = up ? 1 : 0;
+        }
+        else
+        {
+            uint32_t k = end_fill[s]++;
+            end_edges_[2 * k] = p1;
+            end_edges_[2 * k + 1] = p2;
+        }
+    });
+
+    // Sort each slab's spanning edges left to right. The binary search in
+    // contains() is only valid if they do not cross within the slab, which
+    // holds if each is clearly right of the one before it at y values
+    // below and above every y that maps to the slab.
+    span_sorted_.assign(slab_count_, 1);
+    auto x_at = [&](uint32_t k, double y) {
+        const Point2 &lo = span_edges_[2 * k], &hi = span_edges_[2 * k + 1];
+        return lo.x + (static_cast<double>(hi.x) - lo.x) * ((y - lo.y) / (hi.y - lo.y));
+    };
+    std::vector<uint32_t> order;
+    std::vector<Point2>   edges;
+    std::vector<uint8_t>  up;
+    for(uint32_t s = 0; s < slab_count_; s++)
+    {
+        uint32_t first = span_start_[s], last = span_start_[s + 1];
+        if(last - first < 2) continue;
+        double y_mid = min_.y + (s + 0.5) / slab_scale_;
+        order.resize(last - first);
+        for(uint32_t i = 0; i < order.size(); i++) order[i] = first + i;
+        std::sort(order.begin(), order.end(), [&](uint32_t l, uint32_t r) {
+            return x_at(l, y_mid) < x_at(r, y_mid);
+        });
+        edges.assign(span_edges_.begin() + 2 * first, span_edges_.begin() + 2 * last);
+        up.assign(span_up_.begin() + first, span_up_.begin() + last);
+        for(uint32_t i = 0; i < order.size(); i++)
+        {
+            span_edges_[2 * (first + i)] = edges[2 * (order[i] - first)];
+            span_edges_[2 * (first + i) + 1] = edges[2 * (order[i] - first) + 1];
+            span_up_[first + i] = up[order[i] - first];
+        }
+
+        // Every y in the slab is within [y_lo, y_hi] (allowing for the
+        // rounding in slab()). Edges sharing one endpoint are apart at
+        // every y in the slab, which their endpoints are strictly outside
+        // of; edges sharing both are the same line.
+        double margin = 1.0e-6 * (std::abs(min_.y) + std::abs(max_.y));
+        double y_lo = min_.y + s / static_cast<double>(slab_scale_) - margin;
+        double y_hi = min_.y + (s + 1) / static_cast<double>(slab_scale_) + margin;
+        for(uint32_t k = first; k + 1 < last && span_sorted_[s] != 0; k++)
+        {
+            const Point2 *a = &span_edges_[2 * k];
+            const Point2 *b = a + 2;
+
+            // Generous bound on the rounding error of x_at
+            double tol = 1.0e-9 * (std::abs(a[0].x) + std::abs(a[1].x) + std::abs(b[0].x) +
+                                   std::abs(b[1].x));
+            bool below = (a[0] == b[0]) || x_at(k + 1, y_lo) - x_at(k, y_lo) > tol;
+            bool above = (a[1] == b[1]) || x_at(k + 1, y_hi) - x_at(k, y_hi) > tol;
+            if(!below || !above || (a[0] == b[0] && a[1] == b[1])) span_sorted_[s] = 0;
+        }
+    }
+}
+
+bool PreparedPolygon::contains(const Point2 &p) const
+{
+    // Outside the bounds the crossing count is even (this also rejects
+    // NaN and the empty polygon)
+    if(!(p.y >= min_.y && p.y <= max_.y && p.x >= min_.x && p.x <= max_.x)) return false;
+
+    // Same crossing test as Point2::is_in_polygon on the edges that end in
+    // the slab. Edges are tested in a different order, which does not
+    // change the parity.
+    bool     inside = false;
+    uint32_t s = slab(p.y);
+    for(uint32_t k = end_start_[s]; k < end_start_[s + 1]; k++)
+    {
+        const Point2 &pt1 = end_edges_[2 * k];
+        const Point2 &pt2 = end_edges_[2 * k + 1];
+        bool          y2 = (pt2.y >= p.y);
+        if((pt1.y >= p.y) != y2 && (orient2d(pt1, pt2, p) >= 0.0) == y2) inside = !inside;
+    }
+
+    // Spanning edges all straddle the ray. One is crossed if p is left of
+    // it, or on it and the polygon edge points up (as is_in_polygon does).
+    uint32_t first = span_start_[s], last = span_start_[s + 1];
+    auto     side = [&](uint32_t k) {
+        return orient2d(span_edges_[2 * k], span_edges_[2 * k + 1], p);
+    };
+    uint32_t crossings = 0;
+    if(span_sorted_[s] != 0)
+    {
+        // Left to right, so p is strictly left of a suffix of the edges
+        uint32_t lo = first, hi = last;
+        while(lo < hi)
+        {
+            uint32_t mid = lo + (hi - lo) / 2;
+            if(side(mid) > 0.0) hi = mid;
+            else lo = mid + 1;
+        }
+        crossings = last - lo;
+        if(lo > first && span_up_[lo - 1] != 0 && side(lo - 1) == 0.0) crossings++;
+    }
+    else
+    {
+        for(uint32_t k = first; k < last; k++)
+        {
+            double o = side(k);
+            if(span_up_[k] != 0 ? o >= 0.0 : o > 0.0) crossings++;
+        }
+    }
+    return inside != ((crossings & 1) != 0);
+}
+
+bool PreparedPolygon::contains(const Point3 &p) const { return contains(project(p)); }
+
+size_t PreparedPolygon::contains(const Point2 *points,
+                                 size_t        count,
+                                 bool         *inside,
+                                 uint32_t      thread_count) const
+{
+    std::atomic<size_t> total(0);
+    parallel_for(count, thread_count, PARALLEL_MIN_POINTS, [&](size_t first, size_t last) {
+        size_t n = 0;
+        for(size_t i = first; i < last; i++)
+        {
+            inside[i] = contains(points[i]);
+            n += inside[i] ? 1 : 0;
+        }
+        total += n;
+    });
+    return total;
+}
+
+size_t PreparedPolygon::contains(const Point3 *points,
+                                 size_t        count,
+                                 bool         *inside,
+                                 uint32_t      thread_count) const
+{
+    std::atomic<size_t> total(0);
+    parallel_for(count, thread_count, PARALLEL_MIN_POINTS, [&](size_t first, size_t last) {
+        size_t n = 0;
+        for(size_t i = first; i < last; i++)
+        {
+            inside[i] = contains(project(points[i]));
+            n += inside[i] ? 1 : 0;
+        }
+        total += n;
+    });
+    return total;
+}
+
+uint32_t PreparedPolygon::slab(float y) const
+{
+    // Monotonic in y, so an edge's slab range covers every y it spans
+    float s = std::floor((y - min_.y) * slab_scale_);
+    if(!(s > 0.0f)) return 0; // Also catches NaN
+    return std::min(static_cast<uint32_t>(std::min(s, 1.0e9f)), slab_count_ - 1);
+}
+
+Point2 PreparedPolygon::project(const Point3 &p) const
+{
+    return Point2(component(p, u_axis_), component(p, v_axis_));
+}
+
+} // namespace cg
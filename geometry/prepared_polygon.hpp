@@ -0,0 +1,146 @@
+//============================================================================
+//	Johns Hopkins University Engineering for Professionals
+//	605.667 Computer Graphics and 605.767 Applied Computer Graphics
+//	Instructor:	Brian Russin
+//
+//	Author:  Kyle Meyer
+//	File:    prepared_polygon.hpp
+//	Purpose: Polygon preprocessed for repeated point containment tests.
+//           Edges are binned into horizontal slabs. Edges that cross a
+//           whole slab are kept in left to right order so a query counts
+//           the ones right of it with a binary search; only the few edges
+//           that end in the slab are tested one by one.
+//============================================================================
+
+#ifndef __GEOMETRY_PREPARED_POLYGON_HPP__
+#define __GEOMETRY_PREPARED_POLYGON_HPP__
+
+#include "geometry/point2.hpp"
+#include "geometry/point3.hpp"
+#include "geometry/vector3.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace cg
+{
+
+/**
+ * Polygon prepared for containment queries. Answers are identical to
+ * Point2::is_in_polygon (2D) or Point3::is_in_polygon (3D) with the polygon
+ * the object was built from, including points on the boundary. Works for
+ * any simple or self intersecting polygon (even-odd rule).
+ */
+class PreparedPolygon
+{
+  public:
+    /**
+     * Default constructor. Creates an empty polygon (contains nothing).
+     */
+    PreparedPolygon();
+
+    /**
+     * Constructor given a 2D polygon.
+     * @param  polygon  Polygon vertices (either orientation).
+     */
+    PreparedPolygon(const std::vector<Point2> &polygon);
+
+    /**
+     * Constructor given a planar 3D polygon and its normal.
+     * @param  polygon  Polygon vertices.
+     * @param  n        Normal to the polygon.
+     */
+    PreparedPolygon(const std::vector<Point3> &polygon, const Vector3 &n);
+
+    /**
+     * Builds (or rebuilds) from a 2D polygon.
+     * @param  polygon  Polygon vertices (either orientation).
+     */
+    void build(const std::vector<Point2> &polygon);
+
+    /**
+     * Builds (or rebuilds) from a planar 3D polygon. Like
+     * Point3::is_in_polygon, the polygon is projected to the axis plane
+     * that drops the largest component of the normal.
+     * @param  polygon  Polygon vertices.
+     * @param  n        Normal to the polygon.
+     */
+    void build(const std::vector<Point3> &polygon, const Vector3 &n);
+
+    /**
+     * Test if a point is inside the (2D) polygon.
+     * @param  p  Point to test.
+     * @return  Returns true if the point is inside the polygon, false if not.
+     */
+    bool contains(const Point2 &p) const;
+
+    /**
+     * Test if a point on the plane of the (3D) polygon is inside it.
+     * @param  p  Point to test.
+     * @return  Returns true if the point is inside the polygon, false if not.
+     */
+    bool contains(const Point3 &p) const;
+
+    /**
+     * Tests an array of points, split across threads for large counts.
+     * @param  points        Points to test.
+     * @param  count         Number of points.
+     * @param  inside        Receives count results.
+     * @param  thread_count  Number of threads (0 = one per core).
+     * @return  Returns the number of points inside.
+     */
+    size_t contains(const Point2 *points,
+                    size_t        count,
+                    bool         *inside,
+                    uint32_t      thread_count = 0) const;
+
+    /**
+     * Tests an array of points on the plane of the (3D) polygon, split
+     * across threads for large counts.
+     * @param  points        Points to test.
+     * @param  count         Number of points.
+     * @param  inside        Receives count results.
+     * @param  thread_count  Number of threads (0 = one per core).
+     * @return  Returns the number of points inside.
+     */
+    size_t contains(const Point3 *points,
+                    size_t        count,
+                    bool         *inside,
+                    uint32_t      thread_count = 0) const;
+
+  protected:
+    // Components of a 3D point used as the 2D x and y (0 = x, 1 = y, 2 = z)
+    uint32_t u_axis_;
+    uint32_t v_axis_;
+
+    // Bounds of the (projected) vertices
+    Point2 min_;
+    Point2 max_;
+
+    // Slab s covers y in [min_.y + s / slab_scale_, min_.y + (s + 1) /
+    // slab_scale_). Its non-horizontal edges are split into:
+    //  - spanning edges, which cross the whole slab: span_edges_[2k] (lower
+    //    end), span_edges_[2k + 1] (upper end), span_up_[k] (the polygon
+    //    edge points up) for k in [span_start_[s], span_start_[s + 1]).
+    //    Sorted left to right; span_sorted_[s] is 0 if they could not be
+    //    shown not to cross within the slab (then tested one by one).
+    //  - ending edges, with an endpoint in the slab: end_edges_[2k],
+    //    end_edges_[2k + 1] in polygon order for k in [end_start_[s],
+    //    end_start_[s + 1]).
+    float                 slab_scale_;
+    uint32_t              slab_count_;
+    std::vector<uint32_t> span_start_;
+    std::vector<Point2>   span_edges_;
+    std::vector<uint8_t>  span_up_;
+    std::vector<uint8_t>  span_sorted_;
+    std::vector<uint32_t> end_start_;
+    std::vector<Point2>   end_edges_;
+
+    uint32_t slab(float y) const;
+    Point2   project(const Point3 &p) const;
+};
+
+} // namespace cg
+
+#endif
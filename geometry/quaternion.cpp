@@ -0,0 +1,114 @@
+#include "geometry/quaternion.hpp"
+
+#include "geometry/geometry.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace cg
+{
+
+namespace
+{
+
+// Above this |cos| of the half angle slerp's sin(theta) loses precision;
+// the arc is short enough that nlerp gives the same result to float
+// precision
+constexpr float SLERP_NLERP_COS = 0.9995f;
+
+} // namespace
+
+Quaternion Quaternion::from_axis_angle(float angle, const Vector3 &axis)
+{
+    float length = axis.norm();
+    if(length == 0.0f) return Quaternion();
+    float half = degrees_to_radians(angle) * 0.5f;
+    float s = std::sin(half) / length;
+    return Quaternion(axis.x * s, axis.y * s, axis.z * s, std::cos(half));
+}
+
+Quaternion Quaternion::from_matrix(const Matrix4x4 &m)
+{
+    // Shepperd's method: solve for the largest of |x|, |y|, |z|, |w| from
+    // the diagonal so the division is well conditioned
+    float m00 = m.m00(), m11 = m.m11(), m22 = m.m22();
+    float trace = m00 + m11 + m22;
+    Quaternion q;
+    if(trace > 0.0f)
+    {
+        float s = 0.5f / std::sqrt(trace + 1.0f);
+        q = Quaternion((m.m21() - m.m12()) * s,
+                       (m.m02() - m.m20()) * s,
+                       (m.m10() - m.m01()) * s,
+                       0.25f / s);
+    }
+    else if(m00 > m11 && m00 > m22)
+    {
+        float s = 2.0f * std::sqrt(1.0f + m00 - m11 - m22);
+        q = Quaternion(0.25f * s,
+                       (m.m01() + m.m10()) / s,
+                       (m.m02() + m.m20()) / s,
+                       (m.m21() - m.m12()) / s);
+    }
+    else if(m11 > m22)
+    {
+        float s = 2.0f * std::sqrt(1.0f + m11 - m00 - m22);
+        q = Quaternion((m.m01() + m.m10()) / s,
+                       0.25f * s,
+                       (m.m12() + m.m21()) / s,
+                       (m.m02() - m.m20()) / s);
+    }
+    else
+    {
+        float s = 2.0f * std::sqrt(1.0f + m22 - m00 - m11);
+        q = Quaternion((m.m02() + m.m20()) / s,
+                       (m.m12() + m.m21()) / s,
+                       0.25f * s,
+                       (m.m10() - m.m01()) / s);
+    }
+    return q.normalize();
+}
+
+Matrix4x4 Quaternion::to_matrix() const
+{
+    float x2 = x + x, y2 = y + y, z2 = z + z;
+    float xx = x * x2, yy = y * y2, zz = z * z2;
+    float xy = x * y2, xz = x * z2, yz = y * z2;
+    float wx = w * x2, wy = w * y2, wz = w * z2;
+
+    // Column order
+    float a[16] = {1.0f - (yy + zz), xy + wz,          xz - wy,          0.0f,
+                   xy - wz,          1.0f - (xx + zz), yz + wx,          0.0f,
+                   xz + wy,          yz - wx,          1.0f - (xx + yy), 0.0f,
+                   0.0f,             0.0f,             0.0f,             1.0f};
+    Matrix4x4 m;
+    m.set(a);
+    return m;
+}
+
+Quaternion Quaternion::nlerp(const Quaternion &a, const Quaternion &b, float t)
+{
+    // q and -q are the same rotation: flip b to take the shorter arc
+    float      sign = (a.dot(b) < 0.0f) ? -t : t;
+    float      s = 1.0f - t;
+    Quaternion q(a.x * s + b.x * sign, a.y * s + b.y * sign, a.z * s + b.z * sign,
+                 a.w * s + b.w * sign);
+    return q.normalize();
+}
+
+Quaternion Quaternion::slerp(const Quaternion &a, const Quaternion &b, float t)
+{
+    float c = a.dot(b);
+    float flip = (c < 0.0f) ? -1.0f : 1.0f;
+    c = std::min(std::abs(c), 1.0f);
+    if(c > SLERP_NLERP_COS) return nlerp(a, b, t);
+
+    float theta = std::acos(c);
+    float inv_sin = 1.0f / std::sin(theta);
+    float wa = std::sin((1.0f - t) * theta) * inv_sin;
+    float wb = std::sin(t * theta) * inv_sin * flip;
+    return Quaternion(a.x * wa + b.x * wb, a.y * wa + b.y * wb, a.z * wa + b.z * wb,
+                      a.w * wa + b.w * wb);
+}
+
+} // namespace cg
@@ -0,0 +1,216 @@
+//============================================================================
+//	Johns Hopkins University Engineering for Professionals
+//	605.667 Computer Graphics and 605.767 Applied Computer Graphics
+//	Instructor:	Brian Russin
+//
+//	Author:  Kyle Meyer
+//	File:    quaternion.hpp
+//	Purpose: Quaternion for 3D rotations: composition, interpolation
+//           (nlerp / slerp) and conversion to and from Matrix4x4.
+//============================================================================
+
+#ifndef __GEOMETRY_QUATERNION_HPP__
+#define __GEOMETRY_QUATERNION_HPP__
+
+#include "geometry/constants.hpp"
+#include "geometry/matrix.hpp"
+#include "geometry/vector3.hpp"
+
+#include <cmath>
+#include <type_traits>
+
+namespace cg
+{
+
+/**
+ * Quaternion x i + y j + z k + w. A unit quaternion (x, y, z) = axis *
+ * sin(angle / 2), w = cos(angle / 2) represents a counterclockwise rotation
+ * about the axis. Products compose like matrices: (q * r).to_matrix() ==
+ * q.to_matrix() * r.to_matrix(), so r is applied first.
+ */
+struct Quaternion
+{
+    float x;
+    float y;
+    float z;
+    float w;
+
+    /**
+     * Default constructor. Sets the identity rotation.
+     */
+    constexpr Quaternion();
+
+    /**
+     * Constructor given the 4 components.
+     * @param  ix  x (i) component.
+     * @param  iy  y (j) component.
+     * @param  iz  z (k) component.
+     * @param  iw  w (real) component.
+     */
+    constexpr Quaternion(float ix, float iy, float iz, float iw);
+
+    /**
+     * Creates a rotation about an axis, as Matrix4x4::rotate.
+     * @param  angle  Angle (degrees) of counterclockwise rotation.
+     * @param  axis   Axis of rotation (need not be unit length).
+     * @return  Returns the unit quaternion (identity if the axis is 0).
+     */
+    static Quaternion from_axis_angle(float angle, const Vector3 &axis);
+
+    /**
+     * Creates a rotation from the upper 3x3 of a matrix.
+     * @param  m  Matrix whose upper 3x3 is a rotation (orthonormal with
+     *            determinant 1).
+     * @return  Returns the unit quaternion.
+     */
+    static Quaternion from_matrix(const Matrix4x4 &m);
+
+    /**
+     * Converts to a rotation matrix. No trigonometry is needed.
+     * @return  Returns the rotation matrix (translation 0).
+     */
+    Matrix4x4 to_matrix() const;
+
+    /**
+     * Composes rotations: r is applied first, then this one.
+     * @param  r  Rotation applied first.
+     * @return  Returns the product.
+     */
+    constexpr Quaternion operator*(const Quaternion &r) const;
+
+    /**
+     * Composes rotations in place (this = this * r).
+     * @param  r  Rotation applied first.
+     * @return  Returns the address of the current quaternion.
+     */
+    constexpr Quaternion &operator*=(const Quaternion &r);
+
+    /**
+     * Equality operator.
+     * @param  q  Quaternion to compare to.
+     * @return  Returns true if all components are equal.
+     */
+    constexpr bool operator==(const Quaternion &q) const;
+
+    /**
+     * Rotates a vector (this must be a unit quaternion).
+     * @param  v  Vector to rotate.
+     * @return  Returns the rotated vector.
+     */
+    constexpr Vector3 rotate(const Vector3 &v) const;
+
+    /**
+     * Gets the conjugate, which is the inverse rotation for a unit
+     * quaternion.
+     * @return  Returns the conjugate.
+     */
+    constexpr Quaternion conjugate() const;
+
+    /**
+     * Dot product of 2 quaternions (cosine of half the angle between the
+     * rotations when both are unit).
+     * @param  q  Quaternion to dot with.
+     * @return  Returns the dot product.
+     */
+    constexpr float dot(const Quaternion &q) const;
+
+    /**
+     * Computes the squared norm of the quaternion.
+     * @return  Returns the squared norm.
+     */
+    constexpr float norm_squared() const;
+
+    /**
+     * Normalizes the quaternion. Quaternions of norm EPSILON or less are
+     * left unchanged.
+     * @return  Returns the address of the current quaternion.
+     */
+    Quaternion &normalize();
+
+    /**
+     * Normalized linear interpolation along the shorter arc. Cheaper than
+     * slerp; the angular speed is not constant but the path is the same.
+     * @param  a  Start rotation (unit).
+     * @param  b  End rotation (unit).
+     * @param  t  Parameter in [0, 1].
+     * @return  Returns the unit quaternion.
+     */
+    static Quaternion nlerp(const Quaternion &a, const Quaternion &b, float t);
+
+    /**
+     * Spherical linear interpolation along the shorter arc (constant
+     * angular speed).
+     * @param  a  Start rotation (unit).
+     * @param  b  End rotation (unit).
+     * @param  t  Parameter in [0, 1].
+     * @return  Returns the unit quaternion.
+     */
+    static Quaternion slerp(const Quaternion &a, const Quaternion &b, float t);
+};
+
+static_assert(sizeof(Quaternion) == 4 * sizeof(float), "Quaternion must be tightly packed");
+static_assert(std::is_trivially_copyable<Quaternion>::value,
+              "Quaternion must be trivially copyable");
+
+// Inline methods
+
+constexpr Quaternion::Quaternion() : x(0.0f), y(0.0f), z(0.0f), w(1.0f) {}
+
+constexpr Quaternion::Quaternion(float ix, float iy, float iz, float iw)
+    : x(ix), y(iy), z(iz), w(iw)
+{
+}
+
+constexpr Quaternion Quaternion::operator*(const Quaternion &r) const
+{
+    return Quaternion(w * r.x + x * r.w + y * r.z - z * r.y,
+                      w * r.y - x * r.z + y * r.w + z * r.x,
+                      w * r.z + x * r.y - y * r.x + z * r.w,
+                      w * r.w - x * r.x - y * r.y - z * r.z);
+}
+
+constexpr Quaternion &Quaternion::operator*=(const Quaternion &r)
+{
+    *this = *this * r;
+    return *this;
+}
+
+constexpr bool Quaternion::operator==(const Quaternion &q) const
+{
+    return (x == q.x && y == q.y && z == q.z && w == q.w);
+}
+
+constexpr Vector3 Quaternion::rotate(const Vector3 &v) const
+{
+    // v + w t + u x t with t = 2 u x v (u = x, y, z)
+    Vector3 u(x, y, z);
+    Vector3 t = u.cross(v) * 2.0f;
+    return v + t * w + u.cross(t);
+}
+
+constexpr Quaternion Quaternion::conjugate() const { return Quaternion(-x, -y, -z, w); }
+
+constexpr float Quaternion::dot(const Quaternion &q) const
+{
+    return (x * q.x + y * q.y + z * q.z + w * q.w);
+}
+
+constexpr float Quaternion::norm_squared() const { return dot(*this); }
+
+inline Quaternion &Quaternion::normalize()
+{
+    float n = std::sqrt(norm_squared());
+    if(n > EPSILON)
+    {
+        float inv = 1.0f / n;
+        x *= inv;
+        y *= inv;
+        z *= inv;
+        w *= inv;
+    }
+    return *this;
+}
+
+} // namespace cg
+
+#endif
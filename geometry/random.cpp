@@ -0,0 +1,126 @@
+#include "geometry/random.hpp"
+
+#include "geometry/geometry.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+
+namespace cg
+{
+
+namespace
+{
+
+constexpr uint64_t DEFAULT_SEED = 0x853c49e6748fea9bull;
+
+// Jump polynomial for 2^64 steps of xoshiro128
+constexpr uint32_t JUMP[4] = {0x8764000b, 0xf542d2d3, 0x6fa035c3, 0x77f2db5b};
+
+// SplitMix64, to spread a seed over the whole state
+uint64_t split_mix(uint64_t &x)
+{
+    uint64_t z = (x += 0x9e3779b97f4a7c15ull);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+}
+
+} // namespace
+
+Random::Random() { seed(DEFAULT_SEED); }
+
+Random::Random(uint64_t seed_value) { seed(seed_value); }
+
+void Random::seed(uint64_t seed_value)
+{
+    // SplitMix64 never gives 2 zero outputs in a row, so the state is not
+    // all zero (which xoshiro cannot leave)
+    uint64_t x = seed_value;
+    uint64_t a = split_mix(x), b = split_mix(x);
+    s_[0] = static_cast<uint32_t>(a);
+    s_[1] = static_cast<uint32_t>(a >> 32);
+    s_[2] = static_cast<uint32_t>(b);
+    s_[3] = static_cast<uint32_t>(b >> 32);
+}
+
+Random Random::stream(uint64_t seed_value, uint32_t index)
+{
+    Random r(seed_value);
+    for(uint32_t i = 0; i < index; i++) r.jump();
+    return r;
+}
+
+void Random::jump()
+{
+    uint32_t s[4] = {0, 0, 0, 0};
+    for(uint32_t word : JUMP)
+    {
+        for(uint32_t b = 0; b < 32; b++)
+        {
+            if(word & (1u << b))
+            {
+                for(uint32_t i = 0; i < 4; i++) s[i] ^= s_[i];
+            }
+            next();
+        }
+    }
+    for(uint32_t i = 0; i < 4; i++) s_[i] = s[i];
+}
+
+Vector3 Random::on_sphere()
+{
+    // Uniform z and angle about z (Archimedes)
+    float z = 1.0f - 2.0f * uniform();
+    float phi = 2.0f * PI * uniform();
+    float r = std::sqrt(std::max(0.0f, 1.0f - z * z));
+    return Vector3(r * std::cos(phi), r * std::sin(phi), z);
+}
+
+Point3 Random::in_box(const Point3 &lo, const Point3 &hi)
+{
+    float x = uniform(lo.x, hi.x);
+    float y = uniform(lo.y, hi.y);
+    float z = uniform(lo.z, hi.z);
+    return Point3(x, y, z);
+}
+
+// The fills run on a local copy so the state stays in registers rather
+// than being stored back after every number
+
+void Random::fill_uniform(float *out, size_t count)
+{
+    Random r = *this;
+    for(size_t i = 0; i < count; i++) out[i] = r.uniform();
+    *this = r;
+}
+
+void Random::fill_uniform(float *out, size_t count, float lo, float hi)
+{
+    Random r = *this;
+    for(size_t i = 0; i < count; i++) out[i] = r.uniform(lo, hi);
+    *this = r;
+}
+
+void Random::fill_on_sphere(Vector3 *out, size_t count)
+{
+    Random r = *this;
+    for(size_t i = 0; i < count; i++) out[i] = r.on_sphere();
+    *this = r;
+}
+
+void Random::fill_in_box(Point3 *out, size_t count, const Point3 &lo, const Point3 &hi)
+{
+    Random r = *this;
+    for(size_t i = 0; i < count; i++) out[i] = r.in_box(lo, hi);
+    *this = r;
+}
+
+Random &thread_random()
+{
+    static std::atomic<uint32_t> next_stream(0);
+    thread_local Random          r = Random::stream(DEFAULT_SEED, next_stream++);
+    return r;
+}
+
+} // namespace cg
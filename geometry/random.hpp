@@ -0,0 +1,175 @@
+//============================================================================
+//	Johns Hopkins University Engineering for Professionals
+//	605.667 Computer Graphics and 605.767 Applied Computer Graphics
+//	Instructor:	Brian Russin
+//
+//	Author:  Kyle Meyer
+//	File:    random.hpp
+//	Purpose: Seedable pseudo-random number generator (xoshiro128+) with
+//           batched fills for sampling, jump ahead for independent
+//           parallel streams and a per-thread default generator.
+//============================================================================
+
+#ifndef __GEOMETRY_RANDOM_HPP__
+#define __GEOMETRY_RANDOM_HPP__
+
+#include "geometry/point3.hpp"
+#include "geometry/vector3.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace cg
+{
+
+/**
+ * xoshiro128+ generator (Blackman and Vigna). Small, fast and of good
+ * quality for floating point sampling; not for cryptographic use. A
+ * generator is not thread safe: use one per thread (thread_random()) or
+ * one stream per task (stream()) for results that do not depend on
+ * thread scheduling.
+ */
+class Random
+{
+  public:
+    /**
+     * Constructor. Uses a fixed default seed.
+     */
+    Random();
+
+    /**
+     * Constructor given a seed.
+     * @param  seed  Seed. Equal seeds give equal sequences.
+     */
+    explicit Random(uint64_t seed);
+
+    /**
+     * Restarts the generator from a seed.
+     * @param  seed  Seed. Equal seeds give equal sequences.
+     */
+    void seed(uint64_t seed);
+
+    /**
+     * Gets stream index of a seed: the generator seeded with seed then
+     * jumped index times. Streams do not overlap for 2^64 numbers, so each
+     * parallel task can draw from its own.
+     * @param  seed   Seed shared by all streams.
+     * @param  index  Stream (task) index.
+     * @return  Returns the generator for the stream.
+     */
+    static Random stream(uint64_t seed, uint32_t index);
+
+    /**
+     * Advances the generator by 2^64 numbers.
+     */
+    void jump();
+
+    /**
+     * Gets the next 32 random bits.
+     * @return  Returns a uniformly distributed 32 bit value.
+     */
+    uint32_t next();
+
+    /**
+     * Gets a uniform random number in [0, 1).
+     * @return  Returns the number (a multiple of 2^-24).
+     */
+    float uniform();
+
+    /**
+     * Gets a uniform random number in [lo, hi) (hi itself is possible
+     * through rounding).
+     * @param  lo  Lower bound.
+     * @param  hi  Upper bound.
+     * @return  Returns the number.
+     */
+    float uniform(float lo, float hi);
+
+    /**
+     * Gets a uniformly distributed unit vector.
+     * @return  Returns a random direction.
+     */
+    Vector3 on_sphere();
+
+    /**
+     * Gets a uniformly distributed point in a box.
+     * @param  lo  Minimum corner.
+     * @param  hi  Maximum corner.
+     * @return  Returns the point.
+     */
+    Point3 in_box(const Point3 &lo, const Point3 &hi);
+
+    /**
+     * Fills an array with uniform random numbers in [0, 1). Same values as
+     * calling uniform() count times.
+     * @param  out    Receives count values.
+     * @param  count  Number of values.
+     */
+    void fill_uniform(float *out, size_t count);
+
+    /**
+     * Fills an array with uniform random numbers in [lo, hi). Same values
+     * as calling uniform(lo, hi) count times.
+     * @param  out    Receives count values.
+     * @param  count  Number of values.
+     * @param  lo     Lower bound.
+     * @param  hi     Upper bound.
+     */
+    void fill_uniform(float *out, size_t count, float lo, float hi);
+
+    /**
+     * Fills an array with uniformly distributed unit vectors. Same values
+     * as calling on_sphere() count times.
+     * @param  out    Receives count directions.
+     * @param  count  Number of directions.
+     */
+    void fill_on_sphere(Vector3 *out, size_t count);
+
+    /**
+     * Fills an array with uniformly distributed points in a box. Same
+     * values as calling in_box(lo, hi) count times.
+     * @param  out    Receives count points.
+     * @param  count  Number of points.
+     * @param  lo     Minimum corner.
+     * @param  hi     Maximum corner.
+     */
+    void fill_in_box(Point3 *out, size_t count, const Point3 &lo, const Point3 &hi);
+
+  protected:
+    uint32_t s_[4];
+};
+
+/**
+ * Gets the calling thread's generator. Each thread gets its own stream of
+ * the default seed, numbered in the order threads first call this.
+ * @return  Returns the generator for this thread.
+ */
+Random &thread_random();
+
+// Inline methods
+
+inline uint32_t Random::next()
+{
+    uint32_t result = s_[0] + s_[3];
+    uint32_t t = s_[1] << 9;
+    s_[2] ^= s_[0];
+    s_[3] ^= s_[1];
+    s_[1] ^= s_[2];
+    s_[0] ^= s_[3];
+    s_[2] ^= t;
+    s_[3] = (s_[3] << 11) | (s_[3] >> 21);
+    return result;
+}
+
+inline float Random::uniform()
+{
+    // The upper 24 bits are the best ones of xoshiro128+ and fill a
+    // float mantissa exactly
+    return static_cast<float>(next() >> 8) * (1.0f / 16777216.0f);
+}
+
+inline float Random::uniform(float lo, float hi) { return lo + (hi - lo) * uniform(); }
+
+} // namespace cg
+
+#endif
@@ -2,16 +2,70 @@
 
 #include "geometry/geometry.hpp"
 
+#include <algorithm>
 #include <cmath>
+#include <limits>
 
 namespace cg
 {
 
+namespace
+{
+
+const Point3 &position(const Point3 &v) { return v; }
+const Point3 &position(const VertexAndNormal &v) { return v.vertex; }
+
+// Nearest triangle closer than t_min. Shared by the 16 and 32 bit index
+// versions of Ray3::intersect.
+template <typename Index>
+RayMeshIntersectResult intersect_mesh(const Ray3                &ray,
+                                      const std::vector<Point3> &vertex_list,
+                                      const std::vector<Index>  &face_list,
+                                      float                      t_min)
+{
+    RayMeshIntersectResult result{false, t_min, 0.0f, 0.0f, 0};
+    for(size_t i = 0; i + 2 < face_list.size(); i += 3)
+    {
+        RayTriangleIntersectResult hit = ray.intersect(vertex_list[face_list[i]],
+                                                       vertex_list[face_list[i + 1]],
+                                                       vertex_list[face_list[i + 2]]);
+        if(hit.intersects && hit.distance < result.distance)
+        {
+            result = {true,
+                      hit.distance,
+                      hit.barycentric_u,
+                      hit.barycentric_v,
+                      static_cast<uint32_t>(i / 3)};
+        }
+    }
+    if(!result.intersects) { result.distance = 0.0f; }
+    return result;
+}
+
+// Any triangle closer than t_min. Vertex is Point3 or VertexAndNormal.
+template <typename Vertex, typename Index>
+bool mesh_intersect_exists(const Ray3                &ray,
+                           const std::vector<Vertex> &vertex_list,
+                           const std::vector<Index>  &face_list,
+                           float                      t_min)
+{
+    for(size_t i = 0; i + 2 < face_list.size(); i += 3)
+    {
+        RayTriangleIntersectResult hit = ray.intersect(position(vertex_list[face_list[i]]),
+                                                       position(vertex_list[face_list[i + 1]]),
+                                                       position(vertex_list[face_list[i + 2]]));
+        if(hit.intersects && hit.distance < t_min) { return true; }
+    }
+    return false;
+}
+
+} // namespace
+
 Ray3::Ray3() : o{0.0f, 0.0f, 0.0f}, d{1.0f, 0.0f, 0.0f} {}
 
-Ray3::Ray3(const Point3 &p1, const Point3 &p2, bool normalize)
+Ray3::Ray3(const Point3 &p1, const Point3 &p2, bool normalize) : o(p1), d(p2 - p1)
 {
-    // Student to define - Module 5
+    if(normalize) { d.normalize(); }
 }
 
 Ray3::Ray3(const Point3 &origin, const Vector3 &dir) : o(origin), d(dir) {}
@@ -25,81 +79,210 @@ Ray3::Ray3(const Point3 &origin, const Vector3 &dir, bool normalize)
 
 Ray3 Ray3::reflect(const Point3 &int_pt, const Vector3 &n) const
 {
-    // Required in 605.767
-    return Ray3();
+    return Ray3(int_pt, d.reflect(n));
 }
 
 RayRefractionResult Ray3::refract(const Point3 &int_pt, Vector3 &n, float u1, float u2) const
 {
-    // Required in 605.767
-    return RayRefractionResult{};
+    // Snell's law with the normal facing the incoming ray
+    float cos_i = -n.dot(d);
+    if(cos_i < 0.0f)
+    {
+        n = n * -1.0f;
+        cos_i = -cos_i;
+    }
+    float ratio = u1 / u2;
+    float k = 1.0f - ratio * ratio * (1.0f - cos_i * cos_i);
+    if(k < 0.0f) { return {reflect(int_pt, n), true}; }
+    Vector3 t = d * ratio + n * (ratio * cos_i - std::sqrt(k));
+    return {Ray3(int_pt, t, true), false};
 }
 
-Point3 Ray3::intersect(float t) const
-{
-    // Student to define - Module 5
-    return Point3();
-}
+Point3 Ray3::intersect(float t) const { return o + d * t; }
 
 RayObjectIntersectResult Ray3::intersect(const Plane &p) const
 {
-    // Required in 605.767
-    return RayObjectIntersectResult{false, 0.0f};
+    // Solve n.(o + t d) = d_plane for t. No intersection if the ray is
+    // parallel to the plane or the plane is behind the ray origin.
+    float denom = p.a * d.x + p.b * d.y + p.c * d.z;
+    if(std::abs(denom) < EPSILON) { return {false, 0.0f}; }
+    float t = -p.solve(o) / denom;
+    if(t < 0.0f) { return {false, 0.0f}; }
+    return {true, t};
 }
+
 RayObjectIntersectResult Ray3::intersect(const BoundingSphere &sphere) const
 {
-    // Student to define - Module 5
-    return {false, 0.0f};
+    // Vector from the ray origin to the sphere center and its component
+    // along the (unit length) ray direction
+    Vector3 v = sphere.center - o;
+    float   t_ca = v.dot(d);
+    float   v_sq = v.norm_squared();
+    float   r_sq = sphere.radius * sphere.radius;
+    bool    outside = v_sq > r_sq;
+
+    // Sphere is behind the ray origin
+    if(outside && t_ca < 0.0f) { return {false, 0.0f}; }
+
+    // Squared distance from the sphere center to the closest point on the ray
+    float dist_sq = v_sq - t_ca * t_ca;
+    if(dist_sq > r_sq) { return {false, 0.0f}; }
+
+    // Nearest intersection if outside, otherwise the exit point
+    float t_hc = std::sqrt(r_sq - dist_sq);
+    return {true, outside ? t_ca - t_hc : t_ca + t_hc};
 }
 
 RayObjectIntersectResult Ray3::intersect(const AABB &box) const
 {
-    // Required in 605.767
-    return {false, 0.0f};
+    // Slab method: intersect the parameter ranges between each pair of
+    // parallel planes. Division by a zero direction component gives +/-
+    // infinity, which the min / max handle correctly.
+    const float o_c[3] = {o.x, o.y, o.z};
+    const float d_c[3] = {d.x, d.y, d.z};
+    const float lo[3] = {box.min_corner.x, box.min_corner.y, box.min_corner.z};
+    const float hi[3] = {box.max_corner.x, box.max_corner.y, box.max_corner.z};
+    float       t_near = 0.0f;
+    float       t_far = std::numeric_limits<float>::infinity();
+    for(int32_t i = 0; i < 3; i++)
+    {
+        float inv = 1.0f / d_c[i];
+        float t0 = (lo[i] - o_c[i]) * inv;
+        float t1 = (hi[i] - o_c[i]) * inv;
+        if(t0 > t1) std::swap(t0, t1);
+        t_near = std::max(t_near, t0);
+        t_far = std::min(t_far, t1);
+        if(t_near > t_far) { return {false, 0.0f}; }
+    }
+    return {true, t_near};
 }
 
 RayObjectIntersectResult Ray3::intersect(const std::vector<Point3> &polygon,
                                          const Vector3             &normal) const
 {
-    // Required in 605.767
-    return {false, 0.0f};
+    if(polygon.size() < 3) { return {false, 0.0f}; }
+
+    // Intersect the plane of the polygon
+    RayObjectIntersectResult result = intersect(Plane(polygon[0], normal));
+    if(!result.intersects) { return result; }
+
+    // Inside a convex polygon if the point is on the inner side of every edge
+    Point3 p = intersect(result.distance);
+    size_t n = polygon.size();
+    for(size_t i = 0; i < n; i++)
+    {
+        const Point3 &a = polygon[i];
+        const Point3 &b = polygon[(i + 1) % n];
+        if((b - a).cross(p - a).dot(normal) < 0.0f) { return {false, 0.0f}; }
+    }
+    return result;
 }
 
 RayTriangleIntersectResult
     Ray3::intersect(const Point3 &v0, const Point3 &v1, const Point3 &v2) const
 {
-    // Required in 605.767
-    return {false, 0.0f, 0.0f, 0.0f};
+    // Moller-Trumbore: solve o + t d = v0 + u e1 + v e2
+    Vector3 e1 = v1 - v0;
+    Vector3 e2 = v2 - v0;
+    Vector3 p = d.cross(e2);
+    float   det = e1.dot(p);
+    if(std::abs(det) < EPSILON) { return {false, 0.0f, 0.0f, 0.0f}; }
+
+    float   inv_det = 1.0f / det;
+    Vector3 s = o - v0;
+    float   u = s.dot(p) * inv_det;
+    if(u < 0.0f || u > 1.0f) { return {false, 0.0f, 0.0f, 0.0f}; }
+
+    Vector3 q = s.cross(e1);
+    float   v = d.dot(q) * inv_det;
+    if(v < 0.0f || u + v > 1.0f) { return {false, 0.0f, 0.0f, 0.0f}; }
+
+    float t = e2.dot(q) * inv_det;
+    if(t < 0.0f) { return {false, 0.0f, 0.0f, 0.0f}; }
+    return {true, t, u, v};
 }
 
 bool Ray3::does_intersect_exist(const Point3 &v0, const Point3 &v1, const Point3 &v2) const
 {
-    // Required in 605.767
-    return false;
+    return intersect(v0, v1, v2).intersects;
 }
 
 RayMeshIntersectResult Ray3::intersect(const std::vector<Point3>   &vertex_list,
                                        const std::vector<uint16_t> &face_list,
                                        float                        t_min) const
 {
-    // Required in 605.767
-    return {false, 0.0f, 0.0f, 0.0f, 0};
+    return intersect_mesh(*this, vertex_list, face_list, t_min);
+}
+
+RayMeshIntersectResult Ray3::intersect(const std::vector<Point3>   &vertex_list,
+                                       const std::vector<uint32_t> &face_list,
+                                       float                        t_min) const
+{
+    return intersect_mesh(*this, vertex_list, face_list, t_min);
+}
+
+RayMeshIntersectResult Ray3::intersect(const std::vector<Point3> &vertex_list,
+                                       const IndexBuffer         &face_list,
+                                       float                      t_min) const
+{
+    return face_list.is_16_bit() ? intersect(vertex_list, face_list.indices16(), t_min)
+                                 : intersect(vertex_list, face_list.indices32(), t_min);
 }
 
 bool Ray3::does_intersect_exist(const std::vector<Point3>   &vertex_list,
                                 const std::vector<uint16_t> &face_list,
                                 float                        t_min) const
 {
-    // Required in 605.767
-    return false;
+    return mesh_intersect_exists(*this, vertex_list, face_list, t_min);
+}
+
+bool Ray3::does_intersect_exist(const std::vector<Point3>   &vertex_list,
+                                const std::vector<uint32_t> &face_list,
+                                float                        t_min) const
+{
+    return mesh_intersect_exists(*this, vertex_list, face_list, t_min);
+}
+
+bool Ray3::does_intersect_exist(const std::vector<Point3> &vertex_list,
+                                const IndexBuffer         &face_list,
+                                float                      t_min) const
+{
+    return face_list.is_16_bit()
+               ? does_intersect_exist(vertex_list, face_list.indices16(), t_min)
+               : does_intersect_exist(vertex_list, face_list.indices32(), t_min);
 }
 
 bool Ray3::does_intersect_exist(const std::vector<VertexAndNormal> &vertex_list,
                                 const std::vector<uint16_t>        &face_list,
                                 float                               t_min) const
 {
-    // Required in 605.767
-    return false;
+    return mesh_intersect_exists(*this, vertex_list, face_list, t_min);
+}
+
+bool Ray3::does_intersect_exist(const std::vector<VertexAndNormal> &vertex_list,
+                                const std::vector<uint32_t>        &face_list,
+                                float                               t_min) const
+{
+    return mesh_intersect_exists(*this, vertex_list, face_list, t_min);
+}
+
+bool Ray3::does_intersect_exist(const std::vector<VertexAndNormal> &vertex_list,
+                                const IndexBuffer                  &face_list,
+                                float                               t_min) const
+{
+    return face_list.is_16_bit()
+               ? does_intersect_exist(vertex_list, face_list.indices16(), t_min)
+               : does_intersect_exist(vertex_list, face_list.indices32(), t_min);
+}
+
+RayMeshIntersectResult Ray3::intersect(const BVH &bvh, float t_min) const
+{
+    return bvh.intersect(*this, t_min);
+}
+
+bool Ray3::does_intersect_exist(const BVH &bvh, float t_min) const
+{
+    return bvh.does_intersect_exist(*this, t_min);
 }
 
 } // namespace cg
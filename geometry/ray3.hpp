@@ -13,6 +13,7 @@
 
 #include "geometry/aabb.hpp"
 #include "geometry/bounding_sphere.hpp"
+#include "geometry/index_buffer.hpp"
 #include "geometry/plane.hpp"
 #include "geometry/point3.hpp"
 #include "geometry/types.hpp"
@@ -25,6 +26,7 @@ namespace cg
 {
 
 // Forward Declarations
+class BVH;
 struct RayRefractionResult;
 struct RayObjectIntersectResult;
 struct RayTriangleIntersectResult;
@@ -167,6 +169,34 @@ struct Ray3
                                      const std::vector<uint16_t> &face_list,
                                      float                        t_min) const;
 
+    /**
+     * Calculates the intersect of a ray and a triangle mesh object with 32 bit
+     * indices (more than 65536 vertices).
+     * @param vertex_list Vertex list of the triangle mesh.
+     * @param face_list   Face index list.
+     * @param t_min       Current minimum intersection (t) value along the ray.
+     * @return Returns whether or not there is an intersection, the distance
+     *         at which the intersection occurs (0.0 if no intersection),
+     *         the barycentric coordinates of intersection, and the face index.
+     */
+    RayMeshIntersectResult intersect(const std::vector<Point3>   &vertex_list,
+                                     const std::vector<uint32_t> &face_list,
+                                     float                        t_min) const;
+
+    /**
+     * Calculates the intersect of a ray and a triangle mesh object with 16 or
+     * 32 bit indices.
+     * @param vertex_list Vertex list of the triangle mesh.
+     * @param face_list   Face index list.
+     * @param t_min       Current minimum intersection (t) value along the ray.
+     * @return Returns whether or not there is an intersection, the distance
+     *         at which the intersection occurs (0.0 if no intersection),
+     *         the barycentric coordinates of intersection, and the face index.
+     */
+    RayMeshIntersectResult intersect(const std::vector<Point3> &vertex_list,
+                                     const IndexBuffer         &face_list,
+                                     float                      t_min) const;
+
     /**
      * Does an intersection exist between ray and a triangle mesh. The intersection
      * must occur prior to t_min (intersection value t between 0 and t_min).
@@ -179,6 +209,30 @@ struct Ray3
                               const std::vector<uint16_t> &face_list,
                               float                        t_min) const;
 
+    /**
+     * Does an intersection exist between ray and a triangle mesh with 32 bit
+     * indices. The intersection must occur prior to t_min.
+     * @param vertex_list Vertex list of the triangle mesh.
+     * @param face_list   Face index list.
+     * @param t_min       t value for intersection.
+     * @return Returns true if an intersection exists, false if not.
+     */
+    bool does_intersect_exist(const std::vector<Point3>   &vertex_list,
+                              const std::vector<uint32_t> &face_list,
+                              float                        t_min) const;
+
+    /**
+     * Does an intersection exist between ray and a triangle mesh with 16 or
+     * 32 bit indices. The intersection must occur prior to t_min.
+     * @param vertex_list Vertex list of the triangle mesh.
+     * @param face_list   Face index list.
+     * @param t_min       t value for intersection.
+     * @return Returns true if an intersection exists, false if not.
+     */
+    bool does_intersect_exist(const std::vector<Point3> &vertex_list,
+                              const IndexBuffer         &face_list,
+                              float                      t_min) const;
+
     /**
      * Does an intersection exist between ray and a triangle mesh. The intersection
      * must occur prior to t_min (intersection value t between 0 and t_min).
@@ -190,6 +244,52 @@ struct Ray3
     bool does_intersect_exist(const std::vector<VertexAndNormal> &vertex_list,
                               const std::vector<uint16_t>        &face_list,
                               float                               t_min) const;
+
+    /**
+     * Does an intersection exist between ray and a triangle mesh with 32 bit
+     * indices. The intersection must occur prior to t_min.
+     * @param vertex_list Vertex list of the triangle mesh.
+     * @param face_list   Face index list.
+     * @param t_min       t value for intersection.
+     * @return Returns true if an intersection exists, false if not.
+     */
+    bool does_intersect_exist(const std::vector<VertexAndNormal> &vertex_list,
+                              const std::vector<uint32_t>        &face_list,
+                              float                               t_min) const;
+
+    /**
+     * Does an intersection exist between ray and a triangle mesh with 16 or
+     * 32 bit indices. The intersection must occur prior to t_min.
+     * @param vertex_list Vertex list of the triangle mesh.
+     * @param face_list   Face index list.
+     * @param t_min       t value for intersection.
+     * @return Returns true if an intersection exists, false if not.
+     */
+    bool does_intersect_exist(const std::vector<VertexAndNormal> &vertex_list,
+                              const IndexBuffer                  &face_list,
+                              float                               t_min) const;
+
+    /**
+     * Calculates the intersect of a ray and a triangle mesh using the mesh's
+     * bounding volume hierarchy. Returns the same result as the vertex / face
+     * list version without testing every face.
+     * @param bvh    Hierarchy built from the triangle mesh.
+     * @param t_min  Current minimum intersection (t) value along the ray.
+     * @return Returns whether or not there is an intersection, the distance
+     *         at which the intersection occurs (0.0 if no intersection),
+     *         the barycentric coordinates of intersection, and the face index.
+     */
+    RayMeshIntersectResult intersect(const BVH &bvh, float t_min) const;
+
+    /**
+     * Does an intersection exist between ray and a triangle mesh, using the
+     * mesh's bounding volume hierarchy. The intersection must occur prior to
+     * t_min.
+     * @param bvh    Hierarchy built from the triangle mesh.
+     * @param t_min  t value for intersection.
+     * @return Returns true if an intersection exists, false if not.
+     */
+    bool does_intersect_exist(const BVH &bvh, float t_min) const;
 };
 
 struct RayRefractionResult
@@ -0,0 +1,376 @@
+//============================================================================
+//	Johns Hopkins University Engineering for Professionals
+//	605.667 Computer Graphics and 605.767 Applied Computer Graphics
+//	Instructor:	Brian Russin
+//
+//	Author:  Kyle Meyer
+//	File:    ray_packet.hpp
+//	Purpose: Packets of N rays intersected against one object at a time,
+//           and packets of N boxes intersected against one ray. Each test
+//           returns a per-lane hit mask and distance. Lane results match
+//           the Ray3 intersection methods for the same ray.
+//============================================================================
+
+#ifndef __GEOMETRY_RAY_PACKET_HPP__
+#define __GEOMETRY_RAY_PACKET_HPP__
+
+#include "geometry/aabb.hpp"
+#include "geometry/bounding_sphere.hpp"
+#include "geometry/plane.hpp"
+#include "geometry/ray3.hpp"
+#include "geometry/vector3_packet.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+
+namespace cg
+{
+
+/**
+ * Narrows [t_near, t_far] to a slab's parameter range [t0, t1] the way
+ * Ray3::intersect(const AABB &) does: t0 and t1 are swapped only if t0 > t1
+ * and then applied as max(t_near, t0), min(t_far, t1). A ray starting on a
+ * slab plane and parallel to it gives 0 * inf = NaN, which leaves t_near or
+ * t_far unchanged in both.
+ */
+template <size_t N>
+void order_slab(const FloatxN<N> &t0,
+                const FloatxN<N> &t1,
+                FloatxN<N>       &t_near,
+                FloatxN<N>       &t_far)
+{
+    MaskxN<N> swap = t0 > t1;
+    t_near = packet_max(t_near, select(swap, t1, t0));
+    t_far = packet_min(t_far, select(swap, t0, t1));
+}
+
+/**
+ * Result of intersecting a ray packet with an object. Distance is 0 in
+ * lanes that miss.
+ */
+template <size_t N>
+struct RayPacketHit
+{
+    MaskxN<N>  hit;
+    FloatxN<N> distance;
+
+    /**
+     * Gets the result for one lane.
+     * @param  i  Lane index.
+     * @return  Returns the lane result in the form Ray3 returns.
+     */
+    RayObjectIntersectResult get(size_t i) const { return {hit[i], distance[i]}; }
+};
+
+/**
+ * Result of intersecting a ray packet with a triangle. Distance and
+ * barycentric coordinates are 0 in lanes that miss.
+ */
+template <size_t N>
+struct RayPacketTriangleHit
+{
+    MaskxN<N>  hit;
+    FloatxN<N> distance;
+    FloatxN<N> barycentric_u;
+    FloatxN<N> barycentric_v;
+
+    /**
+     * Gets the result for one lane.
+     * @param  i  Lane index.
+     * @return  Returns the lane result in the form Ray3 returns.
+     */
+    RayTriangleIntersectResult get(size_t i) const
+    {
+        return {hit[i], distance[i], barycentric_u[i], barycentric_v[i]};
+    }
+};
+
+/**
+ * N rays stored as structure of arrays. Lanes that were not loaded are
+ * inactive and never report a hit.
+ */
+template <size_t N>
+struct RayPacket
+{
+    Point3xN<N>  o;      // Ray origins
+    Vector3xN<N> d;      // Ray directions
+    Vector3xN<N> inv_d;  // 1 / d per component, used by the slab test
+    MaskxN<N>    active; // Lanes holding a ray
+
+    /**
+     * Loads up to N rays.
+     * @param  rays   Source rays.
+     * @param  count  Number of rays to read (at most N).
+     * @return  Returns the packet.
+     */
+    static RayPacket load(const Ray3 *rays, size_t count = N)
+    {
+        RayPacket r;
+        size_t    n = std::min(count, N);
+        for(size_t i = 0; i < n; i++)
+        {
+            r.o.set(i, rays[i].o);
+            r.d.set(i, rays[i].d);
+        }
+        for(size_t i = n; i < N; i++)
+        {
+            r.o.set(i, Point3());
+            r.d.set(i, Vector3(1.0f, 0.0f, 0.0f));
+        }
+        for(size_t i = 0; i < N; i++) r.active.set(i, i < n);
+        FloatxN<N> one = FloatxN<N>::broadcast(1.0f);
+        r.inv_d = {one / r.d.x, one / r.d.y, one / r.d.z};
+        return r;
+    }
+
+    /**
+     * Gets one ray.
+     * @param  i  Lane index.
+     * @return  Returns the ray in lane i.
+     */
+    Ray3 get(size_t i) const { return Ray3(o.get(i), d.get(i)); }
+
+    /**
+     * Intersection of the rays with a plane. Same rules as Ray3.
+     * @param  p  Plane to test intersection with.
+     * @return Returns the lanes that intersect and their distances.
+     */
+    RayPacketHit<N> intersect(const Plane &p) const
+    {
+        FloatxN<N> denom = d.x * p.a + d.y * p.b + d.z * p.c;
+        FloatxN<N> solve = o.x * p.a + o.y * p.b + o.z * p.c - p.d;
+        FloatxN<N> t = -solve / denom;
+        MaskxN<N>  hit = active & (packet_abs(denom) >= EPSILON) & (t >= 0.0f);
+        return {hit, select(hit, t, FloatxN<N>::broadcast(0.0f))};
+    }
+
+    /**
+     * Intersection of the rays and a sphere. Assumes unit length directions,
+     * as Ray3 does.
+     * @param  sphere  Sphere to test intersection with.
+     * @return Returns the lanes that intersect and their distances.
+     */
+    RayPacketHit<N> intersect(const BoundingSphere &sphere) const
+    {
+        Vector3xN<N> v = Point3xN<N>::broadcast(sphere.center) - o;
+        FloatxN<N>   t_ca = v.dot(d);
+        FloatxN<N>   v_sq = v.norm_squared();
+        float        r_sq = sphere.radius * sphere.radius;
+        MaskxN<N>    outside = v_sq > r_sq;
+        FloatxN<N>   dist_sq = v_sq - t_ca * t_ca;
+        MaskxN<N>    hit = active & ~(outside & (t_ca < 0.0f)) & (dist_sq <= r_sq);
+
+        FloatxN<N> t_hc = packet_sqrt(packet_max(-dist_sq + r_sq, FloatxN<N>::broadcast(0.0f)));
+        FloatxN<N> t = select(outside, t_ca - t_hc, t_ca + t_hc);
+        return {hit, select(hit, t, FloatxN<N>::broadcast(0.0f))};
+    }
+
+    /**
+     * Intersection of the rays and an axis aligned bounding box (slab test).
+     * @param  box  AABB to test intersection with.
+     * @return Returns the lanes that intersect and their distances.
+     */
+    RayPacketHit<N> intersect(const AABB &box) const
+    {
+        FloatxN<N> t_near = FloatxN<N>::broadcast(0.0f);
+        FloatxN<N> t_far = FloatxN<N>::broadcast(std::numeric_limits<float>::infinity());
+        slab(o.x, inv_d.x, box.min_corner.x, box.max_corner.x, t_near, t_far);
+        slab(o.y, inv_d.y, box.min_corner.y, box.max_corner.y, t_near, t_far);
+        slab(o.z, inv_d.z, box.min_corner.z, box.max_corner.z, t_near, t_far);
+        MaskxN<N> hit = active & (t_near <= t_far);
+        return {hit, select(hit, t_near, FloatxN<N>::broadcast(0.0f))};
+    }
+
+    /**
+     * Intersection of the rays with a triangle (Moller-Trumbore).
+     * @param   v0  Vertex of the triangle
+     * @param   v1  Vertex of the triangle
+     * @param   v2  Vertex of the triangle
+     * @return Returns the lanes that intersect, their distances and the
+     *         barycentric coordinates of intersection.
+     */
+    RayPacketTriangleHit<N> intersect(const Point3 &v0, const Point3 &v1, const Point3 &v2) const
+    {
+        Vector3xN<N> e1 = Vector3xN<N>::broadcast(v1 - v0);
+        Vector3xN<N> e2 = Vector3xN<N>::broadcast(v2 - v0);
+        Vector3xN<N> p = d.cross(e2);
+        FloatxN<N>   det = e1.dot(p);
+        FloatxN<N>   inv_det = FloatxN<N>::broadcast(1.0f) / det;
+        Vector3xN<N> s = o - Point3xN<N>::broadcast(v0);
+        FloatxN<N>   u = s.dot(p) * inv_det;
+        Vector3xN<N> q = s.cross(e1);
+        FloatxN<N>   v = d.dot(q) * inv_det;
+        FloatxN<N>   t = e2.dot(q) * inv_det;
+
+        MaskxN<N> hit = active & (packet_abs(det) >= EPSILON) & (u >= 0.0f) & (u <= 1.0f) &
+                        (v >= 0.0f) & (u + v <= 1.0f) & (t >= 0.0f);
+        FloatxN<N> zero = FloatxN<N>::broadcast(0.0f);
+        return {hit, select(hit, t, zero), select(hit, u, zero), select(hit, v, zero)};
+    }
+
+  private:
+    // Narrows [t_near, t_far] to the parameter range between two parallel
+    // planes of a box
+    static void slab(const FloatxN<N> &o_c,
+                     const FloatxN<N> &inv_d_c,
+                     float             lo,
+                     float             hi,
+                     FloatxN<N>       &t_near,
+                     FloatxN<N>       &t_far)
+    {
+        FloatxN<N> t0 = (FloatxN<N>::broadcast(lo) - o_c) * inv_d_c;
+        FloatxN<N> t1 = (FloatxN<N>::broadcast(hi) - o_c) * inv_d_c;
+        order_slab(t0, t1, t_near, t_far);
+    }
+};
+
+/**
+ * N axis aligned boxes stored as structure of arrays, for testing one ray
+ * against many boxes. Lanes that were not loaded are inactive.
+ */
+template <size_t N>
+struct AABBxN
+{
+    Point3xN<N> min_corner;
+    Point3xN<N> max_corner;
+    MaskxN<N>   active;
+
+    /**
+     * Loads up to N boxes.
+     * @param  boxes  Source boxes.
+     * @param  count  Number of boxes to read (at most N).
+     * @return  Returns the packet.
+     */
+    static AABBxN load(const AABB *boxes, size_t count = N)
+    {
+        AABBxN r;
+        size_t n = std::min(count, N);
+        for(size_t i = 0; i < n; i++)
+        {
+            r.min_corner.set(i, boxes[i].min_corner);
+            r.max_corner.set(i, boxes[i].max_corner);
+        }
+        for(size_t i = n; i < N; i++)
+        {
+            r.min_corner.set(i, Point3());
+            r.max_corner.set(i, Point3());
+        }
+        for(size_t i = 0; i < N; i++) r.active.set(i, i < n);
+        return r;
+    }
+
+    /**
+     * Slab test of one ray against every box. Same result per lane as
+     * Ray3::intersect(const AABB &).
+     * @param  ray  Ray to test.
+     * @return Returns the boxes that intersect and their entry distances.
+     */
+    RayPacketHit<N> intersect(const Ray3 &ray) const
+    {
+        FloatxN<N> t_near = FloatxN<N>::broadcast(0.0f);
+        FloatxN<N> t_far = FloatxN<N>::broadcast(std::numeric_limits<float>::infinity());
+        slab(ray.o.x, 1.0f / ray.d.x, min_corner.x, max_corner.x, t_near, t_far);
+        slab(ray.o.y, 1.0f / ray.d.y, min_corner.y, max_corner.y, t_near, t_far);
+        slab(ray.o.z, 1.0f / ray.d.z, min_corner.z, max_corner.z, t_near, t_far);
+        MaskxN<N> hit = active & (t_near <= t_far);
+        return {hit, select(hit, t_near, FloatxN<N>::broadcast(0.0f))};
+    }
+
+  private:
+    static void slab(float             o_c,
+                     float             inv_d_c,
+                     const FloatxN<N> &lo,
+                     const FloatxN<N> &hi,
+                     FloatxN<N>       &t_near,
+                     FloatxN<N>       &t_far)
+    {
+        FloatxN<N> t0 = (lo - o_c) * inv_d_c;
+        FloatxN<N> t1 = (hi - o_c) * inv_d_c;
+        order_slab(t0, t1, t_near, t_far);
+    }
+};
+
+/**
+ * Slab test of one ray against a list of boxes, N boxes at a time. For
+ * repeated queries against the same boxes, keep them as AABBxN packets.
+ * @param  ray    Ray to test.
+ * @param  boxes  Boxes to test.
+ * @param  count  Number of boxes.
+ * @param  out    Per box results (count entries).
+ * @return  Returns the number of boxes hit.
+ */
+template <size_t N>
+size_t intersect_boxes(const Ray3               &ray,
+                       const AABB               *boxes,
+                       size_t                    count,
+                       RayObjectIntersectResult *out)
+{
+    size_t hits = 0;
+    for(size_t first = 0; first < count; first += N)
+    {
+        size_t          n = std::min(N, count - first);
+        RayPacketHit<N> hit = AABBxN<N>::load(boxes + first, n).intersect(ray);
+        for(size_t i = 0; i < n; i++)
+        {
+            out[first + i] = hit.get(i);
+            hits += hit.hit[i] ? 1 : 0;
+        }
+    }
+    return hits;
+}
+
+/**
+ * Intersects a list of rays with one object, N rays at a time.
+ * @param  rays    Rays to test.
+ * @param  count   Number of rays.
+ * @param  object  Plane, BoundingSphere or AABB.
+ * @param  out     Per ray results (count entries).
+ */
+template <size_t N, typename Object>
+void intersect_rays(const Ray3               *rays,
+                    size_t                    count,
+                    const Object             &object,
+                    RayObjectIntersectResult *out)
+{
+    for(size_t first = 0; first < count; first += N)
+    {
+        size_t          n = std::min(N, count - first);
+        RayPacketHit<N> hit = RayPacket<N>::load(rays + first, n).intersect(object);
+        for(size_t i = 0; i < n; i++) out[first + i] = hit.get(i);
+    }
+}
+
+/**
+ * Intersects a list of rays with one triangle, N rays at a time.
+ * @param  rays    Rays to test.
+ * @param  count   Number of rays.
+ * @param  v0      Vertex of the triangle
+ * @param  v1      Vertex of the triangle
+ * @param  v2      Vertex of the triangle
+ * @param  out     Per ray results (count entries).
+ */
+template <size_t N>
+void intersect_rays(const Ray3                 *rays,
+                    size_t                      count,
+                    const Point3               &v0,
+                    const Point3               &v1,
+                    const Point3               &v2,
+                    RayTriangleIntersectResult *out)
+{
+    for(size_t first = 0; first < count; first += N)
+    {
+        size_t                  n = std::min(N, count - first);
+        RayPacketTriangleHit<N> hit = RayPacket<N>::load(rays + first, n).intersect(v0, v1, v2);
+        for(size_t i = 0; i < n; i++) out[first + i] = hit.get(i);
+    }
+}
+
+// Packet widths for SSE (4 lanes), AVX (8 lanes) and AVX-512 (16 lanes)
+using RayPacket4 = RayPacket<4>;
+using RayPacket8 = RayPacket<8>;
+using RayPacket16 = RayPacket<16>;
+
+} // namespace cg
+
+#endif
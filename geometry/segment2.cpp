@@ -2,6 +2,7 @@
 
 #include "geometry/geometry.hpp"
 
+#include <algorithm>
 #include <cmath>
 
 namespace cg
@@ -56,66 +57,66 @@ Segment2PointDistanceResult LineSegment2::distance(const Point2 &p) const
 
 Segment2IntersectionResult LineSegment2::intersect(const LineSegment2 &segment) const
 {
-    // Construct vectors
-    Vector2 v = b - a;
-    Vector2 w = segment.b - segment.a;
-
-    // Set 2D perpendicular vector to w
-    Vector2 wp(w.y, -w.x);
-
-    // Check if denominator will be 0 (lines are parallel)
-    float wp_dot_v = wp.dot(v);
-    if(wp_dot_v == 0.0f) { return {false, Point2()}; }
-
-    // Solve for the parameter t. Early exit if no intersect.
-    Vector2 c = segment.a - a;
-    float   t = wp.dot(c) / wp_dot_v;
-    if(t < 0.0f || t > 1.0f) { return {false, Point2()}; }
-
-    // Solve for the parameter u
-    Vector2 vp(v.y, -v.x);
-    float   u = vp.dot(c) / wp_dot_v;
-    if(u < 0.0f || u > 1.0f) { return {false, Point2()}; }
+    // Segments whose bounding boxes do not overlap cannot intersect
+    if(std::max(a.x, b.x) < std::min(segment.a.x, segment.b.x) ||
+       std::max(segment.a.x, segment.b.x) < std::min(a.x, b.x) ||
+       std::max(a.y, b.y) < std::min(segment.a.y, segment.b.y) ||
+       std::max(segment.a.y, segment.b.y) < std::min(a.y, b.y))
+    {
+        return {false, Point2()};
+    }
 
-    // An intersect occurs. Return 'true' and the intersect point.
-    return {true, a + v * t};
+    // Which side of this segment's line each endpoint of the other is on.
+    // The signs are exact, so the answer does not flicker for nearly
+    // parallel or touching segments.
+    double o1 = orient2d(a, b, segment.a);
+    double o2 = orient2d(a, b, segment.b);
+    if((o1 > 0.0 && o2 > 0.0) || (o1 < 0.0 && o2 < 0.0)) { return {false, Point2()}; }
+
+    // Collinear (the lines overlap) is considered no intersect
+    if(o1 == 0.0 && o2 == 0.0) { return {false, Point2()}; }
+
+    double o3 = orient2d(segment.a, segment.b, a);
+    double o4 = orient2d(segment.a, segment.b, b);
+    if((o3 > 0.0 && o4 > 0.0) || (o3 < 0.0 && o4 < 0.0)) { return {false, Point2()}; }
+
+    // An intersect occurs. o3 and o4 are proportional to the distances of
+    // a and b from the other segment's line, so the parameter t along this
+    // segment is o3 / (o3 - o4). They differ in sign (or one is 0 and the
+    // other not), so t is in [0, 1].
+    float t = static_cast<float>(o3 / (o3 - o4));
+    return {true, a + (b - a) * t};
 }
 
 Segment2ClipResult LineSegment2::clip_to_polygon(const std::vector<Point2> &poly) const
 {
     // Initialize the candidate interval
-    float t_out = 1.0f;
-    float t_in = 0.0f;
-
-    // Ray for this line segment
-    Vector2 c = b - a;
+    double t_out = 1.0;
+    double t_in = 0.0;
 
-    float   t_hit;
-    Vector2 n;
-    Vector2 w;
-    auto    pt1 = poly.end() - 1;
-    auto    pt2 = poly.begin();
+    auto pt1 = poly.end() - 1;
+    auto pt2 = poly.begin();
     for(; pt2 != poly.end(); pt1 = pt2, pt2++)
     {
-        // Set an outward facing normal (polygon is assumed to be CCW)
-        n.set(pt2->y - pt1->y, pt1->x - pt2->x);
-
-        // Get the dot product of the normal to this polygon edge
-        // with the ray
-        float n_dot_c = n.dot(c);
-
-        // Check for parallel line
-        if(std::abs(n_dot_c) < EPSILON) { continue; }
-
-        w = *pt1 - a;
-        t_hit = n.dot(w) / n_dot_c;
-
-        // Ray is exiting P
-        if(n_dot_c > 0) t_out = (t_out < t_hit) ? t_out : t_hit;
-        else t_in = (t_in > t_hit) ? t_in : t_hit;
+        // Side of each endpoint relative to this edge: positive is inside
+        // (polygon is assumed to be CCW). The signs are exact, so an edge
+        // parallel to the segment is never mistaken for a crossing.
+        double side_a = orient2d(*pt1, *pt2, a);
+        double side_b = orient2d(*pt1, *pt2, b);
+
+        // Both endpoints outside this edge: nothing remains
+        bool early_out = (side_a < 0.0 && side_b < 0.0);
+        if(!early_out && (side_a < 0.0 || side_b < 0.0))
+        {
+            // The segment crosses the edge line at t_hit
+            double t_hit = side_a / (side_a - side_b);
 
-        // Early out
-        if(t_in > t_out)
+            // Entering if a is outside, else exiting
+            if(side_a < 0.0) t_in = (t_in > t_hit) ? t_in : t_hit;
+            else t_out = (t_out < t_hit) ? t_out : t_hit;
+            early_out = (t_in > t_out);
+        }
+        if(early_out)
         {
             // Set clip segment to 0s
             LineSegment2 clip_segment;
@@ -125,9 +126,10 @@ Segment2ClipResult LineSegment2::clip_to_polygon(const std::vector<Point2> &poly
         }
     }
     // If candidate interval is not empty then set the clip segment
+    Vector2      c = b - a;
     LineSegment2 clip_segment;
-    clip_segment.a = a + c * t_in;
-    clip_segment.b = a + c * t_out;
+    clip_segment.a = a + c * static_cast<float>(t_in);
+    clip_segment.b = a + c * static_cast<float>(t_out);
 
     return {true, clip_segment};
 }
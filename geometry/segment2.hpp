@@ -64,7 +64,9 @@ struct LineSegment2
      * Determines if the current segment intersects the specified segment.
      * If an intersect occurs the intersect_pt is determined.  Note: the
      * case where the lines overlap is not considered. Consider any parallel
-     * line segment case to be no intersect (return false).
+     * line segment case to be no intersect (return false). The decision
+     * uses exact orientation tests (orient2d), so it is symmetric and
+     * stable for touching and nearly parallel segments.
      * @param  segment        Segment to determine intersection with.
      * @return Returns true if an intersection exists (false if not),
      *         and the intersection point;
@@ -72,7 +74,9 @@ struct LineSegment2
     Segment2IntersectionResult intersect(const LineSegment2 &segment) const;
 
     /**
-     * Clips the line segment to a specified convex polygon.
+     * Clips the line segment to a specified convex polygon. Which side of
+     * each edge the endpoints are on is decided exactly (orient2d), so
+     * segments parallel to an edge are clipped correctly.
      * @param  poly A counter-clockwise oriented polygon.
      * @return Returns true if any part of the segment remains and
      *         the clipped segment.
@@ -0,0 +1,485 @@
+#include "geometry/segment_intersections.hpp"
+
+#include "geometry/geometry.hpp"
+#include "geometry/parallel.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+#include <queue>
+#include <set>
+#include <unordered_set>
+
+namespace cg
+{
+
+namespace
+{
+
+// Segment sets smaller than this are pruned on the calling thread
+constexpr size_t PARALLEL_MIN_SEGMENTS = 4096;
+
+// Relative costs for choosing between the sweep and the prune, in prune
+// pair tests (measured with Benchmarks/sweep_bench.cpp): the sweep costs
+// about PRUNE_PAIRS_PER_SEGMENT per segment before it finds anything, and
+// SWEEP_TEST_COST per pair it tests
+constexpr double PRUNE_PAIRS_PER_SEGMENT = 128.0;
+constexpr double SWEEP_TEST_COST = 16.0;
+
+// Points within this distance (relative to the coordinate magnitude) of a
+// segment at the sweep position are treated as on it. Covers the rounding
+// in float intersection points.
+constexpr double SWEEP_TOLERANCE = 1.0e-6;
+
+// Segment oriented left to right (vertical ones bottom to top), in double
+// precision
+struct SweepSegment
+{
+    double x0, y0, x1, y1;
+    double slope;
+    bool   vertical;
+
+    double y_at(double x) const
+    {
+        if(x <= x0) return y0;
+        if(x >= x1) return y1;
+        return y0 + (x - x0) * slope;
+    }
+};
+
+// Status entry. The id is mutable so 2 neighbors can trade places at a
+// crossing without a comparison (the tree order stays valid).
+struct StatusNode
+{
+    mutable uint32_t id;
+};
+
+// Orders segments bottom to top at the sweep position. Segments through
+// the same point are ordered by slope, which is their order just right of
+// the point.
+struct StatusLess
+{
+    // Also compares segments with a y at the sweep position (lower_bound)
+    using is_transparent = void;
+
+    const std::vector<SweepSegment> *segments;
+    const double                    *x;
+
+    bool operator()(const StatusNode &a, double y) const { return (*segments)[a.id].y_at(*x) < y; }
+
+    bool operator()(double y, const StatusNode &b) const { return y < (*segments)[b.id].y_at(*x); }
+
+    bool operator()(const StatusNode &a, const StatusNode &b) const
+    {
+        const SweepSegment &sa = (*segments)[a.id];
+        const SweepSegment &sb = (*segments)[b.id];
+        double              ya = sa.y_at(*x), yb = sb.y_at(*x);
+        if(ya != yb) return ya < yb;
+        if(sa.slope != sb.slope) return sa.slope < sb.slope;
+        return a.id < b.id;
+    }
+};
+
+// Events at the same point run starts, then vertical segments, then
+// crossings, then ends, so segments meeting at an endpoint are in the
+// status together. A vertical segment is one event at its lower end that
+// queries the status up to its upper end.
+enum class EventKind : uint32_t
+{
+    START,
+    VERTICAL,
+    CROSS,
+    END
+};
+
+struct SweepEvent
+{
+    double    x, y;
+    EventKind kind;
+    uint32_t  a, b;
+
+    bool operator>(const SweepEvent &e) const
+    {
+        if(x != e.x) return x > e.x;
+        if(y != e.y) return y > e.y;
+        return kind > e.kind;
+    }
+};
+
+uint64_t pair_key(uint32_t a, uint32_t b)
+{
+    return (static_cast<uint64_t>(std::min(a, b)) << 32) | std::max(a, b);
+}
+
+// Sorts by (first, second): a counting sort on first, then each run of
+// equal first (usually a few pairs) by second
+void sort_intersections(std::vector<SegmentPairIntersection> &intersections, size_t n)
+{
+    std::vector<uint32_t> offsets(n + 1, 0);
+    for(const SegmentPairIntersection &i : intersections) offsets[i.first + 1]++;
+    for(size_t i = 0; i < n; i++) offsets[i + 1] += offsets[i];
+    std::vector<SegmentPairIntersection> sorted(intersections.size());
+    std::vector<uint32_t>                next(offsets.begin(), offsets.end() - 1);
+    for(const SegmentPairIntersection &i : intersections) sorted[next[i.first]++] = i;
+    for(size_t i = 0; i < n; i++)
+    {
+        if(offsets[i + 1] - offsets[i] < 2) continue;
+        std::sort(sorted.begin() + offsets[i],
+                  sorted.begin() + offsets[i + 1],
+                  [](const SegmentPairIntersection &l, const SegmentPairIntersection &r) {
+                      return l.second < r.second;
+                  });
+    }
+    intersections.swap(sorted);
+}
+
+// Number of pairs whose x extents overlap: the pairs the prune tests
+size_t count_x_overlaps(const std::vector<LineSegment2> &segments)
+{
+    std::vector<std::pair<float, float>> extents(segments.size());
+    for(size_t i = 0; i < segments.size(); i++)
+    {
+        extents[i] = {std::min(segments[i].a.x, segments[i].b.x),
+                      std::max(segments[i].a.x, segments[i].b.x)};
+    }
+    std::sort(extents.begin(), extents.end());
+
+    // Each extent overlaps the later ones that start before it ends
+    size_t pairs = 0;
+    for(size_t i = 0; i < extents.size(); i++)
+    {
+        auto last = std::upper_bound(extents.begin() + i + 1,
+                                     extents.end(),
+                                     extents[i].second,
+                                     [](float x, const std::pair<float, float> &e) {
+                                         return x < e.first;
+                                     });
+        pairs += static_cast<size_t>(last - (extents.begin() + i + 1));
+    }
+    return pairs;
+}
+
+// Bentley-Ottmann sweep. Gives up (returns false) after max_tests
+// LineSegment2::intersect calls.
+bool sweep(const std::vector<LineSegment2>      &segments,
+           std::vector<SegmentPairIntersection> &intersections,
+           size_t                                max_tests)
+{
+    intersections.clear();
+    uint32_t n = static_cast<uint32_t>(segments.size());
+
+    // Orient segments left to right, vertical ones bottom to top
+    std::vector<SweepSegment> sweep(n);
+    double                    scale = 1.0;
+    for(uint32_t i = 0; i < n; i++)
+    {
+        Point2 p = segments[i].a, q = segments[i].b;
+        bool   vertical = p.x == q.x;
+        if(vertical ? p.y > q.y : p.x > q.x) std::swap(p, q);
+        double slope = vertical ? 0.0 : (static_cast<double>(q.y) - p.y) / (q.x - p.x);
+        sweep[i] = {p.x, p.y, q.x, q.y, slope, vertical};
+        scale = std::max({scale, std::abs(sweep[i].x0), std::abs(sweep[i].y0),
+                          std::abs(sweep[i].x1), std::abs(sweep[i].y1)});
+    }
+    const double tolerance = scale * SWEEP_TOLERANCE;
+
+    using Status = std::set<StatusNode, StatusLess>;
+    double                        sweep_x = 0.0;
+    Status                        status(StatusLess{&sweep, &sweep_x});
+    std::vector<Status::iterator> handle(n, status.end());
+    std::unordered_set<uint64_t>  found;
+    bool                          ok = true;
+    size_t                        tests = 0;
+    std::priority_queue<SweepEvent, std::vector<SweepEvent>, std::greater<SweepEvent>> events;
+    for(uint32_t i = 0; i < n; i++)
+    {
+        // Zero length segments meet nothing: LineSegment2::intersect finds
+        // them collinear with any segment
+        const SweepSegment &s = sweep[i];
+        if(s.vertical && s.y0 == s.y1) continue;
+        if(s.vertical)
+        {
+            events.push({s.x0, s.y0, EventKind::VERTICAL, i, i});
+            continue;
+        }
+        events.push({s.x0, s.y0, EventKind::START, i, i});
+        events.push({s.x1, s.y1, EventKind::END, i, i});
+    }
+
+    // Tests a pair, recording it if LineSegment2::intersect accepts it
+    auto test = [&](uint32_t a, uint32_t b) {
+        if(++tests > max_tests) ok = false;
+        Segment2IntersectionResult r = segments[std::min(a, b)].intersect(segments[std::max(a, b)]);
+        if(r.intersects)
+            intersections.push_back({std::min(a, b), std::max(a, b), r.intersect_point});
+        return r;
+    };
+
+    auto shared_end = [&](uint32_t a, uint32_t b) {
+        const SweepSegment &sa = sweep[a], &sb = sweep[b];
+        return (sa.x0 == sb.x0 && sa.y0 == sb.y0) || (sa.x0 == sb.x1 && sa.y0 == sb.y1) ||
+               (sa.x1 == sb.x0 && sa.y1 == sb.y0) || (sa.x1 == sb.x1 && sa.y1 == sb.y1);
+    };
+
+    // Records a pair if LineSegment2::intersect accepts it. The crossing
+    // becomes an event where the 2 trade places.
+    auto check = [&](uint32_t a, uint32_t b, const SweepEvent &e) {
+        if(!ok || found.count(pair_key(a, b)) != 0) return;
+        Segment2IntersectionResult r = test(a, b);
+        if(!r.intersects) return;
+        found.insert(pair_key(a, b));
+
+        // Segments sharing an endpoint are already in slope order there.
+        // A crossing that rounds to at or just behind the sweep is handled
+        // at the current point. Nearly parallel segments can put the
+        // rounded crossing well behind while still within the tolerance of
+        // each other at the sweep, so that counts too.
+        SweepEvent cross{r.intersect_point.x, r.intersect_point.y, EventKind::CROSS, a, b};
+        if(cross.x < e.x - tolerance &&
+           std::abs(sweep[a].y_at(e.x) - sweep[b].y_at(e.x)) > tolerance)
+            ok = false; // Neighbors that crossed behind the sweep: order is off
+        else if(!shared_end(a, b))
+            events.push((cross > e) ? cross : SweepEvent{e.x, e.y, EventKind::CROSS, a, b});
+    };
+
+    // Is segment s within the tolerance of point (x, y)?
+    auto touches = [&](uint32_t s, double x, double y) {
+        const SweepSegment &seg = sweep[s];
+        return std::abs(seg.y_at(x) - y) <= tolerance * std::sqrt(1.0 + seg.slope * seg.slope);
+    };
+
+    // Checks a segment against its neighbors that pass through the event
+    // point (T junctions, overlapping copies) and the first one clear of it
+    // on each side
+    auto check_through = [&](Status::iterator it, const SweepEvent &e) {
+        for(auto below = it; below != status.begin();)
+        {
+            --below;
+            check(below->id, it->id, e);
+            if(!touches(below->id, e.x, e.y)) break;
+        }
+        for(auto above = std::next(it); above != status.end(); ++above)
+        {
+            check(it->id, above->id, e);
+            if(!touches(above->id, e.x, e.y)) break;
+        }
+    };
+
+    // Vertical segments at the sweep position. Segments that start on one
+    // above its lower end are inserted after its query, so they test it.
+    std::vector<uint32_t> column;
+    double                column_x = 0.0;
+
+    std::vector<uint32_t> starts, ends, run;
+    while(!events.empty() && ok)
+    {
+        SweepEvent e = events.top();
+        events.pop();
+        sweep_x = e.x;
+        if(!column.empty() && column_x != e.x) column.clear();
+
+        if(e.kind == EventKind::VERTICAL)
+        {
+            // Every segment in the status within [y0, y1] at x. The order
+            // can be off by rounding among segments that meet near y0, so
+            // back up over those.
+            const SweepSegment &v = sweep[e.a];
+            auto                it = status.lower_bound(v.y0 - tolerance);
+            while(it != status.begin() && sweep[std::prev(it)->id].y_at(e.x) >= v.y0 - tolerance)
+                --it;
+            for(; it != status.end() && sweep[it->id].y_at(e.x) <= v.y1 + tolerance && ok; ++it)
+                test(e.a, it->id);
+            column.push_back(e.a);
+            column_x = e.x;
+            continue;
+        }
+
+        if(e.kind == EventKind::CROSS)
+        {
+            // a and b cross here. Find which is lower; only segments
+            // through the crossing may lie between them.
+            auto lo = handle[e.a], hi = handle[e.b];
+            if(lo == status.end() || hi == status.end()) continue;
+            auto reaches = [&](Status::iterator from, Status::iterator to) {
+                for(auto it = std::next(from); it != status.end(); ++it)
+                {
+                    if(it == to) return true;
+                    if(!touches(it->id, e.x, e.y)) return false;
+                }
+                return false;
+            };
+            if(!reaches(lo, hi))
+            {
+                std::swap(lo, hi);
+                if(!reaches(lo, hi))
+                {
+                    ok = false; // The order no longer matches the geometry
+                    break;
+                }
+            }
+
+            // Take in every segment through the crossing
+            while(lo != status.begin() && touches(std::prev(lo)->id, e.x, e.y)) --lo;
+            while(std::next(hi) != status.end() && touches(std::next(hi)->id, e.x, e.y)) ++hi;
+
+            // Reorder the run as it is just right of the crossing. The
+            // event point is rounded, so look a tolerance past it.
+            run.clear();
+            for(auto it = lo;; ++it)
+            {
+                run.push_back(it->id);
+                if(it == hi) break;
+            }
+            double after = e.x + tolerance;
+            std::sort(run.begin(), run.end(), [&](uint32_t l, uint32_t r) {
+                double yl = sweep[l].y_at(after), yr = sweep[r].y_at(after);
+                if(yl != yr) return yl < yr;
+                if(sweep[l].slope != sweep[r].slope) return sweep[l].slope < sweep[r].slope;
+                return l < r;
+            });
+            auto it = lo;
+            for(uint32_t s : run)
+            {
+                it->id = s;
+                handle[s] = it++;
+            }
+            for(size_t i = 0; i < run.size(); i++)
+            {
+                for(size_t j = i + 1; j < run.size(); j++) check(run[i], run[j], e);
+            }
+            if(lo != status.begin()) check(std::prev(lo)->id, lo->id, e);
+            if(std::next(hi) != status.end()) check(hi->id, std::next(hi)->id, e);
+            continue;
+        }
+
+        // Gather every start and end at exactly this point. Segments
+        // sharing an endpoint always intersect (unless parallel), so every
+        // pair among them is checked.
+        starts.clear();
+        ends.clear();
+        (e.kind == EventKind::START ? starts : ends).push_back(e.a);
+        while(!events.empty() && events.top().x == e.x && events.top().y == e.y &&
+              (events.top().kind == EventKind::START || events.top().kind == EventKind::END))
+        {
+            const SweepEvent &t = events.top();
+            (t.kind == EventKind::START ? starts : ends).push_back(t.a);
+            events.pop();
+        }
+        for(size_t i = 0; i < starts.size() + ends.size(); i++)
+        {
+            uint32_t a = (i < starts.size()) ? starts[i] : ends[i - starts.size()];
+            for(size_t j = i + 1; j < starts.size() + ends.size(); j++)
+            {
+                check(a, (j < starts.size()) ? starts[j] : ends[j - starts.size()], e);
+            }
+        }
+
+        for(uint32_t s : starts)
+        {
+            auto it = status.insert(StatusNode{s}).first;
+            handle[s] = it;
+
+            check_through(it, e);
+            for(uint32_t v : column)
+            {
+                if(sweep[v].y1 >= e.y - tolerance) test(v, s);
+            }
+        }
+
+        for(uint32_t s : ends)
+        {
+            // Removing s makes its 2 neighbors adjacent
+            auto it = handle[s];
+            if(it == status.end()) continue;
+            check_through(it, e);
+            auto above = status.erase(it);
+            handle[s] = status.end();
+            if(above != status.end() && above != status.begin())
+            {
+                check(std::prev(above)->id, above->id, e);
+            }
+        }
+    }
+
+    if(!ok)
+    {
+        intersections.clear();
+        return false;
+    }
+    sort_intersections(intersections, n);
+    return true;
+}
+
+} // namespace
+
+void find_segment_intersections(const std::vector<LineSegment2>      &segments,
+                                std::vector<SegmentPairIntersection> &intersections,
+                                uint32_t                              thread_count)
+{
+    // The prune makes one cheap test per pair of segments that overlap in
+    // x, split across threads; the sweep does O((N + K) log N) work with a
+    // much larger constant. Counting the overlapping pairs is O(N log N).
+    // Few of them: prune. Otherwise sweep, but give up and prune once the
+    // sweep has tested more pairs than the prune would cost (K near N^2,
+    // as with many segments through one point).
+    size_t   n = segments.size();
+    uint32_t threads = n < PARALLEL_MIN_SEGMENTS ? 1 : resolve_thread_count(thread_count);
+    double   prune_cost = static_cast<double>(count_x_overlaps(segments)) / threads;
+    if(prune_cost <= PRUNE_PAIRS_PER_SEGMENT * static_cast<double>(n) ||
+       !sweep(segments, intersections, static_cast<size_t>(prune_cost / SWEEP_TEST_COST)))
+    {
+        prune_segment_intersections(segments, intersections, thread_count);
+    }
+}
+
+bool sweep_segment_intersections(const std::vector<LineSegment2>      &segments,
+                                 std::vector<SegmentPairIntersection> &intersections)
+{
+    return sweep(segments, intersections, SIZE_MAX);
+}
+
+void prune_segment_intersections(const std::vector<LineSegment2>      &segments,
+                                 std::vector<SegmentPairIntersection> &intersections,
+                                 uint32_t                              thread_count)
+{
+    intersections.clear();
+    size_t                n = segments.size();
+    std::vector<uint32_t> order(n);
+    std::vector<float>    min_x(n), max_x(n);
+    for(uint32_t i = 0; i < n; i++)
+    {
+        order[i] = i;
+        min_x[i] = std::min(segments[i].a.x, segments[i].b.x);
+        max_x[i] = std::max(segments[i].a.x, segments[i].b.x);
+    }
+    std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+        return min_x[a] < min_x[b] || (min_x[a] == min_x[b] && a < b);
+    });
+
+    // Each segment only meets the ones that start before it ends in x
+    std::mutex lock;
+    parallel_for(n, thread_count, PARALLEL_MIN_SEGMENTS, [&](size_t first, size_t last) {
+        std::vector<SegmentPairIntersection> local;
+        for(size_t i = first; i < last; i++)
+        {
+            uint32_t             a = order[i];
+            const LineSegment2 &sa = segments[a];
+            float lo_y = std::min(sa.a.y, sa.b.y), hi_y = std::max(sa.a.y, sa.b.y);
+            for(size_t j = i + 1; j < n && min_x[order[j]] <= max_x[a]; j++)
+            {
+                uint32_t             b = order[j];
+                const LineSegment2 &sb = segments[b];
+                if(std::max(sb.a.y, sb.b.y) < lo_y || std::min(sb.a.y, sb.b.y) > hi_y) continue;
+                Segment2IntersectionResult r =
+                    segments[std::min(a, b)].intersect(segments[std::max(a, b)]);
+                if(r.intersects)
+                    local.push_back({std::min(a, b), std::max(a, b), r.intersect_point});
+            }
+        }
+        std::lock_guard<std::mutex> guard(lock);
+        intersections.insert(intersections.end(), local.begin(), local.end());
+    });
+    sort_intersections(intersections, n);
+}
+
+} // namespace cg
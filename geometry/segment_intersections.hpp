@@ -0,0 +1,79 @@
+//============================================================================
+//	Johns Hopkins University Engineering for Professionals
+//	605.667 Computer Graphics and 605.767 Applied Computer Graphics
+//	Instructor:	Brian Russin
+//
+//	Author:  Kyle Meyer
+//	File:    segment_intersections.hpp
+//	Purpose: All-pairs intersection of 2D line segment sets. A Bentley-
+//           Ottmann sweep finds the K crossings among N segments in
+//           O((N + K) log N); a multithreaded sort and prune pass is
+//           faster when few segments overlap in x or nearly all pairs cross.
+//           Both report exactly the pairs LineSegment2::intersect accepts.
+//============================================================================
+
+#ifndef __GEOMETRY_SEGMENT_INTERSECTIONS_HPP__
+#define __GEOMETRY_SEGMENT_INTERSECTIONS_HPP__
+
+#include "geometry/point2.hpp"
+#include "geometry/segment2.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace cg
+{
+
+/**
+ * Intersection of 2 segments in a set. first < second and point is
+ * segments[first].intersect(segments[second]).intersect_point.
+ */
+struct SegmentPairIntersection
+{
+    uint32_t first;
+    uint32_t second;
+    Point2   point;
+};
+
+/**
+ * Finds every intersecting pair in a segment set. Counts the pairs whose x
+ * extents overlap (the prune's work) and runs the sweep only when that count
+ * is large per segment, switching to the prune if the sweep tests more pairs
+ * than the prune would cost. Results are sorted by (first, second).
+ * @param  segments      Segment set.
+ * @param  intersections Receives the intersections (cleared first).
+ * @param  thread_count  Threads for the fallback (0 = one per core).
+ */
+void find_segment_intersections(const std::vector<LineSegment2>      &segments,
+                                std::vector<SegmentPairIntersection> &intersections,
+                                uint32_t                              thread_count = 0);
+
+/**
+ * Bentley-Ottmann sweep. Handles shared endpoints, T junctions, several
+ * segments through one point and vertical segments; zero length segments
+ * intersect nothing.
+ * @param  segments      Segment set.
+ * @param  intersections Receives the intersections sorted by (first,
+ *                       second) (cleared first).
+ * @return Returns false (and leaves intersections empty) if the sweep lost
+ *         track of the segment order due to rounding.
+ */
+bool sweep_segment_intersections(const std::vector<LineSegment2>      &segments,
+                                 std::vector<SegmentPairIntersection> &intersections);
+
+/**
+ * Sort and prune on x extents, then LineSegment2::intersect on the pairs
+ * whose extents overlap, split across threads. Handles any input; worst
+ * case O(N^2) when many segments overlap in x.
+ * @param  segments      Segment set.
+ * @param  intersections Receives the intersections sorted by (first,
+ *                       second) (cleared first).
+ * @param  thread_count  Number of threads (0 = one per core).
+ */
+void prune_segment_intersections(const std::vector<LineSegment2>      &segments,
+                                 std::vector<SegmentPairIntersection> &intersections,
+                                 uint32_t                              thread_count = 0);
+
+} // namespace cg
+
+#endif
@@ -0,0 +1,334 @@
+#include "geometry/transform_batch.hpp"
+
+#include "geometry/cpu_features.hpp"
+#include "geometry/geometry.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(CG_SIMD_X86)
+#include <immintrin.h>
+#endif
+
+namespace cg
+{
+
+namespace
+{
+
+// Number of points staged through the stack when converting array of
+// structures input into structure of arrays tiles (AoSoA).
+constexpr size_t TILE_SIZE = 256;
+
+/**
+ * One structure of arrays transform. If w is null every input point uses
+ * w_const (1 for points, 0 for vectors). Output w is optional.
+ */
+struct SoAJob
+{
+    const float *m;
+    const float *x;
+    const float *y;
+    const float *z;
+    const float *w;
+    float        w_const;
+    float       *ox;
+    float       *oy;
+    float       *oz;
+    float       *ow;
+    size_t       count;
+    bool         divide;
+};
+
+// Transforms points [first, job.count). Summation order matches the matrix
+// kernels so batch results equal Matrix4x4 operator* results.
+void transform_soa_scalar(const SoAJob &job, size_t first)
+{
+    const float *m = job.m;
+    for(size_t i = first; i < job.count; i++)
+    {
+        float x = job.x[i], y = job.y[i], z = job.z[i];
+        float w = job.w ? job.w[i] : job.w_const;
+        float tx = m[0] * x + m[4] * y + m[8] * z + m[12] * w;
+        float ty = m[1] * x + m[5] * y + m[9] * z + m[13] * w;
+        float tz = m[2] * x + m[6] * y + m[10] * z + m[14] * w;
+        float tw = m[3] * x + m[7] * y + m[11] * z + m[15] * w;
+        if(job.divide)
+        {
+            float d = (std::abs(tw) > EPSILON) ? (1.0f / tw) : 1.0f;
+            tx *= d;
+            ty *= d;
+            tz *= d;
+        }
+        job.ox[i] = tx;
+        job.oy[i] = ty;
+        job.oz[i] = tz;
+        if(job.ow) job.ow[i] = tw;
+    }
+}
+
+#if defined(CG_SIMD_X86)
+
+CG_TARGET_SSE41 void transform_soa_sse41(const SoAJob &job)
+{
+    const float *m = job.m;
+    __m128       wc = _mm_set1_ps(job.w_const);
+    __m128       one = _mm_set1_ps(1.0f);
+    __m128       eps = _mm_set1_ps(EPSILON);
+    __m128       abs_mask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+    size_t       n = job.count & ~static_cast<size_t>(3);
+    for(size_t i = 0; i < n; i += 4)
+    {
+        __m128 x = _mm_loadu_ps(job.x + i);
+        __m128 y = _mm_loadu_ps(job.y + i);
+        __m128 z = _mm_loadu_ps(job.z + i);
+        __m128 w = job.w ? _mm_loadu_ps(job.w + i) : wc;
+        __m128 t[4];
+        for(int r = 0; r < 4; r++)
+        {
+            __m128 s = _mm_mul_ps(_mm_set1_ps(m[r]), x);
+            s = _mm_add_ps(s, _mm_mul_ps(_mm_set1_ps(m[4 + r]), y));
+            s = _mm_add_ps(s, _mm_mul_ps(_mm_set1_ps(m[8 + r]), z));
+            t[r] = _mm_add_ps(s, _mm_mul_ps(_mm_set1_ps(m[12 + r]), w));
+        }
+        if(job.divide)
+        {
+            // d = (|w| > EPSILON) ? 1 / w : 1
+            __m128 valid = _mm_cmpgt_ps(_mm_and_ps(t[3], abs_mask), eps);
+            __m128 d = _mm_blendv_ps(one, _mm_div_ps(one, t[3]), valid);
+            t[0] = _mm_mul_ps(t[0], d);
+            t[1] = _mm_mul_ps(t[1], d);
+            t[2] = _mm_mul_ps(t[2], d);
+        }
+        _mm_storeu_ps(job.ox + i, t[0]);
+        _mm_storeu_ps(job.oy + i, t[1]);
+        _mm_storeu_ps(job.oz + i, t[2]);
+        if(job.ow) _mm_storeu_ps(job.ow + i, t[3]);
+    }
+    transform_soa_scalar(job, n);
+}
+
+CG_TARGET_AVX2 void transform_soa_avx2(const SoAJob &job)
+{
+    const float *m = job.m;
+    __m256       wc = _mm256_set1_ps(job.w_const);
+    __m256       one = _mm256_set1_ps(1.0f);
+    __m256       eps = _mm256_set1_ps(EPSILON);
+    __m256       abs_mask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+    size_t       n = job.count & ~static_cast<size_t>(7);
+    for(size_t i = 0; i < n; i += 8)
+    {
+        __m256 x = _mm256_loadu_ps(job.x + i);
+        __m256 y = _mm256_loadu_ps(job.y + i);
+        __m256 z = _mm256_loadu_ps(job.z + i);
+        __m256 w = job.w ? _mm256_loadu_ps(job.w + i) : wc;
+        __m256 t[4];
+        for(int r = 0; r < 4; r++)
+        {
+            __m256 s = _mm256_mul_ps(_mm256_set1_ps(m[r]), x);
+            s = _mm256_add_ps(s, _mm256_mul_ps(_mm256_set1_ps(m[4 + r]), y));
+            s = _mm256_add_ps(s, _mm256_mul_ps(_mm256_set1_ps(m[8 + r]), z));
+            t[r] = _mm256_add_ps(s, _mm256_mul_ps(_mm256_set1_ps(m[12 + r]), w));
+        }
+        if(job.divide)
+        {
+            __m256 valid = _mm256_cmp_ps(_mm256_and_ps(t[3], abs_mask), eps, _CMP_GT_OQ);
+            __m256 d = _mm256_blendv_ps(one, _mm256_div_ps(one, t[3]), valid);
+            t[0] = _mm256_mul_ps(t[0], d);
+            t[1] = _mm256_mul_ps(t[1], d);
+            t[2] = _mm256_mul_ps(t[2], d);
+        }
+        _mm256_storeu_ps(job.ox + i, t[0]);
+        _mm256_storeu_ps(job.oy + i, t[1]);
+        _mm256_storeu_ps(job.oz + i, t[2]);
+        if(job.ow) _mm256_storeu_ps(job.ow + i, t[3]);
+    }
+    transform_soa_scalar(job, n);
+}
+
+#endif
+
+void transform_soa(const SoAJob &job)
+{
+#if defined(CG_SIMD_X86)
+    static const SimdLevel level = best_simd_level();
+    if(level == SimdLevel::AVX2) transform_soa_avx2(job);
+    else if(level == SimdLevel::SSE41) transform_soa_sse41(job);
+    else transform_soa_scalar(job, 0);
+#else
+    transform_soa_scalar(job, 0);
+#endif
+}
+
+/**
+ * Stack storage for one AoSoA tile: input and output component arrays.
+ */
+struct Tile
+{
+    float x[TILE_SIZE];
+    float y[TILE_SIZE];
+    float z[TILE_SIZE];
+    float w[TILE_SIZE];
+    float ox[TILE_SIZE];
+    float oy[TILE_SIZE];
+    float oz[TILE_SIZE];
+    float ow[TILE_SIZE];
+
+    // Creates a job that transforms the tile in place
+    SoAJob job(const Matrix4x4 &m, size_t n, bool has_w, float w_const, bool divide)
+    {
+        return {m.get(), x, y, z, has_w ? w : nullptr, w_const, ox, oy, oz, ow, n, divide};
+    }
+};
+
+// Transforms an array of x,y,z triples in tiles. Used for Point3 and Vector3.
+// In and Out only need x, y and z members.
+template <typename In, typename Out>
+void transform_xyz(const Matrix4x4 &m, const In *in, Out *out, size_t count, float w, bool divide)
+{
+    Tile tile;
+    for(size_t first = 0; first < count; first += TILE_SIZE)
+    {
+        size_t n = std::min(TILE_SIZE, count - first);
+        for(size_t i = 0; i < n; i++)
+        {
+            tile.x[i] = in[first + i].x;
+            tile.y[i] = in[first + i].y;
+            tile.z[i] = in[first + i].z;
+        }
+        transform_soa(tile.job(m, n, false, w, divide));
+        for(size_t i = 0; i < n; i++)
+        {
+            out[first + i].x = tile.ox[i];
+            out[first + i].y = tile.oy[i];
+            out[first + i].z = tile.oz[i];
+        }
+    }
+}
+
+} // namespace
+
+void transform_points(const Matrix4x4 &m, const Point3 *in, HPoint3 *out, size_t count)
+{
+    Tile tile;
+    for(size_t first = 0; first < count; first += TILE_SIZE)
+    {
+        size_t n = std::min(TILE_SIZE, count - first);
+        for(size_t i = 0; i < n; i++)
+        {
+            tile.x[i] = in[first + i].x;
+            tile.y[i] = in[first + i].y;
+            tile.z[i] = in[first + i].z;
+        }
+        transform_soa(tile.job(m, n, false, 1.0f, false));
+        for(size_t i = 0; i < n; i++)
+        {
+            out[first + i] = HPoint3(tile.ox[i], tile.oy[i], tile.oz[i], tile.ow[i]);
+        }
+    }
+}
+
+void transform_points(const Matrix4x4 &m,
+                      const Point3    *in,
+                      Point3          *out,
+                      size_t           count,
+                      bool             perspective_divide)
+{
+    transform_xyz(m, in, out, count, 1.0f, perspective_divide);
+}
+
+void transform_points(const Matrix4x4 &m, const HPoint3 *in, HPoint3 *out, size_t count)
+{
+    Tile tile;
+    for(size_t first = 0; first < count; first += TILE_SIZE)
+    {
+        size_t n = std::min(TILE_SIZE, count - first);
+        for(size_t i = 0; i < n; i++)
+        {
+            tile.x[i] = in[first + i].x;
+            tile.y[i] = in[first + i].y;
+            tile.z[i] = in[first + i].z;
+            tile.w[i] = in[first + i].w;
+        }
+        transform_soa(tile.job(m, n, true, 1.0f, false));
+        for(size_t i = 0; i < n; i++)
+        {
+            out[first + i] = HPoint3(tile.ox[i], tile.oy[i], tile.oz[i], tile.ow[i]);
+        }
+    }
+}
+
+void transform_vectors(const Matrix4x4 &m, const Vector3 *in, Vector3 *out, size_t count)
+{
+    transform_xyz(m, in, out, count, 0.0f, false);
+}
+
+void transform_vertices(const Matrix4x4       &m,
+                        const Matrix4x4       &normal_matrix,
+                        const VertexAndNormal *in,
+                        VertexAndNormal       *out,
+                        size_t                 count)
+{
+    Tile tile;
+    for(size_t first = 0; first < count; first += TILE_SIZE)
+    {
+        size_t n = std::min(TILE_SIZE, count - first);
+
+        // Positions
+        for(size_t i = 0; i < n; i++)
+        {
+            tile.x[i] = in[first + i].vertex.x;
+            tile.y[i] = in[first + i].vertex.y;
+            tile.z[i] = in[first + i].vertex.z;
+        }
+        transform_soa(tile.job(m, n, false, 1.0f, false));
+        for(size_t i = 0; i < n; i++)
+        {
+            out[first + i].vertex.set(tile.ox[i], tile.oy[i], tile.oz[i]);
+        }
+
+        // Normals
+        for(size_t i = 0; i < n; i++)
+        {
+            tile.x[i] = in[first + i].normal.x;
+            tile.y[i] = in[first + i].normal.y;
+            tile.z[i] = in[first + i].normal.z;
+        }
+        transform_soa(tile.job(normal_matrix, n, false, 0.0f, false));
+        for(size_t i = 0; i < n; i++)
+        {
+            out[first + i].normal.set(tile.ox[i], tile.oy[i], tile.oz[i]);
+        }
+    }
+}
+
+void transform_points(const Matrix4x4     &m,
+                      const ConstSoA3View &in,
+                      const SoA3View      &out,
+                      size_t               count,
+                      bool                 perspective_divide)
+{
+    transform_soa({m.get(),
+                   in.x,
+                   in.y,
+                   in.z,
+                   nullptr,
+                   1.0f,
+                   out.x,
+                   out.y,
+                   out.z,
+                   nullptr,
+                   count,
+                   perspective_divide});
+}
+
+void transform_vectors(const Matrix4x4     &m,
+                       const ConstSoA3View &in,
+                       const SoA3View      &out,
+                       size_t               count)
+{
+    transform_soa(
+        {m.get(), in.x, in.y, in.z, nullptr, 0.0f, out.x, out.y, out.z, nullptr, count, false});
+}
+
+} // namespace cg
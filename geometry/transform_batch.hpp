@@ -0,0 +1,140 @@
+//============================================================================
+//	Johns Hopkins University Engineering for Professionals
+//	605.667 Computer Graphics and 605.767 Applied Computer Graphics
+//	Instructor:	Brian Russin
+//
+//	Author:  Kyle Meyer
+//	File:    transform_batch.hpp
+//	Purpose: Transform arrays of points, vectors and vertices by a single
+//           matrix. Vectorized with SSE4.1 / AVX2 when available.
+//============================================================================
+
+#ifndef __GEOMETRY_TRANSFORM_BATCH_HPP__
+#define __GEOMETRY_TRANSFORM_BATCH_HPP__
+
+#include "geometry/hpoint3.hpp"
+#include "geometry/matrix.hpp"
+#include "geometry/point3.hpp"
+#include "geometry/types.hpp"
+#include "geometry/vector3.hpp"
+
+#include <cstddef>
+
+namespace cg
+{
+
+/**
+ * Structure of arrays view of 3D points or vectors: the x, y and z
+ * components are stored in separate arrays.
+ */
+struct SoA3View
+{
+    float *x;
+    float *y;
+    float *z;
+};
+
+/**
+ * Read-only structure of arrays view of 3D points or vectors.
+ */
+struct ConstSoA3View
+{
+    const float *x;
+    const float *y;
+    const float *z;
+
+    ConstSoA3View(const float *ix, const float *iy, const float *iz) : x(ix), y(iy), z(iz) {}
+
+    ConstSoA3View(const SoA3View &v) : x(v.x), y(v.y), z(v.z) {}
+};
+
+/**
+ * Transforms an array of points (w assumed to be 1) into homogeneous points.
+ * Same result as m * in[i] for each point.
+ * @param  m      Transformation matrix.
+ * @param  in     Input points.
+ * @param  out    Output homogeneous points. May not overlap the input.
+ * @param  count  Number of points.
+ */
+void transform_points(const Matrix4x4 &m, const Point3 *in, HPoint3 *out, size_t count);
+
+/**
+ * Transforms an array of points (w assumed to be 1).
+ * @param  m                   Transformation matrix.
+ * @param  in                  Input points.
+ * @param  out                 Output points. May be the same array as in.
+ * @param  count               Number of points.
+ * @param  perspective_divide  If true divide through by the transformed w
+ *                             (as HPoint3::to_cartesian does). If false w is
+ *                             ignored, which is correct for affine matrices.
+ */
+void transform_points(const Matrix4x4 &m,
+                      const Point3    *in,
+                      Point3          *out,
+                      size_t           count,
+                      bool             perspective_divide);
+
+/**
+ * Transforms an array of homogeneous points.
+ * @param  m      Transformation matrix.
+ * @param  in     Input points.
+ * @param  out    Output points. May be the same array as in.
+ * @param  count  Number of points.
+ */
+void transform_points(const Matrix4x4 &m, const HPoint3 *in, HPoint3 *out, size_t count);
+
+/**
+ * Transforms an array of vectors (directions or normals) by the upper 3x3
+ * portion of the matrix.
+ * @param  m      Transformation matrix.
+ * @param  in     Input vectors.
+ * @param  out    Output vectors. May be the same array as in.
+ * @param  count  Number of vectors.
+ */
+void transform_vectors(const Matrix4x4 &m, const Vector3 *in, Vector3 *out, size_t count);
+
+/**
+ * Transforms an array of vertices: positions by m and normals by the upper
+ * 3x3 portion of normal_matrix. Normals are not renormalized.
+ * @param  m              Transformation matrix for positions.
+ * @param  normal_matrix  Transformation matrix for normals.
+ * @param  in             Input vertices.
+ * @param  out            Output vertices. May be the same array as in.
+ * @param  count          Number of vertices.
+ */
+void transform_vertices(const Matrix4x4       &m,
+                        const Matrix4x4       &normal_matrix,
+                        const VertexAndNormal *in,
+                        VertexAndNormal       *out,
+                        size_t                 count);
+
+/**
+ * Transforms points stored as a structure of arrays (w assumed to be 1).
+ * @param  m                   Transformation matrix.
+ * @param  in                  Input component arrays.
+ * @param  out                 Output component arrays. May equal in.
+ * @param  count               Number of points.
+ * @param  perspective_divide  If true divide through by the transformed w.
+ */
+void transform_points(const Matrix4x4     &m,
+                      const ConstSoA3View &in,
+                      const SoA3View      &out,
+                      size_t               count,
+                      bool                 perspective_divide);
+
+/**
+ * Transforms vectors stored as a structure of arrays by the upper 3x3
+ * portion of the matrix.
+ * @param  m      Transformation matrix.
+ * @param  in     Input component arrays.
+ * @param  out    Output component arrays. May equal in.
+ * @param  count  Number of vectors.
+ */
+void transform_vectors(const Matrix4x4     &m,
+                       const ConstSoA3View &in,
+                       const SoA3View      &out,
+                       size_t               count);
+
+} // namespace cg
+
+#endif
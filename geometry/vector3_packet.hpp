@@ -0,0 +1,526 @@
+//============================================================================
+//	Johns Hopkins University Engineering for Professionals
+//	605.667 Computer Graphics and 605.767 Applied Computer Graphics
+//	Instructor:	Brian Russin
+//
+//	Author:  Kyle Meyer
+//	File:    vector3_packet.hpp
+//	Purpose: Packets of N floats, 3D vectors and 3D points stored as
+//           structure of arrays (one array per component). Operations work
+//           on all N lanes at once and are written as simple fixed-length
+//           loops over aligned arrays, which the compiler turns into SSE /
+//           AVX instructions. N = 4 matches an SSE register and N = 8 an
+//           AVX register.
+//============================================================================
+
+#ifndef __GEOMETRY_VECTOR3_PACKET_HPP__
+#define __GEOMETRY_VECTOR3_PACKET_HPP__
+
+#include "geometry/constants.hpp"
+#include "geometry/point3.hpp"
+#include "geometry/vector3.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#if defined(__SSE__) || defined(_M_X64)
+#include <xmmintrin.h>
+#define CG_PACKET_SSE 1
+#endif
+
+namespace cg
+{
+
+/**
+ * Per-lane boolean mask. Each lane is all ones (true) or all zeros (false)
+ * so masks can be used directly as blend masks.
+ */
+template <size_t N>
+struct MaskxN
+{
+    alignas(N * 4) uint32_t m[N];
+
+    /**
+     * Sets every lane to the same value.
+     * @param  value  Value for all lanes.
+     * @return  Returns the mask.
+     */
+    static MaskxN broadcast(bool value)
+    {
+        MaskxN r;
+        for(size_t i = 0; i < N; i++) r.m[i] = value ? 0xffffffffu : 0u;
+        return r;
+    }
+
+    /**
+     * Gets a lane as a bool.
+     * @param  i  Lane index.
+     * @return  Returns true if the lane is set.
+     */
+    bool operator[](size_t i) const { return m[i] != 0u; }
+
+    /**
+     * Sets a lane.
+     * @param  i      Lane index.
+     * @param  value  Value for the lane.
+     */
+    void set(size_t i, bool value) { m[i] = value ? 0xffffffffu : 0u; }
+
+    /**
+     * Packs the mask into an integer, lane i in bit i.
+     * @return  Returns the bit mask.
+     */
+    uint32_t bits() const
+    {
+        uint32_t b = 0;
+        for(size_t i = 0; i < N; i++) b |= (m[i] & 1u) << i;
+        return b;
+    }
+
+    // Returns true if any / all / no lanes are set
+    bool any() const { return bits() != 0u; }
+    bool all() const { return bits() == (N >= 32 ? 0xffffffffu : ((1u << N) - 1u)); }
+    bool none() const { return bits() == 0u; }
+
+    MaskxN operator&(const MaskxN &o) const
+    {
+        MaskxN r;
+        for(size_t i = 0; i < N; i++) r.m[i] = m[i] & o.m[i];
+        return r;
+    }
+
+    MaskxN operator|(const MaskxN &o) const
+    {
+        MaskxN r;
+        for(size_t i = 0; i < N; i++) r.m[i] = m[i] | o.m[i];
+        return r;
+    }
+
+    MaskxN operator~() const
+    {
+        MaskxN r;
+        for(size_t i = 0; i < N; i++) r.m[i] = ~m[i];
+        return r;
+    }
+};
+
+/**
+ * Packet of N floats.
+ */
+template <size_t N>
+struct FloatxN
+{
+    alignas(N * 4) float v[N];
+
+    /**
+     * Sets every lane to the same value.
+     * @param  f  Value for all lanes.
+     * @return  Returns the packet.
+     */
+    static FloatxN broadcast(float f)
+    {
+        FloatxN r;
+        for(size_t i = 0; i < N; i++) r.v[i] = f;
+        return r;
+    }
+
+    /**
+     * Loads N consecutive floats. Lanes at or beyond count are set to fill.
+     * @param  p      Source values.
+     * @param  count  Number of values to read (at most N).
+     * @param  fill   Value for unused lanes.
+     * @return  Returns the packet.
+     */
+    static FloatxN load(const float *p, size_t count = N, float fill = 0.0f)
+    {
+        FloatxN r;
+        for(size_t i = 0; i < N; i++) r.v[i] = (i < count) ? p[i] : fill;
+        return r;
+    }
+
+    /**
+     * Stores the first count lanes.
+     * @param  p      Destination.
+     * @param  count  Number of lanes to store (at most N).
+     */
+    void store(float *p, size_t count = N) const
+    {
+        for(size_t i = 0; i < count && i < N; i++) p[i] = v[i];
+    }
+
+    float  operator[](size_t i) const { return v[i]; }
+    float &operator[](size_t i) { return v[i]; }
+
+#define CG_PACKET_BINARY_OP(op)                                                                    \
+    FloatxN operator op(const FloatxN &o) const                                                    \
+    {                                                                                              \
+        FloatxN r;                                                                                 \
+        for(size_t i = 0; i < N; i++) r.v[i] = v[i] op o.v[i];                                     \
+        return r;                                                                                  \
+    }                                                                                              \
+    FloatxN operator op(float f) const                                                             \
+    {                                                                                              \
+        FloatxN r;                                                                                 \
+        for(size_t i = 0; i < N; i++) r.v[i] = v[i] op f;                                          \
+        return r;                                                                                  \
+    }
+    CG_PACKET_BINARY_OP(+)
+    CG_PACKET_BINARY_OP(-)
+    CG_PACKET_BINARY_OP(*)
+    CG_PACKET_BINARY_OP(/)
+#undef CG_PACKET_BINARY_OP
+
+#define CG_PACKET_COMPARE_OP(op)                                                                   \
+    MaskxN<N> operator op(const FloatxN &o) const                                                  \
+    {                                                                                              \
+        MaskxN<N> r;                                                                               \
+        for(size_t i = 0; i < N; i++) r.m[i] = (v[i] op o.v[i]) ? 0xffffffffu : 0u;                \
+        return r;                                                                                  \
+    }                                                                                              \
+    MaskxN<N> operator op(float f) const                                                           \
+    {                                                                                              \
+        MaskxN<N> r;                                                                               \
+        for(size_t i = 0; i < N; i++) r.m[i] = (v[i] op f) ? 0xffffffffu : 0u;                     \
+        return r;                                                                                  \
+    }
+    CG_PACKET_COMPARE_OP(<)
+    CG_PACKET_COMPARE_OP(<=)
+    CG_PACKET_COMPARE_OP(>)
+    CG_PACKET_COMPARE_OP(>=)
+    CG_PACKET_COMPARE_OP(==)
+    CG_PACKET_COMPARE_OP(!=)
+#undef CG_PACKET_COMPARE_OP
+
+    FloatxN operator-() const
+    {
+        FloatxN r;
+        for(size_t i = 0; i < N; i++) r.v[i] = -v[i];
+        return r;
+    }
+};
+
+/**
+ * Chooses per lane between 2 packets.
+ * @param  mask  Lane selector.
+ * @param  a     Values for lanes where mask is set.
+ * @param  b     Values for lanes where mask is clear.
+ * @return  Returns mask ? a : b per lane.
+ */
+template <size_t N>
+FloatxN<N> select(const MaskxN<N> &mask, const FloatxN<N> &a, const FloatxN<N> &b)
+{
+    // Bitwise blend (mask lanes are all ones or all zeros) rather than a
+    // per lane branch so the loop vectorizes
+    FloatxN<N> r;
+    for(size_t i = 0; i < N; i++)
+    {
+        uint32_t ai, bi;
+        std::memcpy(&ai, &a.v[i], sizeof(float));
+        std::memcpy(&bi, &b.v[i], sizeof(float));
+        uint32_t ri = (ai & mask.m[i]) | (bi & ~mask.m[i]);
+        std::memcpy(&r.v[i], &ri, sizeof(float));
+    }
+    return r;
+}
+
+// Per-lane minimum, maximum, absolute value and square root. Minimum and
+// maximum return a unless b compares strictly smaller / larger, as
+// std::min and std::max do, so a NaN b (or equal zeros of either sign)
+// give a.
+
+template <size_t N>
+FloatxN<N> packet_min(const FloatxN<N> &a, const FloatxN<N> &b)
+{
+    FloatxN<N> r;
+    for(size_t i = 0; i < N; i++) r.v[i] = (b.v[i] < a.v[i]) ? b.v[i] : a.v[i];
+    return r;
+}
+
+template <size_t N>
+FloatxN<N> packet_max(const FloatxN<N> &a, const FloatxN<N> &b)
+{
+    FloatxN<N> r;
+    for(size_t i = 0; i < N; i++) r.v[i] = (a.v[i] < b.v[i]) ? b.v[i] : a.v[i];
+    return r;
+}
+
+template <size_t N>
+FloatxN<N> packet_abs(const FloatxN<N> &a)
+{
+    FloatxN<N> r;
+    for(size_t i = 0; i < N; i++) r.v[i] = std::abs(a.v[i]);
+    return r;
+}
+
+// std::sqrt must set errno for negative input, which stops the compiler
+// from vectorizing it. SSE sqrtps is always available on x86-64 and is
+// correctly rounded, so it gives the same result as std::sqrt.
+template <size_t N>
+FloatxN<N> packet_sqrt(const FloatxN<N> &a)
+{
+    FloatxN<N> r;
+#if defined(CG_PACKET_SSE)
+    if(N % 4 == 0)
+    {
+        for(size_t i = 0; i < N; i += 4)
+        {
+            _mm_storeu_ps(r.v + i, _mm_sqrt_ps(_mm_loadu_ps(a.v + i)));
+        }
+        return r;
+    }
+#endif
+    for(size_t i = 0; i < N; i++) r.v[i] = std::sqrt(a.v[i]);
+    return r;
+}
+
+/**
+ * Packet of N 3D vectors (structure of arrays). Operations match Vector3.
+ */
+template <size_t N>
+struct Vector3xN
+{
+    FloatxN<N> x;
+    FloatxN<N> y;
+    FloatxN<N> z;
+
+    /**
+     * Sets every lane to the same vector.
+     * @param  w  Vector for all lanes.
+     * @return  Returns the packet.
+     */
+    static Vector3xN broadcast(const Vector3 &w)
+    {
+        return {FloatxN<N>::broadcast(w.x), FloatxN<N>::broadcast(w.y),
+                FloatxN<N>::broadcast(w.z)};
+    }
+
+    /**
+     * Loads up to N vectors. Lanes at or beyond count are set to 0.
+     * @param  p      Source vectors.
+     * @param  count  Number of vectors to read (at most N).
+     * @return  Returns the packet.
+     */
+    static Vector3xN load(const Vector3 *p, size_t count = N)
+    {
+        Vector3xN r;
+        for(size_t i = 0; i < N; i++) r.set(i, (i < count) ? p[i] : Vector3());
+        return r;
+    }
+
+    /**
+     * Stores the first count lanes.
+     * @param  p      Destination.
+     * @param  count  Number of vectors to store (at most N).
+     */
+    void store(Vector3 *p, size_t count = N) const
+    {
+        for(size_t i = 0; i < count && i < N; i++) p[i] = get(i);
+    }
+
+    /**
+     * Gets one lane.
+     * @param  i  Lane index.
+     * @return  Returns the vector in lane i.
+     */
+    Vector3 get(size_t i) const { return Vector3(x.v[i], y.v[i], z.v[i]); }
+
+    /**
+     * Sets one lane.
+     * @param  i  Lane index.
+     * @param  w  Vector for lane i.
+     */
+    void set(size_t i, const Vector3 &w)
+    {
+        x.v[i] = w.x;
+        y.v[i] = w.y;
+        z.v[i] = w.z;
+    }
+
+    Vector3xN operator+(const Vector3xN &w) const { return {x + w.x, y + w.y, z + w.z}; }
+    Vector3xN operator-(const Vector3xN &w) const { return {x - w.x, y - w.y, z - w.z}; }
+    Vector3xN operator*(const FloatxN<N> &s) const { return {x * s, y * s, z * s}; }
+    Vector3xN operator*(float s) const { return {x * s, y * s, z * s}; }
+    Vector3xN operator-() const { return {-x, -y, -z}; }
+
+    /**
+     * Dot product per lane.
+     * @param  w  Vectors to dot with.
+     * @return  Returns the dot products.
+     */
+    FloatxN<N> dot(const Vector3xN &w) const { return x * w.x + y * w.y + z * w.z; }
+
+    /**
+     * Cross product per lane (current X w).
+     * @param  w  Vectors to cross with.
+     * @return  Returns the cross products.
+     */
+    Vector3xN cross(const Vector3xN &w) const
+    {
+        return {y * w.z - z * w.y, z * w.x - x * w.z, x * w.y - y * w.x};
+    }
+
+    FloatxN<N> norm_squared() const { return dot(*this); }
+
+    FloatxN<N> norm() const { return packet_sqrt(norm_squared()); }
+
+    /**
+     * Normalizes each lane. As Vector3::normalize, lanes with a norm of 0
+     * (<= EPSILON) are left unchanged.
+     * @return  Returns the address of the current packet.
+     */
+    Vector3xN &normalize()
+    {
+        FloatxN<N> n = norm();
+        FloatxN<N> inv = select(n > EPSILON, FloatxN<N>::broadcast(1.0f) / n,
+                                FloatxN<N>::broadcast(1.0f));
+        x = x * inv;
+        y = y * inv;
+        z = z * inv;
+        return *this;
+    }
+
+    /**
+     * Component of each lane along w (0 where w is 0).
+     * @param  w  Vectors.
+     * @return  Returns the components.
+     */
+    FloatxN<N> component(const Vector3xN &w) const
+    {
+        FloatxN<N> n = w.dot(w);
+        return select(n != 0.0f, dot(w) / n, FloatxN<N>::broadcast(0.0f));
+    }
+
+    /**
+     * Projection of each lane onto w.
+     * @param  w  Vectors to project onto.
+     * @return  Returns the projections.
+     */
+    Vector3xN projection(const Vector3xN &w) const { return w * component(w); }
+
+    /**
+     * Reflects each lane given unit length normals.
+     * @param  normal  Normals to the reflecting surfaces.
+     * @return  Returns the reflected vectors.
+     */
+    Vector3xN reflect(const Vector3xN &normal) const
+    {
+        return *this - normal * (dot(normal) * 2.0f);
+    }
+};
+
+/**
+ * Chooses per lane between 2 vector packets.
+ */
+template <size_t N>
+Vector3xN<N> select(const MaskxN<N> &mask, const Vector3xN<N> &a, const Vector3xN<N> &b)
+{
+    return {select(mask, a.x, b.x), select(mask, a.y, b.y), select(mask, a.z, b.z)};
+}
+
+/**
+ * Packet of N 3D points (structure of arrays).
+ */
+template <size_t N>
+struct Point3xN
+{
+    FloatxN<N> x;
+    FloatxN<N> y;
+    FloatxN<N> z;
+
+    static Point3xN broadcast(const Point3 &p)
+    {
+        return {FloatxN<N>::broadcast(p.x), FloatxN<N>::broadcast(p.y),
+                FloatxN<N>::broadcast(p.z)};
+    }
+
+    /**
+     * Loads up to N points. Lanes at or beyond count repeat the last point
+     * so that padded lanes give valid (duplicate) results.
+     * @param  p      Source points.
+     * @param  count  Number of points to read (1 to N).
+     * @return  Returns the packet.
+     */
+    static Point3xN load(const Point3 *p, size_t count = N)
+    {
+        Point3xN r;
+        for(size_t i = 0; i < N; i++) r.set(i, p[(i < count) ? i : count - 1]);
+        return r;
+    }
+
+    void store(Point3 *p, size_t count = N) const
+    {
+        for(size_t i = 0; i < count && i < N; i++) p[i] = get(i);
+    }
+
+    Point3 get(size_t i) const { return Point3(x.v[i], y.v[i], z.v[i]); }
+
+    void set(size_t i, const Point3 &p)
+    {
+        x.v[i] = p.x;
+        y.v[i] = p.y;
+        z.v[i] = p.z;
+    }
+
+    Point3xN operator+(const Vector3xN<N> &v) const { return {x + v.x, y + v.y, z + v.z}; }
+    Point3xN operator-(const Vector3xN<N> &v) const { return {x - v.x, y - v.y, z - v.z}; }
+    Vector3xN<N> operator-(const Point3xN &p) const { return {x - p.x, y - p.y, z - p.z}; }
+};
+
+template <size_t N>
+Point3xN<N> select(const MaskxN<N> &mask, const Point3xN<N> &a, const Point3xN<N> &b)
+{
+    return {select(mask, a.x, b.x), select(mask, a.y, b.y), select(mask, a.z, b.z)};
+}
+
+/**
+ * Converts a list of points to packets. The last packet is padded by
+ * repeating the final point.
+ * @param  points  Points to convert.
+ * @return  Returns ceil(points.size() / N) packets.
+ */
+template <size_t N>
+std::vector<Point3xN<N>> to_packets(const std::vector<Point3> &points)
+{
+    std::vector<Point3xN<N>> packets((points.size() + N - 1) / N);
+    for(size_t i = 0; i < packets.size(); i++)
+    {
+        size_t first = i * N;
+        packets[i] = Point3xN<N>::load(&points[first], std::min(N, points.size() - first));
+    }
+    return packets;
+}
+
+/**
+ * Converts packets back to a list of points.
+ * @param  packets  Packets to convert.
+ * @param  count    Number of points (excludes padding in the last packet).
+ * @return  Returns the points.
+ */
+template <size_t N>
+std::vector<Point3> from_packets(const std::vector<Point3xN<N>> &packets, size_t count)
+{
+    std::vector<Point3> points(count);
+    for(size_t i = 0; i < packets.size() && i * N < count; i++)
+    {
+        packets[i].store(&points[i * N], std::min(N, count - i * N));
+    }
+    return points;
+}
+
+// Packet widths matching SSE (4 lanes) and AVX (8 lanes) registers
+using Floatx4 = FloatxN<4>;
+using Floatx8 = FloatxN<8>;
+using Maskx4 = MaskxN<4>;
+using Maskx8 = MaskxN<8>;
+using Vector3x4 = Vector3xN<4>;
+using Vector3x8 = Vector3xN<8>;
+using Point3x4 = Point3xN<4>;
+using Point3x8 = Point3xN<8>;
+
+} // namespace cg
+
+#endif
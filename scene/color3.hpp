@@ -12,7 +12,9 @@
 #ifndef __SCENE_COLOR3_HPP__
 #define __SCENE_COLOR3_HPP__
 
+#include <algorithm>
 #include <cstdint>
+#include <type_traits>
 
 namespace cg
 {
@@ -34,7 +36,7 @@ struct Color3
     /**
      * Constructor.  Values default to 0,0,0.
      */
-    Color3();
+    constexpr Color3();
 
     /**
      * Constructor.  Set RGB to specified values. Clamps to range [0.0, 1.0]
@@ -42,13 +44,13 @@ struct Color3
      * @param	green		Green intensity
      * @param	blue		Blue intensity
      */
-    Color3(float red, float green, float blue);
+    constexpr Color3(float red, float green, float blue);
 
     /**
      * Copy constructor.
      * @param	c	Color assigned to member.
      */
-    Color3(const Color3 &c);
+    Color3(const Color3 &c) = default;
 
     /**
      * Copy constructor given an RGBA color (ignores alpha).
@@ -61,7 +63,7 @@ struct Color3
      * @param	c	Color to assign to the object.
      * @return	Returns the address of the member data.
      */
-    Color3 &operator=(const Color3 &c);
+    Color3 &operator=(const Color3 &c) = default;
 
     /**
      *	Set the color to the specified RGB values.
@@ -69,27 +71,27 @@ struct Color3
      * @param	ig		Green intensity
      * @param	ib		Blue intensity
      */
-    void set(float ir, float ig, float ib);
+    constexpr void set(float ir, float ig, float ib);
 
     /**
      * Get the red value in the range 0-255
      */
-    uint8_t r_byte() const;
+    constexpr uint8_t r_byte() const;
 
     /**
      * Get the green value in the range 0-255
      */
-    uint8_t g_byte() const;
+    constexpr uint8_t g_byte() const;
 
     /**
      * Get the blue value in the range 0-255
      */
-    uint8_t b_byte() const;
+    constexpr uint8_t b_byte() const;
 
     /**
      * Multiplication operator: Multiplies the color by another color
      */
-    Color3 operator*(const Color3 &color) const;
+    constexpr Color3 operator*(const Color3 &color) const;
 
     /**
      * Multiplication operator: Multiplies the color by an RGBA color.
@@ -101,12 +103,12 @@ struct Color3
     /**
      * Scales the color by a scalar factor.
      */
-    Color3 operator*(float factor);
+    constexpr Color3 operator*(float factor);
 
     /**
      * Adds another color to the current color. Clamps to the valid range.
      */
-    Color3 &operator+=(const Color3 &color);
+    constexpr Color3 &operator+=(const Color3 &color);
 
     /**
      * Creates a new color that is the current color plus the
@@ -114,12 +116,64 @@ struct Color3
      * @param   c  Color to add to the current color.
      * @return  Returns the resulting color.
      */
-    Color3 operator+(const Color3 &c) const;
+    constexpr Color3 operator+(const Color3 &c) const;
 
     // Clamps a color to the range [0.0, 1.0]
-    void clamp();
+    constexpr void clamp();
 };
 
+static_assert(sizeof(Color3) == 3 * sizeof(float), "Color3 must be tightly packed");
+static_assert(std::is_trivially_copyable<Color3>::value, "Color3 must be trivially copyable");
+
+// Inline definitions
+
+constexpr Color3::Color3() : r(0.0f), g(0.0f), b(0.0f) {}
+
+constexpr Color3::Color3(float red, float green, float blue) : r(red), g(green), b(blue) {}
+
+constexpr void Color3::set(float ir, float ig, float ib)
+{
+    r = ir;
+    g = ig;
+    b = ib;
+}
+
+constexpr uint8_t Color3::r_byte() const { return static_cast<uint8_t>(r * 255.0f); }
+
+constexpr uint8_t Color3::g_byte() const { return static_cast<uint8_t>(g * 255.0f); }
+
+constexpr uint8_t Color3::b_byte() const { return static_cast<uint8_t>(b * 255.0f); }
+
+constexpr Color3 Color3::operator*(const Color3 &color) const
+{
+    return Color3(r * color.r, g * color.g, b * color.b);
+}
+
+constexpr Color3 Color3::operator*(float factor)
+{
+    return Color3(r * factor, g * factor, b * factor);
+}
+
+constexpr Color3 &Color3::operator+=(const Color3 &color)
+{
+    r += color.r;
+    g += color.g;
+    b += color.b;
+    return *this;
+}
+
+constexpr Color3 Color3::operator+(const Color3 &c) const
+{
+    return Color3(r + c.r, g + c.g, b + c.b);
+}
+
+constexpr void Color3::clamp()
+{
+    r = std::min(std::max(r, 0.0f), 1.0f);
+    g = std::min(std::max(g, 0.0f), 1.0f);
+    b = std::min(std::max(b, 0.0f), 1.0f);
+}
+
 } // namespace cg
 
 #endif
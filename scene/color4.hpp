@@ -14,7 +14,9 @@
 
 #include "scene/color3.hpp"
 
+#include <algorithm>
 #include <cstdint>
+#include <type_traits>
 
 namespace cg
 {
@@ -33,7 +35,7 @@ struct Color4
     /**
      * Constructor.  Values default to 0,0,0.
      */
-    Color4(void);
+    constexpr Color4(void);
 
     /**
      * Constructor. Set RGB to specified values. Clamps to range [0.0, 1.0]
@@ -42,7 +44,7 @@ struct Color4
      * @param	blue    Blue intensity
      * @param	alpha   Alpha value for blending
      */
-    Color4(float red, float green, float blue, float alpha);
+    constexpr Color4(float red, float green, float blue, float alpha);
 
     /**
      * Constructor with RGB. Sets A to 1.0. Clamps to range [0.0, 1.0]
@@ -50,27 +52,27 @@ struct Color4
      * @param	green   Green intensity
      * @param	blue    Blue intensity
      */
-    Color4(float red, float green, float blue);
+    constexpr Color4(float red, float green, float blue);
 
     /**
      * Constructor from a Color3. Sets A to 1.0f. Should be no need to clamp
      * since Color3 must have been clamped to [0,1] range.
      * @param c Color assigned to member.
      */
-    Color4(const Color3 &c);
+    constexpr Color4(const Color3 &c);
 
     /**
      * Copy constructor.
      * @param c Color assigned to member.
      */
-    Color4(const Color4 &c);
+    Color4(const Color4 &c) = default;
 
     /**
      * Assignment operator.
      * @param  c Color to assign to the object.
      * @return Returns the address of the member data.
      */
-    Color4 &operator=(const Color4 &c);
+    Color4 &operator=(const Color4 &c) = default;
 
     /**
      *	Set the color to the specified RGB values.
@@ -78,36 +80,36 @@ struct Color4
      * @param	ig		Green intensity
      * @param	ib		Blue intensity
      */
-    void set(float ir, float ig, float ib, float ia);
+    constexpr void set(float ir, float ig, float ib, float ia);
 
     /**
      * Get the red value in the range 0-255
      * @return  Returns red value as a [0-255] value
      */
-    uint8_t r_byte() const;
+    constexpr uint8_t r_byte() const;
 
     /**
      * Get the green value in the range 0-255
      * @return  Returns green value as a [0-255] value
      */
-    uint8_t g_byte() const;
+    constexpr uint8_t g_byte() const;
 
     /**
      * Get the blue value in the range 0-255
      * @return  Returns blue value as a [0-255] value
      */
-    uint8_t b_byte() const;
+    constexpr uint8_t b_byte() const;
 
     /**
      * Get the alpha value in the range 0-255
      * @return  Returns alpha value as a [0-255] value
      */
-    uint8_t a_byte() const;
+    constexpr uint8_t a_byte() const;
 
     /**
      * Multiplication operator: Multiplies the color by another color
      */
-    Color4 operator*(const Color4 &color) const;
+    constexpr Color4 operator*(const Color4 &color) const;
 
     /**
      * Multiplication operator: Multiplies the color by another color (RGB only).
@@ -119,12 +121,12 @@ struct Color4
     /**
      * Scales the color by a scalar factor.
      */
-    Color4 operator*(float factor);
+    constexpr Color4 operator*(float factor);
 
     /**
      * Adds another color to the current color. Clamps to the valid range.
      */
-    Color4 &operator+=(const Color4 &color);
+    constexpr Color4 &operator+=(const Color4 &color);
 
     /**
      * Creates a new color that is the current color plus the
@@ -132,14 +134,78 @@ struct Color4
      * @param   c  Color to add to the current color.
      * @return  Returns the resulting color.
      */
-    Color4 operator+(const Color4 &c) const;
+    constexpr Color4 operator+(const Color4 &c) const;
 
     /**
      * Clamps a color to the range [0.0, 1.0].
      */
-    void clamp();
+    constexpr void clamp();
 };
 
+static_assert(sizeof(Color4) == 4 * sizeof(float), "Color4 must be tightly packed");
+static_assert(std::is_trivially_copyable<Color4>::value, "Color4 must be trivially copyable");
+
+// Inline definitions
+
+constexpr Color4::Color4(void) : r(0.0f), g(0.0f), b(0.0f), a(1.0f) {}
+
+constexpr Color4::Color4(float red, float green, float blue, float alpha) :
+    r(red), g(green), b(blue), a(alpha)
+{
+}
+
+constexpr Color4::Color4(float red, float green, float blue) : r(red), g(green), b(blue), a(1.0f) {}
+
+constexpr Color4::Color4(const Color3 &c) : r(c.r), g(c.g), b(c.b), a(1.0f) {}
+
+constexpr void Color4::set(float ir, float ig, float ib, float ia)
+{
+    r = ir;
+    g = ig;
+    b = ib;
+    a = ia;
+}
+
+constexpr uint8_t Color4::r_byte() const { return static_cast<uint8_t>(r * 255.0f); }
+
+constexpr uint8_t Color4::g_byte() const { return static_cast<uint8_t>(g * 255.0f); }
+
+constexpr uint8_t Color4::b_byte() const { return static_cast<uint8_t>(b * 255.0f); }
+
+constexpr uint8_t Color4::a_byte() const { return static_cast<uint8_t>(a * 255.0f); }
+
+constexpr Color4 Color4::operator*(const Color4 &color) const
+{
+    return Color4(r * color.r, g * color.g, b * color.b, a * color.a);
+}
+
+constexpr Color4 Color4::operator*(float factor)
+{
+    return Color4(r * factor, g * factor, b * factor, a * factor);
+}
+
+constexpr Color4 &Color4::operator+=(const Color4 &color)
+{
+    r += color.r;
+    g += color.g;
+    b += color.b;
+    a += color.a;
+    return *this;
+}
+
+constexpr Color4 Color4::operator+(const Color4 &c) const
+{
+    return Color4(r + c.r, g + c.g, b + c.b, a + c.a);
+}
+
+constexpr void Color4::clamp()
+{
+    r = std::min(std::max(r, 0.0f), 1.0f);
+    g = std::min(std::max(g, 0.0f), 1.0f);
+    b = std::min(std::max(b, 0.0f), 1.0f);
+    a = std::min(std::max(a, 0.0f), 1.0f);
+}
+
 } // namespace cg
 
 #endif
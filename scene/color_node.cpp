@@ -1,5 +1,8 @@
 #include "scene/color_node.hpp"
 
+#include "scene/gl_state_cache.hpp"
+#include "scene/render_list.hpp"
+
 namespace cg
 {
 
@@ -10,8 +13,16 @@ ColorNode::ColorNode(const Color4 &c) { material_color_ = c; }
 void ColorNode::draw(SceneState &scene_state)
 {
     // Set the current color and draw all children. Very simple lighting support
-    glUniform3fv(scene_state.material_diffuse_loc, 1, &material_color_.r);
+    gl_state().uniform3fv(scene_state.material_diffuse_loc, &material_color_.r);
     SceneNode::draw(scene_state);
 }
 
+void ColorNode::compile(RenderCompiler &compiler)
+{
+    uint32_t material = compiler.material;
+    compiler.material = compiler.list.add_material(material_color_);
+    compile_children(compiler);
+    compiler.material = material;
+}
+
 } // namespace cg
@@ -40,6 +40,13 @@ class ColorNode : public PresentationNode
      */
     void draw(SceneState &scene_state) override;
 
+    /**
+     * Compile this presentation node and its children. The color becomes
+     * the material of the draw records below it.
+     * @param  compiler  Render list being compiled.
+     */
+    void compile(RenderCompiler &compiler) override;
+
   protected:
     Color4 material_color_;
 };
@@ -1,5 +1,7 @@
 #include "scene/geometry_node.hpp"
 
+#include "scene/render_list.hpp"
+
 namespace cg
 {
 
@@ -9,4 +11,13 @@ GeometryNode::~GeometryNode() {}
 
 void GeometryNode::draw(SceneState &scene_state) {}
 
+bool GeometryNode::get_draw_call(const SceneState &, DrawCall &) { return false; }
+
+void GeometryNode::compile(RenderCompiler &compiler)
+{
+    DrawCall call;
+    if(get_draw_call(compiler.state, call)) compiler.list.add_draw(compiler, call);
+    else compiler.list.add_node(compiler, this);
+}
+
 } // namespace cg
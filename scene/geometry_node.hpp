@@ -17,6 +17,17 @@
 namespace cg
 {
 
+/**
+ * Vertex range drawn from a vertex array object with glDrawArrays.
+ */
+struct DrawCall
+{
+    GLuint  vao;   // Vertex array object (attributes already set up)
+    GLenum  mode;  // Primitive type
+    GLint   first; // First vertex
+    GLsizei count; // Number of vertices
+};
+
 /**
  * Geometry node base class. Stores and draws geometry.
  */
@@ -38,6 +49,23 @@ class GeometryNode : public SceneNode
      * @param  scene_state  Current scene state
      */
     virtual void draw(SceneState &scene_state) override;
+
+    /**
+     * Gets the geometry as a single draw call so render lists can draw it
+     * without calling draw(). The vertex array object must have its
+     * attributes set up for the locations in the scene state.
+     * @param  scene_state  Scene state holding the attribute locations
+     * @param  call         Receives the draw call.
+     * @return  Returns true if the geometry is a single draw call, false
+     *          if it must be drawn with draw() (the default).
+     */
+    virtual bool get_draw_call(const SceneState &scene_state, DrawCall &call);
+
+    /**
+     * Adds a draw record for the geometry to a render list.
+     * @param  compiler  Render list being compiled.
+     */
+    void compile(RenderCompiler &compiler) override;
 };
 
 } // namespace cg
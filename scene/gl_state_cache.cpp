@@ -0,0 +1,183 @@
+#include "scene/gl_state_cache.hpp"
+
+#include <cstring>
+
+namespace cg
+{
+
+GLStateCache::GLStateCache() : issued_{}, skipped_{} { invalidate(); }
+
+void GLStateCache::invalidate()
+{
+    program_ = vao_ = array_buffer_ = UNKNOWN;
+    blend_ = depth_test_ = cull_face_ = -1;
+    blend_src_ = blend_dst_ = cull_mode_ = UNKNOWN;
+    program_uniforms_.clear();
+    uniforms_ = nullptr;
+}
+
+void GLStateCache::forget_program(GLuint program)
+{
+    if(program == program_)
+    {
+        program_ = UNKNOWN;
+        uniforms_ = nullptr;
+    }
+    program_uniforms_.erase(program);
+}
+
+void GLStateCache::forget_vertex_array(GLuint vao)
+{
+    if(vao == vao_) vao_ = 0;
+}
+
+void GLStateCache::forget_buffer(GLuint buffer)
+{
+    if(buffer == array_buffer_) array_buffer_ = 0;
+}
+
+void GLStateCache::use_program(GLuint program)
+{
+    if(program == program_)
+    {
+        skipped_.programs++;
+        return;
+    }
+    glUseProgram(program);
+    issued_.programs++;
+    program_ = program;
+    uniforms_ = &program_uniforms_[program];
+}
+
+void GLStateCache::bind_vertex_array(GLuint vao)
+{
+    if(vao == vao_)
+    {
+        skipped_.vertex_arrays++;
+        return;
+    }
+    glBindVertexArray(vao);
+    issued_.vertex_arrays++;
+    vao_ = vao;
+}
+
+void GLStateCache::bind_buffer(GLenum target, GLuint buffer)
+{
+    if(target == GL_ARRAY_BUFFER)
+    {
+        if(buffer == array_buffer_)
+        {
+            skipped_.buffers++;
+            return;
+        }
+        array_buffer_ = buffer;
+    }
+    glBindBuffer(target, buffer);
+    issued_.buffers++;
+}
+
+void GLStateCache::set_enabled(GLenum cap, bool enabled)
+{
+    int32_t *state = nullptr;
+    if(cap == GL_BLEND) state = &blend_;
+    else if(cap == GL_DEPTH_TEST) state = &depth_test_;
+    else if(cap == GL_CULL_FACE) state = &cull_face_;
+    if(state != nullptr)
+    {
+        if(*state == (enabled ? 1 : 0))
+        {
+            skipped_.capabilities++;
+            return;
+        }
+        *state = enabled ? 1 : 0;
+    }
+    if(enabled) glEnable(cap);
+    else glDisable(cap);
+    issued_.capabilities++;
+}
+
+void GLStateCache::blend_func(GLenum src, GLenum dst)
+{
+    if(src == blend_src_ && dst == blend_dst_)
+    {
+        skipped_.functions++;
+        return;
+    }
+    glBlendFunc(src, dst);
+    issued_.functions++;
+    blend_src_ = src;
+    blend_dst_ = dst;
+}
+
+void GLStateCache::cull_face(GLenum mode)
+{
+    if(mode == cull_mode_)
+    {
+        skipped_.functions++;
+        return;
+    }
+    glCullFace(mode);
+    issued_.functions++;
+    cull_mode_ = mode;
+}
+
+void GLStateCache::uniform1i(GLint loc, GLint v)
+{
+    GLfloat bits;
+    std::memcpy(&bits, &v, sizeof(bits));
+    if(uniform_set(loc, &bits, 1)) return;
+    glUniform1i(loc, v);
+}
+
+void GLStateCache::uniform3fv(GLint loc, const GLfloat *v)
+{
+    if(uniform_set(loc, v, 3)) return;
+    glUniform3fv(loc, 1, v);
+}
+
+void GLStateCache::uniform4fv(GLint loc, const GLfloat *v)
+{
+    if(uniform_set(loc, v, 4)) return;
+    glUniform4fv(loc, 1, v);
+}
+
+void GLStateCache::uniform_matrix4fv(GLint loc, const GLfloat *m)
+{
+    if(uniform_set(loc, m, 16)) return;
+    glUniformMatrix4fv(loc, 1, GL_FALSE, m);
+}
+
+const GLStateCounters &GLStateCache::get_issued() const { return issued_; }
+
+const GLStateCounters &GLStateCache::get_skipped() const { return skipped_; }
+
+void GLStateCache::reset_counters() { issued_ = skipped_ = {}; }
+
+bool GLStateCache::uniform_set(GLint loc, const GLfloat *v, uint32_t count)
+{
+    // Location -1 is ignored by OpenGL. Values of an unknown program
+    // cannot be tracked.
+    bool same = loc < 0;
+    if(!same && uniforms_ != nullptr)
+    {
+        if(static_cast<size_t>(loc) >= uniforms_->size())
+            uniforms_->resize(loc + 1, Uniform{0, {}});
+        Uniform &u = (*uniforms_)[loc];
+        same = u.count == count && std::memcmp(u.values, v, count * sizeof(GLfloat)) == 0;
+        u.count = count;
+        std::memcpy(u.values, v, count * sizeof(GLfloat));
+    }
+    if(same) skipped_.uniforms++;
+    else issued_.uniforms++;
+    return same;
+}
+
+GLStateCache &gl_state()
+{
+    // Never destroyed, so nodes owned by globals can still forget their
+    // objects in their destructors during static destruction
+    static GLStateCache *cache = new GLStateCache();
+    return *cache;
+}
+
+} // namespace cg
@@ -0,0 +1,211 @@
+//============================================================================
+//	Johns Hopkins University Engineering for Professionals
+//	605.667 Computer Graphics and 605.767 Applied Computer Graphics
+//	Instructor:	Brian Russin
+//
+//	Author:  Kyle Meyer
+//	File:    gl_state_cache.hpp
+//	Purpose: Shadow copy of the OpenGL state the scene nodes change
+//           (program, vertex array, array buffer, blend, depth and cull
+//           state, uniform values per program). Calls that would not
+//           change the state are skipped and counted.
+//============================================================================
+
+#ifndef __SCENE_GL_STATE_CACHE_HPP__
+#define __SCENE_GL_STATE_CACHE_HPP__
+
+#include "scene/graphics.hpp"
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace cg
+{
+
+/**
+ * Numbers of OpenGL calls by kind of state.
+ */
+struct GLStateCounters
+{
+    uint64_t programs;      // glUseProgram
+    uint64_t vertex_arrays; // glBindVertexArray
+    uint64_t buffers;       // glBindBuffer
+    uint64_t capabilities;  // glEnable / glDisable of blend, depth test, cull face
+    uint64_t functions;     // glBlendFunc, glCullFace
+    uint64_t uniforms;      // glUniform*
+};
+
+/**
+ * OpenGL state cache. The shadow state is only right if all changes to the
+ * shadowed state go through the cache: code that calls OpenGL directly
+ * must call invalidate() (or the matching forget_ method after deleting an
+ * object) afterwards. Until a state is first set through the cache it is
+ * unknown and the first call is always made.
+ */
+class GLStateCache
+{
+  public:
+    /**
+     * Constructor. All state is unknown.
+     */
+    GLStateCache();
+
+    /**
+     * Forgets all shadowed state (e.g. after calling OpenGL directly).
+     */
+    void invalidate();
+
+    /**
+     * Forgets a deleted or relinked program and its uniform values.
+     * @param  program  Program.
+     */
+    void forget_program(GLuint program);
+
+    /**
+     * Forgets a deleted vertex array (deleting the bound one binds 0).
+     * @param  vao  Vertex array object.
+     */
+    void forget_vertex_array(GLuint vao);
+
+    /**
+     * Forgets a deleted buffer (deleting the bound one binds 0).
+     * @param  buffer  Buffer object.
+     */
+    void forget_buffer(GLuint buffer);
+
+    /**
+     * Uses a program (glUseProgram).
+     * @param  program  Program.
+     */
+    void use_program(GLuint program);
+
+    /**
+     * Binds a vertex array object (glBindVertexArray).
+     * @param  vao  Vertex array object.
+     */
+    void bind_vertex_array(GLuint vao);
+
+    /**
+     * Binds a buffer (glBindBuffer). Only GL_ARRAY_BUFFER is shadowed;
+     * other targets (the element array binding is vertex array state) are
+     * passed through.
+     * @param  target  Buffer target.
+     * @param  buffer  Buffer object.
+     */
+    void bind_buffer(GLenum target, GLuint buffer);
+
+    /**
+     * Enables or disables a capability (glEnable / glDisable). GL_BLEND,
+     * GL_DEPTH_TEST and GL_CULL_FACE are shadowed, others passed through.
+     * @param  cap      Capability.
+     * @param  enabled  True to enable.
+     */
+    void set_enabled(GLenum cap, bool enabled);
+
+    /**
+     * Sets the blend function (glBlendFunc).
+     * @param  src  Source factor.
+     * @param  dst  Destination factor.
+     */
+    void blend_func(GLenum src, GLenum dst);
+
+    /**
+     * Sets the faces culled (glCullFace).
+     * @param  mode  GL_FRONT, GL_BACK or GL_FRONT_AND_BACK.
+     */
+    void cull_face(GLenum mode);
+
+    /**
+     * Sets an int or bool uniform of the current program (glUniform1i).
+     * Location -1 is ignored, as by OpenGL.
+     * @param  loc  Uniform location.
+     * @param  v    Value.
+     */
+    void uniform1i(GLint loc, GLint v);
+
+    /**
+     * Sets a vec3 uniform of the current program (glUniform3fv). Location
+     * -1 is ignored, as by OpenGL.
+     * @param  loc  Uniform location.
+     * @param  v    3 values.
+     */
+    void uniform3fv(GLint loc, const GLfloat *v);
+
+    /**
+     * Sets a vec4 uniform of the current program (glUniform4fv).
+     * @param  loc  Uniform location.
+     * @param  v    4 values.
+     */
+    void uniform4fv(GLint loc, const GLfloat *v);
+
+    /**
+     * Sets a mat4 uniform of the current program (glUniformMatrix4fv, not
+     * transposed).
+     * @param  loc  Uniform location.
+     * @param  m    16 values, column major.
+     */
+    void uniform_matrix4fv(GLint loc, const GLfloat *m);
+
+    /**
+     * Gets the numbers of calls made to OpenGL.
+     * @return  Returns the counts.
+     */
+    const GLStateCounters &get_issued() const;
+
+    /**
+     * Gets the numbers of calls skipped as redundant.
+     * @return  Returns the counts.
+     */
+    const GLStateCounters &get_skipped() const;
+
+    /**
+     * Sets the call counts to 0.
+     */
+    void reset_counters();
+
+  protected:
+    // Uniform value and its number of floats (0 = unknown). An int is
+    // stored as the bits of one float.
+    struct Uniform
+    {
+        uint32_t count;
+        GLfloat  values[16];
+    };
+
+    // Shadowed state. UNKNOWN (or -1 for the capabilities) when unknown
+    static constexpr GLuint UNKNOWN = 0xffffffff;
+    GLuint                  program_;
+    GLuint                  vao_;
+    GLuint                  array_buffer_;
+    int32_t                 blend_;
+    int32_t                 depth_test_;
+    int32_t                 cull_face_;
+    GLenum                  blend_src_;
+    GLenum                  blend_dst_;
+    GLenum                  cull_mode_;
+
+    // Uniform values by program and location. uniforms_ points at the
+    // values of the current program (nullptr if it is unknown).
+    std::unordered_map<GLuint, std::vector<Uniform>> program_uniforms_;
+    std::vector<Uniform>                             *uniforms_;
+
+    GLStateCounters issued_;
+    GLStateCounters skipped_;
+
+    // Returns true if a uniform is already set to the values, else records
+    // them and returns false
+    bool uniform_set(GLint loc, const GLfloat *v, uint32_t count);
+};
+
+/**
+ * Gets the state cache. These programs use one OpenGL context, current on
+ * the thread that draws, so this is the cache for that context; call it
+ * only from that thread. Invalidate it when the context is destroyed.
+ * @return  Returns the cache.
+ */
+GLStateCache &gl_state();
+
+} // namespace cg
+
+#endif
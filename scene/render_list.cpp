@@ -0,0 +1,520 @@
+#include "scene/render_list.hpp"
+
+#include "scene/gl_state_cache.hpp"
+#include "scene/transform_node.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace cg
+{
+
+namespace
+{
+// Current program / transform / material before anything is set
+constexpr uint32_t UNSET = RenderList::NONE - 1;
+
+// Smallest group of records drawn instanced. Setting up the instance
+// attributes costs about as many calls as drawing a few records with
+// uniforms.
+constexpr size_t MIN_INSTANCES = 8;
+
+// Sort key, high to low bits. Opaque: pass (2 bits), program (12), vertex
+// array (12), material (14), depth (24). Blended: pass, inverted depth,
+// program, vertex array, material. Indices too large for their field
+// share its largest value, which only makes the sort less effective.
+constexpr uint32_t PASS_SHIFT = 62;
+constexpr uint32_t PROGRAM_BITS = 12;
+constexpr uint32_t VAO_BITS = 12;
+constexpr uint32_t MATERIAL_BITS = 14;
+constexpr uint32_t DEPTH_BITS = 24;
+constexpr uint64_t DEPTH_MAX = (uint64_t(1) << DEPTH_BITS) - 1;
+constexpr uint64_t PASS_BLENDED = uint64_t(1) << PASS_SHIFT;
+
+uint64_t key_field(uint32_t value, uint32_t bits)
+{
+    return std::min<uint64_t>(value, (uint64_t(1) << bits) - 1);
+}
+
+// Depth of the origin of a model (NDC z mapped to [0, DEPTH_MAX]), with
+// the origins behind the eye nearest
+uint64_t key_depth(const Matrix4x4 &pvm)
+{
+    const float *m = pvm.get();
+    float        z = m[15] > 0.0f ? m[14] / m[15] : -1.0f;
+    z = z * 0.5f + 0.5f;
+    if(!(z > 0.0f)) return 0;
+    if(z >= 1.0f) return DEPTH_MAX;
+    return static_cast<uint64_t>(z * static_cast<float>(DEPTH_MAX));
+}
+
+// Enables a per-instance float attribute of the bound vertex array at an
+// offset in the bound array buffer
+void enable_instance_attribute(GLuint loc, GLint size, GLsizei stride, size_t offset)
+{
+    glEnableVertexAttribArray(loc);
+    glVertexAttribPointer(
+        loc, size, GL_FLOAT, GL_FALSE, stride, reinterpret_cast<const void *>(offset));
+    glVertexAttribDivisor(loc, 1);
+}
+
+// Disables a per-instance attribute of the bound vertex array and resets
+// its divisor, which is vertex array state, so later per-vertex use of
+// the location reads one value per vertex again
+void disable_instance_attribute(GLuint loc)
+{
+    glDisableVertexAttribArray(loc);
+    glVertexAttribDivisor(loc, 0);
+}
+} // namespace
+
+RenderList::RenderList()
+    : structure_version_(0), pv_version_(0), checked_version_(0), frame_(0), compiled_(false),
+      sorted_(false), keys_valid_(false), instanced_(false), instances_valid_(false),
+      instance_buffer_(0), stats_{}
+{
+}
+
+RenderList::~RenderList() { clear(); }
+
+void RenderList::execute(const std::shared_ptr<SceneNode> &root, SceneState &scene_state)
+{
+    if(!compiled_ || root != root_ || structure_version_ != SceneNode::structure_version())
+        compile(root, scene_state);
+    bool transforms_updated = update_transforms(scene_state);
+    if(sorted_ && (transforms_updated || !keys_valid_)) sort_records();
+    if(!batches_.empty()) update_instances(transforms_updated);
+    Matrix4x4 model_matrix = scene_state.model_matrix;
+    uint64_t  model_version = scene_state.model_version;
+
+    // Only state that differs from the previous record is sent to the GL
+    // state cache. A program change moves the uniform locations, so the
+    // matrices and material are sent again after one. Blending is off
+    // outside blended materials, as in the graph.
+    GLStateCache  &gl = gl_state();
+    const Program *program = nullptr;
+    uint32_t       current_program = UNSET;
+    uint32_t       current_transform = UNSET;
+    uint32_t       current_material = UNSET;
+    GLuint         current_vao = UNSET;
+    int32_t        current_blend = 0;
+    stats_ = {records_.size(), 0, 0, 0, 0, 0, 0, 0};
+    if(!batches_.empty()) draw_batches(gl, scene_state);
+    const std::vector<uint32_t> &order = queue_.order();
+    for(size_t i = 0; i < order.size(); i++)
+    {
+        // Sorted records are read from their copies in draw order
+        const Record    &r = sorted_ ? sorted_records_[i].record : records_[singles_[order[i]]];
+        const Matrix4x4 &world = sorted_ ? sorted_records_[i].world : worlds_[r.transform];
+        const Matrix4x4 &pvm = sorted_ ? sorted_records_[i].pvm : pvms_[r.transform];
+        if(r.program != current_program)
+        {
+            current_program = r.program;
+            current_transform = current_material = UNSET;
+            program = &programs_[r.program];
+            if(program->program != 0)
+            {
+                gl.use_program(program->program);
+                stats_.programs++;
+            }
+        }
+        if(r.transform != current_transform)
+        {
+            current_transform = r.transform;
+            stats_.transforms++;
+            gl.uniform_matrix4fv(program->model_matrix_loc, world.get());
+            gl.uniform_matrix4fv(program->normal_matrix_loc, world.get());
+            gl.uniform_matrix4fv(program->pvm_matrix_loc, pvm.get());
+        }
+        if(r.material != current_material)
+        {
+            current_material = r.material;
+            int32_t blend = 0;
+            if(r.material != NONE)
+            {
+                const Material &material = materials_[r.material];
+                blend = material.blend ? 1 : 0;
+                GLint loc = material.uniform == MaterialUniform::DIFFUSE
+                                ? program->material_diffuse_loc
+                                : program->color_loc;
+                if(loc >= 0)
+                {
+                    if(material.uniform == MaterialUniform::DIFFUSE)
+                        gl.uniform3fv(loc, &material.color.r);
+                    else gl.uniform4fv(loc, &material.color.r);
+                    stats_.materials++;
+                }
+            }
+            if(blend != current_blend)
+            {
+                current_blend = blend;
+                if(blend) gl.blend_func(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+                gl.set_enabled(GL_BLEND, blend != 0);
+                stats_.blends++;
+            }
+        }
+
+        if(r.node == nullptr)
+        {
+            if(r.call.vao != current_vao)
+            {
+                current_vao = r.call.vao;
+                gl.bind_vertex_array(current_vao);
+                stats_.vaos++;
+            }
+            glDrawArrays(r.call.mode, r.call.first, r.call.count);
+            continue;
+        }
+
+        // Draw the node as the tree would, then assume it changed anything
+        scene_state.position_loc = program->position_loc;
+        scene_state.vtx_color_loc = program->vtx_color_loc;
+        scene_state.normal_loc = program->normal_loc;
+        scene_state.ortho_matrix_loc = program->ortho_matrix_loc;
+        scene_state.color_loc = program->color_loc;
+        scene_state.pvm_matrix_loc = program->pvm_matrix_loc;
+        scene_state.model_matrix_loc = program->model_matrix_loc;
+        scene_state.normal_matrix_loc = program->normal_matrix_loc;
+        scene_state.material_diffuse_loc = program->material_diffuse_loc;
+        scene_state.model_matrix = world;
+        scene_state.model_version = transforms_[r.transform].world_version;
+        r.node->draw(scene_state);
+        current_program = current_transform = current_material = current_vao = UNSET;
+        current_blend = -1;
+    }
+    if(current_blend != 0) gl.set_enabled(GL_BLEND, false);
+    scene_state.model_matrix = model_matrix;
+    scene_state.model_version = model_version;
+}
+
+void RenderList::compile(const std::shared_ptr<SceneNode> &root, const SceneState &scene_state)
+{
+    root_ = root;
+    structure_version_ = SceneNode::structure_version();
+    compiled_ = true;
+    programs_.clear();
+    materials_.clear();
+    transforms_.clear();
+    records_.clear();
+    program_indices_.clear();
+    material_indices_.clear();
+    vao_indices_.clear();
+    vao_indices_[0] = 0;
+
+    // Program 0 keeps the initial program and locations, transform 0 is
+    // the root
+    RenderCompiler compiler{*this, scene_state, 0, 0, NONE};
+    add_program(scene_state, 0);
+    add_transform(nullptr, NONE);
+    if(root) root->compile(compiler);
+
+    worlds_.resize(transforms_.size());
+    pvms_.resize(transforms_.size());
+    worlds_[0].set_identity();
+    pvms_[0] = scene_state.pv;
+    pv_version_ = scene_state.pv_version;
+    checked_version_ = 0;
+    build_batches();
+}
+
+void RenderList::set_sorted(bool sorted)
+{
+    sorted_ = sorted;
+    queue_.reset(singles_.size());
+    keys_valid_ = false;
+    if(!sorted) sorted_records_.clear();
+}
+
+void RenderList::set_instanced(bool instanced)
+{
+    instanced_ = instanced;
+    build_batches();
+}
+
+const RenderStats &RenderList::get_stats() const { return stats_; }
+
+const RenderQueue &RenderList::get_queue() const { return queue_; }
+
+void RenderList::clear()
+{
+    root_.reset();
+    compiled_ = false;
+    records_.clear();
+    build_batches();
+    if(instance_buffer_ != 0)
+    {
+        glDeleteBuffers(1, &instance_buffer_);
+        gl_state().forget_buffer(instance_buffer_);
+        instance_buffer_ = 0;
+    }
+}
+
+void RenderList::invalidate() { compiled_ = false; }
+
+size_t RenderList::size() const { return records_.size(); }
+
+uint32_t RenderList::add_program(const SceneState        &state,
+                                 GLuint                   program,
+                                 const InstanceLocations *instancing)
+{
+    if(program != 0)
+    {
+        auto index = program_indices_.emplace(program, static_cast<uint32_t>(programs_.size()));
+        if(!index.second) return index.first->second;
+    }
+    programs_.push_back({program,
+                         state.position_loc,
+                         state.vtx_color_loc,
+                         state.normal_loc,
+                         state.ortho_matrix_loc,
+                         state.color_loc,
+                         state.pvm_matrix_loc,
+                         state.model_matrix_loc,
+                         state.normal_matrix_loc,
+                         state.material_diffuse_loc,
+                         false,
+                         {-1, -1, -1, -1, -1}});
+    if(instancing != nullptr)
+    {
+        Program &p = programs_.back();
+        p.instancing = *instancing;
+        p.instanced = instancing->instanced_loc >= 0 && instancing->pv_matrix_loc >= 0 &&
+                      instancing->model_matrix_loc >= 0 &&
+                      instancing->normal_matrix_loc >= 0 && instancing->color_loc >= 0;
+    }
+    return static_cast<uint32_t>(programs_.size() - 1);
+}
+
+uint32_t RenderList::add_transform(const TransformNode *node, uint32_t parent)
+{
+    // Versions 0 never match a node's, so every matrix is computed on the
+    // first frame
+    transforms_.push_back({node, parent, 0, 0, 0});
+    return static_cast<uint32_t>(transforms_.size() - 1);
+}
+
+uint32_t RenderList::add_material(const Color4 &color, MaterialUniform uniform, bool blend)
+{
+    auto index = material_indices_.emplace(
+        MaterialKey(color.r, color.g, color.b, color.a, uniform, blend),
+        static_cast<uint32_t>(materials_.size()));
+    if(!index.second) return index.first->second;
+    materials_.push_back({color, uniform, blend});
+    return static_cast<uint32_t>(materials_.size() - 1);
+}
+
+void RenderList::add_draw(const RenderCompiler &compiler, const DrawCall &call)
+{
+    add_record(compiler, call, nullptr);
+}
+
+void RenderList::add_node(const RenderCompiler &compiler, SceneNode *node)
+{
+    add_record(compiler, {0, GL_POINTS, 0, 0}, node);
+}
+
+void RenderList::add_record(const RenderCompiler &compiler, const DrawCall &call, SceneNode *node)
+{
+    // Vertex arrays are numbered in order of first use for the sort key
+    auto     vao = vao_indices_.emplace(call.vao, static_cast<uint32_t>(vao_indices_.size()));
+    uint64_t state = (key_field(compiler.program, PROGRAM_BITS) << (VAO_BITS + MATERIAL_BITS)) |
+                     (key_field(vao.first->second, VAO_BITS) << MATERIAL_BITS) |
+                     key_field(compiler.material + 1, MATERIAL_BITS);
+    uint64_t key = state << DEPTH_BITS;
+    if(compiler.material != NONE && materials_[compiler.material].blend)
+        key = PASS_BLENDED | state;
+    records_.push_back(
+        {compiler.program, compiler.transform, compiler.material, call, node, key});
+}
+
+bool RenderList::update_transforms(const SceneState &scene_state)
+{
+    // Nothing to do if no transform or pv has changed at all
+    bool pv_changed = pv_version_ != scene_state.pv_version;
+    if(!pv_changed && checked_version_ == SceneState::last_version()) return false;
+
+    // Transforms are in preorder, so a parent is always updated before its
+    // children see whether it changed this frame
+    frame_++;
+    pv_version_ = scene_state.pv_version;
+    if(pv_changed) pvms_[0] = scene_state.pv;
+    for(size_t i = 1; i < transforms_.size(); i++)
+    {
+        Transform &t = transforms_[i];
+        if(t.node->get_version() != t.local_version || transforms_[t.parent].updated == frame_)
+        {
+            worlds_[i] = worlds_[t.parent] * t.node->get_matrix();
+            t.local_version = t.node->get_version();
+            t.world_version = SceneState::next_version();
+            t.updated = frame_;
+        }
+        else if(!pv_changed) continue;
+        pvms_[i] = scene_state.pv * worlds_[i];
+    }
+    checked_version_ = SceneState::last_version();
+    return true;
+}
+
+void RenderList::sort_records()
+{
+    // Opaque records sort front to back within their state group, blended
+    // ones back to front (the inverted depth sits above their state)
+    for(uint32_t i = 0; i < singles_.size(); i++)
+    {
+        const Record &r = records_[singles_[i]];
+        uint64_t      depth = key_depth(pvms_[r.transform]);
+        if(r.key & PASS_BLENDED)
+            queue_.set_key(i, r.key | ((DEPTH_MAX - depth) << (PASS_SHIFT - DEPTH_BITS)));
+        else queue_.set_key(i, r.key | depth);
+    }
+    queue_.sort();
+    keys_valid_ = true;
+
+    // The copies are rewritten whenever the keys are, i.e. whenever a
+    // matrix may have changed
+    const std::vector<uint32_t> &order = queue_.order();
+    sorted_records_.resize(order.size());
+    for(size_t i = 0; i < order.size(); i++)
+    {
+        SortedRecord &s = sorted_records_[i];
+        s.record = records_[singles_[order[i]]];
+        s.world = worlds_[s.record.transform];
+        s.pvm = pvms_[s.record.transform];
+    }
+}
+
+void RenderList::build_batches()
+{
+    singles_.clear();
+    sorted_records_.clear();
+    batches_.clear();
+    instances_.clear();
+    instances_valid_ = false;
+
+    // Group the records that can be instanced by program and vertex range.
+    // The uniform path sends a diffuse material as the instance color
+    // does; other materials and legacy nodes are drawn one by one.
+    using BatchKey = std::tuple<uint32_t, GLuint, GLenum, GLint, GLsizei>;
+    std::map<BatchKey, std::vector<uint32_t>> groups;
+    for(uint32_t i = 0; i < records_.size(); i++)
+    {
+        const Record &r = records_[i];
+        bool          instanceable = instanced_ && r.node == nullptr &&
+                            programs_[r.program].instanced && r.material != NONE &&
+                            materials_[r.material].uniform == MaterialUniform::DIFFUSE &&
+                            !materials_[r.material].blend;
+        if(instanceable)
+            groups[BatchKey(r.program, r.call.vao, r.call.mode, r.call.first, r.call.count)]
+                .push_back(i);
+        else singles_.push_back(i);
+    }
+
+    // Groups are in program and vertex array order, so consecutive batches
+    // share state
+    bool merged = false;
+    for(const auto &group : groups)
+    {
+        const std::vector<uint32_t> &records = group.second;
+        if(records.size() < MIN_INSTANCES)
+        {
+            singles_.insert(singles_.end(), records.begin(), records.end());
+            merged = true;
+            continue;
+        }
+        const Record &r = records_[records.front()];
+        batches_.push_back({r.program,
+                            r.call,
+                            static_cast<uint32_t>(instances_.size()),
+                            static_cast<uint32_t>(records.size())});
+        instances_.insert(instances_.end(), records.begin(), records.end());
+    }
+    if(merged) std::sort(singles_.begin(), singles_.end());
+    instance_data_.resize(instances_.size());
+
+    queue_.reset(singles_.size());
+    keys_valid_ = false;
+}
+
+void RenderList::update_instances(bool transforms_updated)
+{
+    if(instances_valid_ && !transforms_updated) return;
+
+    // Instances get the matrices the uniform path would send (the normal
+    // matrix is the world matrix, as in TransformNode)
+    bool changed = false;
+    for(size_t i = 0; i < instances_.size(); i++)
+    {
+        const Record &r = records_[instances_[i]];
+        if(instances_valid_ && transforms_[r.transform].updated != frame_) continue;
+        Instance &instance = instance_data_[i];
+        std::memcpy(instance.model, worlds_[r.transform].get(), sizeof(instance.model));
+        std::memcpy(instance.normal, worlds_[r.transform].get(), sizeof(instance.normal));
+        std::memcpy(instance.color, &materials_[r.material].color.r, sizeof(instance.color));
+        changed = true;
+    }
+    instances_valid_ = true;
+    if(!changed) return;
+
+    // The whole buffer is respecified, so the driver need not wait for
+    // draws still reading last frame's data
+    GLStateCache &gl = gl_state();
+    if(instance_buffer_ == 0) glGenBuffers(1, &instance_buffer_);
+    gl.bind_buffer(GL_ARRAY_BUFFER, instance_buffer_);
+    glBufferData(GL_ARRAY_BUFFER,
+                 instance_data_.size() * sizeof(Instance),
+                 instance_data_.data(),
+                 GL_STREAM_DRAW);
+}
+
+void RenderList::draw_batches(GLStateCache &gl, const SceneState &scene_state)
+{
+    // The instanced uniform is only true while drawing batches, so other
+    // draws with the program use the matrix and material uniforms
+    const Program *program = nullptr;
+    for(const Batch &batch : batches_)
+    {
+        if(program != &programs_[batch.program])
+        {
+            if(program != nullptr) gl.uniform1i(program->instancing.instanced_loc, 0);
+            program = &programs_[batch.program];
+            gl.use_program(program->program);
+            gl.uniform1i(program->instancing.instanced_loc, 1);
+            gl.uniform_matrix4fv(program->instancing.pv_matrix_loc, scene_state.pv.get());
+            stats_.programs++;
+        }
+
+        // Instance attributes are vertex array state. They point at the
+        // batch's instances and are disabled, with their divisors reset,
+        // after the draw, so draws of the vertex array that are not
+        // instanced do not read them.
+        gl.bind_vertex_array(batch.call.vao);
+        gl.bind_buffer(GL_ARRAY_BUFFER, instance_buffer_);
+        const InstanceLocations &loc = program->instancing;
+        GLsizei                  stride = sizeof(Instance);
+        size_t                   offset = batch.first * sizeof(Instance);
+        for(GLint c = 0; c < 4; c++)
+        {
+            size_t column = c * 4 * sizeof(GLfloat);
+            enable_instance_attribute(
+                loc.model_matrix_loc + c, 4, stride, offset + offsetof(Instance, model) + column);
+            enable_instance_attribute(loc.normal_matrix_loc + c,
+                                      4,
+                                      stride,
+                                      offset + offsetof(Instance, normal) + column);
+        }
+        enable_instance_attribute(loc.color_loc, 3, stride, offset + offsetof(Instance, color));
+        glDrawArraysInstanced(batch.call.mode, batch.call.first, batch.call.count, batch.count);
+        for(GLint c = 0; c < 4; c++)
+        {
+            disable_instance_attribute(loc.model_matrix_loc + c);
+            disable_instance_attribute(loc.normal_matrix_loc + c);
+        }
+        disable_instance_attribute(loc.color_loc);
+        stats_.vaos++;
+        stats_.batches++;
+        stats_.instances += batch.count;
+    }
+    if(program != nullptr) gl.uniform1i(program->instancing.instanced_loc, 0);
+}
+
+} // namespace cg
@@ -0,0 +1,376 @@
+//============================================================================
+//	Johns Hopkins University Engineering for Professionals
+//	605.667 Computer Graphics and 605.767 Applied Computer Graphics
+//	Instructor:	Brian Russin
+//
+//	Author:  Kyle Meyer
+//	File:    render_list.hpp
+//	Purpose: Scene graph flattened into a contiguous array of draw records
+//           (program, transform, material, vertex array and range). The
+//           list is compiled from the graph once and recompiled only when
+//           the graph structure changes; each frame it updates the world
+//           matrices of changed transforms and draws the records in order,
+//           either graph order or sorted by state and depth. Records that
+//           draw the same geometry with different transforms and colors
+//           can be drawn as one instanced draw call.
+//============================================================================
+
+#ifndef __SCENE_RENDER_LIST_HPP__
+#define __SCENE_RENDER_LIST_HPP__
+
+#include "scene/color4.hpp"
+#include "scene/geometry_node.hpp"
+#include "scene/render_queue.hpp"
+#include "scene/scene_node.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+namespace cg
+{
+
+class GLStateCache;
+class RenderList;
+class TransformNode;
+
+/**
+ * State passed down the scene graph while compiling a render list: the
+ * list and the program, transform and material that apply to the node
+ * being compiled. A node that changes one of them restores it after
+ * compiling its children.
+ */
+struct RenderCompiler
+{
+    RenderList &list;      // List being compiled
+    SceneState  state;     // Locations set by the shader nodes above
+    uint32_t    program;   // Index of the program (RenderList::add_program)
+    uint32_t    transform; // Index of the transform (RenderList::add_transform)
+    uint32_t    material;  // Index of the material or RenderList::NONE
+};
+
+/**
+ * Uniform a material color is sent to.
+ */
+enum class MaterialUniform
+{
+    DIFFUSE, // RGB to SceneState::material_diffuse_loc (ColorNode)
+    COLOR    // RGBA to SceneState::color_loc (constant color shaders)
+};
+
+/**
+ * Locations of a program's instancing inputs (see RenderList::add_program).
+ * The matrix attributes are mat4, taking 4 consecutive locations.
+ */
+struct InstanceLocations
+{
+    GLint instanced_loc;     // bool uniform: true to use the instance attributes
+    GLint pv_matrix_loc;     // Projection * view matrix uniform
+    GLint model_matrix_loc;  // Per-instance model matrix attribute
+    GLint normal_matrix_loc; // Per-instance normal matrix attribute
+    GLint color_loc;         // Per-instance material diffuse color attribute (vec3)
+};
+
+/**
+ * OpenGL state changes made by the last RenderList::execute.
+ */
+struct RenderStats
+{
+    size_t records;    // Records drawn
+    size_t programs;   // Program changes
+    size_t transforms; // Matrix uniform updates
+    size_t materials;  // Material uniform updates
+    size_t vaos;       // Vertex array binds
+    size_t blends;     // Blending enabled or disabled
+    size_t batches;    // Instanced draw calls
+    size_t instances;  // Records drawn by instanced draw calls
+};
+
+/**
+ * Render list. Draws the same image as SceneNode::draw on the graph it was
+ * compiled from, with the program, matrix, material and vertex array
+ * changes between consecutive records skipped when they are redundant.
+ * Nodes that cannot be flattened (see SceneNode::compile) become records
+ * that call their draw().
+ *
+ * Records can instead be drawn sorted to reduce state changes: opaque
+ * records first, grouped by program, vertex array and material and front
+ * to back within a group, then blended records back to front. This
+ * assumes the depth test, not graph order, decides what is in front, as
+ * in a 3D scene; a 2D scene layered by graph order should not be sorted.
+ *
+ * With instancing on, draw records of a program that supports instancing
+ * that share the vertex range and have an opaque diffuse material are
+ * grouped into batches, drawn before the other records with one
+ * glDrawArraysInstanced each. Their model and normal matrices and colors
+ * are streamed through an instance buffer, rewritten when one of them
+ * changes. This makes the same 3D assumption as sorting.
+ */
+class RenderList
+{
+  public:
+    // Index that refers to nothing
+    static constexpr uint32_t NONE = 0xffffffff;
+
+    /**
+     * Constructor. Creates an empty list.
+     */
+    RenderList();
+
+    /**
+     * Destructor. Deletes the instance buffer if clear() was not called.
+     */
+    ~RenderList();
+
+    /**
+     * Draws a scene graph. Compiles it first if it is not the graph last
+     * drawn or its structure changed. The root is drawn under the identity
+     * model matrix, as after SceneState::init.
+     * @param  root         Root of the scene graph.
+     * @param  scene_state  Current scene state (pv, initial locations).
+     */
+    void execute(const std::shared_ptr<SceneNode> &root, SceneState &scene_state);
+
+    /**
+     * Compiles a scene graph. Needs a current OpenGL context, as geometry
+     * nodes set up their vertex arrays.
+     * @param  root         Root of the scene graph.
+     * @param  scene_state  Scene state with the initial locations.
+     */
+    void compile(const std::shared_ptr<SceneNode> &root, const SceneState &scene_state);
+
+    /**
+     * Sets whether records are drawn sorted (see above) or in graph order
+     * (the default).
+     * @param  sorted  True to sort.
+     */
+    void set_sorted(bool sorted);
+
+    /**
+     * Sets whether records that draw the same geometry are drawn as
+     * instanced batches (see above). Off by default.
+     * @param  instanced  True to draw instanced batches.
+     */
+    void set_instanced(bool instanced);
+
+    /**
+     * Gets the state changes made by the last execute.
+     * @return  Returns the counts.
+     */
+    const RenderStats &get_stats() const;
+
+    /**
+     * Gets the render queue holding the draw order.
+     * @return  Returns the queue.
+     */
+    const RenderQueue &get_queue() const;
+
+    /**
+     * Releases the compiled graph and deletes the instance buffer. Call it
+     * while the OpenGL context the list drew with is still current, e.g.
+     * before destroying the context at exit.
+     */
+    void clear();
+
+    /**
+     * Forces a recompile on the next execute (e.g. after changing a color
+     * or the geometry of a node, which are copied into the list).
+     */
+    void invalidate();
+
+    /**
+     * Gets the number of draw records.
+     * @return  Returns the number of records.
+     */
+    size_t size() const;
+
+    /**
+     * Adds a program during compile. A program added before gets its
+     * earlier index.
+     * @param  state       Scene state holding the program's locations.
+     * @param  program     OpenGL program (0 = leave the current program).
+     * @param  instancing  Locations of the program's instancing inputs, or
+     *                     nullptr if it cannot draw instanced.
+     * @return  Returns the index of the program.
+     */
+    uint32_t add_program(const SceneState        &state,
+                         GLuint                   program,
+                         const InstanceLocations *instancing = nullptr);
+
+    /**
+     * Adds a transform during compile.
+     * @param  node    Transform node.
+     * @param  parent  Index of the parent transform.
+     * @return  Returns the index of the transform.
+     */
+    uint32_t add_transform(const TransformNode *node, uint32_t parent);
+
+    /**
+     * Adds a material during compile. A material equal to one added before
+     * gets its earlier index.
+     * @param  color    Material color.
+     * @param  uniform  Uniform the color is sent to.
+     * @param  blend    Draw with alpha blending (sorted back to front).
+     * @return  Returns the index of the material.
+     */
+    uint32_t add_material(const Color4     &color,
+                          MaterialUniform uniform = MaterialUniform::DIFFUSE,
+                          bool            blend = false);
+
+    /**
+     * Adds a record that draws a vertex range during compile.
+     * @param  compiler  Compile state (program, transform, material).
+     * @param  call      Draw call.
+     */
+    void add_draw(const RenderCompiler &compiler, const DrawCall &call);
+
+    /**
+     * Adds a record that draws a node with its draw() during compile.
+     * @param  compiler  Compile state (program, transform, material).
+     * @param  node      Node to draw.
+     */
+    void add_node(const RenderCompiler &compiler, SceneNode *node);
+
+  protected:
+    // Program and the locations it was compiled with
+    struct Program
+    {
+        GLuint program;
+        GLint  position_loc;
+        GLint  vtx_color_loc;
+        GLint  normal_loc;
+        GLint  ortho_matrix_loc;
+        GLint  color_loc;
+        GLint  pvm_matrix_loc;
+        GLint  model_matrix_loc;
+        GLint  normal_matrix_loc;
+        GLint  material_diffuse_loc;
+        bool              instanced; // True if instancing has all locations
+        InstanceLocations instancing;
+    };
+
+    struct Material
+    {
+        Color4          color;
+        MaterialUniform uniform;
+        bool            blend;
+    };
+
+    // Transform in preorder (parent < own index). Transform 0 is the root
+    // (identity, node nullptr). world_version identifies worlds_[i] as a
+    // SceneState model version; updated is the frame it last changed.
+    struct Transform
+    {
+        const TransformNode *node;
+        uint32_t             parent;
+        uint64_t             local_version;
+        uint64_t             world_version;
+        uint64_t             updated;
+    };
+
+    // Instanced draw of records instances_[first, first + count)
+    struct Batch
+    {
+        uint32_t program;
+        DrawCall call;
+        uint32_t first;
+        uint32_t count;
+    };
+
+    // Instance buffer contents of one record
+    struct Instance
+    {
+        GLfloat model[16];
+        GLfloat normal[16];
+        GLfloat color[3];
+    };
+
+    // Draw record. node is nullptr for a draw call, else the node to draw.
+    // key is the sort key without the depth.
+    struct Record
+    {
+        uint32_t   program;
+        uint32_t   transform;
+        uint32_t   material;
+        DrawCall   call;
+        SceneNode *node;
+        uint64_t   key;
+    };
+
+    // Record with its matrices, copied in draw order after a sort so the
+    // sorted draw reads them in memory order
+    struct SortedRecord
+    {
+        Record    record;
+        Matrix4x4 world;
+        Matrix4x4 pvm;
+    };
+
+    // Graph and structure version compiled from, pv version of pvms_ and
+    // SceneState::last_version when the transforms were last checked
+    std::shared_ptr<SceneNode> root_;
+    uint64_t                   structure_version_;
+    uint64_t                   pv_version_;
+    uint64_t                   checked_version_;
+    uint64_t                   frame_;
+    bool                       compiled_;
+    bool                       sorted_;
+    bool                       keys_valid_;
+    bool                       instanced_;
+    bool                       instances_valid_;
+    GLuint                     instance_buffer_;
+    RenderStats                stats_;
+    RenderQueue                queue_;
+
+    std::vector<Program>   programs_;
+    std::vector<Material>  materials_;
+    std::vector<Transform> transforms_;
+    std::vector<Matrix4x4> worlds_;
+    std::vector<Matrix4x4> pvms_;
+    std::vector<Record>    records_;
+
+    // Records drawn one by one (the queue items index singles_), their
+    // copies in sorted order and the instanced batches with their records
+    // and instance data
+    std::vector<uint32_t>     singles_;
+    std::vector<SortedRecord> sorted_records_;
+    std::vector<Batch>        batches_;
+    std::vector<uint32_t>     instances_;
+    std::vector<Instance>     instance_data_;
+
+    // Indices of the programs, materials and vertex arrays seen so far
+    // (during compile)
+    using MaterialKey = std::tuple<float, float, float, float, MaterialUniform, bool>;
+    std::unordered_map<GLuint, uint32_t> program_indices_;
+    std::map<MaterialKey, uint32_t>      material_indices_;
+    std::unordered_map<GLuint, uint32_t> vao_indices_;
+
+    // Recomputes the world and PVM matrices that changed since last frame.
+    // Returns false if none can have changed.
+    bool update_transforms(const SceneState &scene_state);
+
+    // Adds a record with the compile state
+    void add_record(const RenderCompiler &compiler, const DrawCall &call, SceneNode *node);
+
+    // Sets the sort keys from the current depths, sorts the queue and
+    // copies the records and their matrices into sorted order
+    void sort_records();
+
+    // Groups the records into batches and singles
+    void build_batches();
+
+    // Updates the instance data of records whose transform changed this
+    // frame (all of them after build_batches) and uploads it if any did
+    void update_instances(bool transforms_updated);
+
+    // Draws the batches
+    void draw_batches(GLStateCache &gl, const SceneState &scene_state);
+};
+
+} // namespace cg
+
+#endif
@@ -0,0 +1,106 @@
+#include "scene/render_queue.hpp"
+
+namespace cg
+{
+
+namespace
+{
+// Repairing last order is abandoned for a radix sort once it has moved
+// items more than REPAIR_MOVES places per item, which bounds the work
+// wasted on an order that changed a lot
+constexpr size_t REPAIR_MOVES = 4;
+
+constexpr uint32_t RADIX_BITS = 8;
+constexpr uint32_t RADIX_SIZE = 1 << RADIX_BITS;
+constexpr uint32_t RADIX_DIGITS = 64 / RADIX_BITS;
+} // namespace
+
+RenderQueue::RenderQueue() : incremental_(false), unsorted_(true) {}
+
+void RenderQueue::reset(size_t count)
+{
+    keys_.assign(count, 0);
+    order_.resize(count);
+    for(size_t i = 0; i < count; i++) order_[i] = static_cast<uint32_t>(i);
+    unsorted_ = true;
+}
+
+const std::vector<uint32_t> &RenderQueue::sort()
+{
+    // Keys usually change a little from frame to frame (depth as the
+    // camera moves), so last frame's order needs only local repairs.
+    // Right after reset it is unrelated to the keys.
+    incremental_ = !unsorted_ && repair();
+    if(!incremental_) radix_sort();
+    unsorted_ = false;
+    return order_;
+}
+
+const std::vector<uint32_t> &RenderQueue::order() const { return order_; }
+
+bool RenderQueue::incremental() const { return incremental_; }
+
+bool RenderQueue::repair()
+{
+    // items_ holds last order; give it the new keys and insertion sort it
+    for(Item &item : items_) item.key = keys_[item.item];
+
+    size_t moves = 0;
+    size_t max_moves = items_.size() * REPAIR_MOVES;
+    for(size_t i = 1; i < items_.size(); i++)
+    {
+        Item   item = items_[i];
+        size_t j = i;
+        while(j > 0 && (item.key < items_[j - 1].key ||
+                        (item.key == items_[j - 1].key && item.item < items_[j - 1].item)))
+        {
+            items_[j] = items_[j - 1];
+            j--;
+        }
+        items_[j] = item;
+        moves += i - j;
+        if(moves > max_moves) return false;
+    }
+    for(size_t i = 0; i < items_.size(); i++) order_[i] = items_[i].item;
+    return true;
+}
+
+void RenderQueue::radix_sort()
+{
+    // Items start in item order; each LSD pass is stable, so equal keys
+    // stay in item order
+    size_t count = keys_.size();
+    items_.resize(count);
+    scratch_.resize(count);
+    uint32_t histogram[RADIX_DIGITS][RADIX_SIZE] = {};
+    for(size_t i = 0; i < count; i++)
+    {
+        uint64_t key = keys_[i];
+        items_[i] = {key, static_cast<uint32_t>(i)};
+        for(uint32_t d = 0; d < RADIX_DIGITS; d++)
+            histogram[d][(key >> (d * RADIX_BITS)) & (RADIX_SIZE - 1)]++;
+    }
+
+    for(uint32_t d = 0; d < RADIX_DIGITS; d++)
+    {
+        // A digit that is the same in every key does not change the order
+        uint32_t *h = histogram[d];
+        if(count == 0 || h[(items_[0].key >> (d * RADIX_BITS)) & (RADIX_SIZE - 1)] == count)
+            continue;
+
+        uint32_t offset = 0;
+        for(uint32_t b = 0; b < RADIX_SIZE; b++)
+        {
+            uint32_t n = h[b];
+            h[b] = offset;
+            offset += n;
+        }
+        for(const Item &item : items_)
+            scratch_[h[(item.key >> (d * RADIX_BITS)) & (RADIX_SIZE - 1)]++] = item;
+        items_.swap(scratch_);
+    }
+
+    for(size_t i = 0; i < count; i++) order_[i] = items_[i].item;
+}
+
+} // namespace cg
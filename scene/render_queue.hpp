@@ -0,0 +1,99 @@
+//============================================================================
+//	Johns Hopkins University Engineering for Professionals
+//	605.667 Computer Graphics and 605.767 Applied Computer Graphics
+//	Instructor:	Brian Russin
+//
+//	Author:  Kyle Meyer
+//	File:    render_queue.hpp
+//	Purpose: Draw order from 64 bit sort keys. Sorted with an LSD radix
+//           sort, or, when last frame's order is still nearly sorted, by
+//           repairing that order with an insertion sort.
+//============================================================================
+
+#ifndef __SCENE_RENDER_QUEUE_HPP__
+#define __SCENE_RENDER_QUEUE_HPP__
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace cg
+{
+
+/**
+ * Render queue. Holds a sort key per item (draw record) and sorts the
+ * items by key; items with equal keys stay in item order, so the result
+ * depends only on the keys.
+ */
+class RenderQueue
+{
+  public:
+    /**
+     * Constructor. Creates an empty queue.
+     */
+    RenderQueue();
+
+    /**
+     * Sets the number of items. Keys are set to 0 and the order to item
+     * order.
+     * @param  count  Number of items.
+     */
+    void reset(size_t count);
+
+    /**
+     * Sets the sort key of an item.
+     * @param  item  Item index.
+     * @param  key   Sort key (items are drawn in increasing key order).
+     */
+    void set_key(uint32_t item, uint64_t key);
+
+    /**
+     * Sorts the items by key. Last order is repaired in place if the items
+     * moved only a few places, else the items are radix sorted.
+     * @return  Returns the item indices in draw order.
+     */
+    const std::vector<uint32_t> &sort();
+
+    /**
+     * Gets the order from the last sort.
+     * @return  Returns the item indices in draw order.
+     */
+    const std::vector<uint32_t> &order() const;
+
+    /**
+     * Tells whether the last sort repaired the previous order rather than
+     * sorting from scratch.
+     * @return  Returns true if the last sort was incremental.
+     */
+    bool incremental() const;
+
+  protected:
+    struct Item
+    {
+        uint64_t key;
+        uint32_t item;
+    };
+
+    // Keys by item; order_ and items_ hold the items in last sorted order
+    std::vector<uint64_t> keys_;
+    std::vector<uint32_t> order_;
+    std::vector<Item>     items_;
+    std::vector<Item>     scratch_;
+    bool                  incremental_;
+    bool                  unsorted_;
+
+    // Repairs last order with an insertion sort. Returns false (items_
+    // left partly sorted) if that would move too many items.
+    bool repair();
+
+    // Sorts order_ from scratch
+    void radix_sort();
+};
+
+// Inline methods
+
+inline void RenderQueue::set_key(uint32_t item, uint64_t key) { keys_[item] = key; }
+
+} // namespace cg
+
+#endif
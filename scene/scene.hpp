@@ -24,6 +24,8 @@
 #include "scene/geometry_node.hpp"
 #include "scene/shader_node.hpp"
 #include "scene/camera_node.hpp"
+#include "scene/render_list.hpp"
+#include "scene/gl_state_cache.hpp"
 // clang-format on
 
 namespace cg
@@ -1,5 +1,9 @@
 #include "scene/scene_node.hpp"
 
+#include "scene/render_list.hpp"
+
+#include <typeinfo>
+
 namespace cg
 {
 
@@ -18,6 +22,8 @@ std::ostream &operator<<(std::ostream &out, const SceneNodeType &type)
     return out;
 }
 
+uint64_t SceneNode::structure_version_ = 0;
+
 SceneNode::SceneNode() : node_type_(SceneNodeType::BASE) {}
 
 SceneNode::~SceneNode() { destroy(); }
@@ -34,9 +40,29 @@ void SceneNode::update(SceneState &scene_state)
     for(auto c : children_) { c->update(scene_state); }
 }
 
-void SceneNode::destroy() { children_.clear(); }
+void SceneNode::compile(RenderCompiler &compiler)
+{
+    // Only a plain SceneNode is known to just draw its children
+    if(typeid(*this) == typeid(SceneNode)) compile_children(compiler);
+    else compiler.list.add_node(compiler, this);
+}
+
+void SceneNode::compile_children(RenderCompiler &compiler)
+{
+    for(auto &c : children_) { c->compile(compiler); }
+}
+
+void SceneNode::destroy()
+{
+    if(!children_.empty()) structure_version_++;
+    children_.clear();
+}
 
-void SceneNode::add_child(std::shared_ptr<SceneNode> node) { children_.push_back(node); }
+void SceneNode::add_child(std::shared_ptr<SceneNode> node)
+{
+    children_.push_back(node);
+    structure_version_++;
+}
 
 SceneNodeType SceneNode::node_type() const { return node_type_; }
 
@@ -44,6 +70,8 @@ void SceneNode::set_name(const char *nm) { name_ = nm; }
 
 const std::string &SceneNode::get_name() const { return name_; }
 
+uint64_t SceneNode::structure_version() { return structure_version_; }
+
 void SceneNode::print_graph(std::ostream &out, int32_t level) const
 {
     for(size_t i = 0; i < level; ++i) out << "- ";
@@ -24,6 +24,8 @@
 namespace cg
 {
 
+struct RenderCompiler;
+
 enum class SceneNodeType
 {
     BASE,
@@ -66,6 +68,16 @@ class SceneNode
      */
     virtual void update(SceneState &scene_state);
 
+    /**
+     * Add this node and its children to a render list (see RenderList).
+     * A plain SceneNode compiles its children. A derived class that does
+     * not override this is drawn as one unit by calling its draw(), so
+     * nodes that know nothing of render lists still draw correctly.
+     * @param  compiler  Render list being compiled and the state inherited
+     *                   from the ancestors.
+     */
+    virtual void compile(RenderCompiler &compiler);
+
     /**
      * Destroy all the children
      */
@@ -97,10 +109,22 @@ class SceneNode
 
     void print_graph(std::ostream &out = std::cout, int32_t level = 0) const;
 
+    /**
+     * Gets the structure version. It changes whenever a child is added to
+     * or removed from any node, so render lists know when to recompile.
+     * @return  Returns the version.
+     */
+    static uint64_t structure_version();
+
   protected:
     std::string                             name_;
     SceneNodeType                           node_type_;
     std::vector<std::shared_ptr<SceneNode>> children_;
+
+    static uint64_t structure_version_;
+
+    // Compiles the children (SceneNode::compile for a plain node)
+    void compile_children(RenderCompiler &compiler);
 };
 
 } // namespace cg
@@ -3,13 +3,35 @@
 namespace cg
 {
 
+namespace
+{
+// Last version returned by SceneState::next_version
+uint64_t g_version = 0;
+} // namespace
+
 void SceneState::init()
 {
     model_matrix.set_identity();
+    model_version = 0;
     model_matrix_stack.clear();
+    model_version_stack.clear();
+}
+
+void SceneState::set_pv(const Matrix4x4 &m)
+{
+    pv = m;
+    pv_version = next_version();
 }
 
-void SceneState::push_transforms() { model_matrix_stack.push_back(model_matrix); }
+uint64_t SceneState::next_version() { return ++g_version; }
+
+uint64_t SceneState::last_version() { return g_version; }
+
+void SceneState::push_transforms()
+{
+    model_matrix_stack.push_back(model_matrix);
+    model_version_stack.push_back(model_version);
+}
 
 void SceneState::pop_transforms()
 {
@@ -18,9 +40,15 @@ void SceneState::pop_transforms()
     if(model_matrix_stack.size() > 0)
     {
         model_matrix = model_matrix_stack.back();
+        model_version = model_version_stack.back();
         model_matrix_stack.pop_back();
+        model_version_stack.pop_back();
+    }
+    else
+    {
+        model_matrix.set_identity();
+        model_version = 0;
     }
-    else model_matrix.set_identity();
 }
 
 } // namespace cg
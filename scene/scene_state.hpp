@@ -15,9 +15,9 @@
 #include "geometry/matrix.hpp"
 #include "scene/graphics.hpp"
 
-#include <list>
-
 #include <array>
+#include <cstdint>
+#include <vector>
 
 namespace cg
 {
@@ -49,14 +49,41 @@ struct SceneState
     Matrix4x4             pv;           // Current composite projection and view matrix
     Matrix4x4             model_matrix; // Current model matrix
 
+    // Versions of pv and model_matrix. Transform nodes cache their world
+    // and PVM matrices and compare these to tell whether the caches are
+    // still valid. Model matrix version 0 is the identity. Change pv with
+    // set_pv so cached PVM matrices are updated.
+    uint64_t pv_version = 0;
+    uint64_t model_version = 0;
+
     // Retained state to push/pop modeling matrix
-    std::list<Matrix4x4> model_matrix_stack;
+    std::vector<Matrix4x4> model_matrix_stack;
+    std::vector<uint64_t>  model_version_stack;
 
     /**
      * Initialize scene state prior to drawing.
      */
     void init();
 
+    /**
+     * Set the composite projection and view matrix.
+     * @param  m  Projection * view matrix.
+     */
+    void set_pv(const Matrix4x4 &m);
+
+    /**
+     * Gets a new version number, different from all earlier ones.
+     * @return  Returns the version.
+     */
+    static uint64_t next_version();
+
+    /**
+     * Gets the last version returned by next_version. If it is unchanged,
+     * nothing that takes a new version (transforms, pv) has changed.
+     * @return  Returns the version.
+     */
+    static uint64_t last_version();
+
     /**
      * Copy current matrix onto stack
      */
@@ -1,9 +1,14 @@
 #include "scene/transform_node.hpp"
 
+#include "scene/gl_state_cache.hpp"
+#include "scene/render_list.hpp"
+
 namespace cg
 {
 
 TransformNode::TransformNode()
+    : scale_(1.0f, 1.0f, 1.0f), local_version_(0), drawn_version_(0), parent_version_(0),
+      world_version_(0), pv_version_(0)
 {
     node_type_ = SceneNodeType::TRANSFORM;
     load_identity();
@@ -14,75 +19,149 @@ TransformNode::~TransformNode() {}
 void TransformNode::load_identity()
 {
   composite_transform_.set_identity(); 
+  translation_.set(0.0f, 0.0f, 0.0f);
+  rotation_ = Quaternion();
+  scale_.set(1.0f, 1.0f, 1.0f);
+  local_version_ = SceneState::next_version();
+}
+
+void TransformNode::set_matrix(const Matrix4x4 &m)
+{
+   composite_transform_ = m;
+   local_version_ = SceneState::next_version();
 }
 
 void TransformNode::translate(float x, float y, float z)
 {
    composite_transform_.translate(x, y, z);
+   local_version_ = SceneState::next_version();
 }
 
 void TransformNode::rotate(float deg, Vector3 &v)
 {
    composite_transform_.rotate(deg, v.x, v.y, v.z);
+   local_version_ = SceneState::next_version();
+}
+
+void TransformNode::rotate(const Quaternion &q)
+{
+   composite_transform_ *= q.to_matrix();
+   local_version_ = SceneState::next_version();
 }
 
 void TransformNode::rotate_x(float deg)
 {
    composite_transform_.rotate_x(deg);
+   local_version_ = SceneState::next_version();
 }
 
 void TransformNode::rotate_y(float deg)
 {
    composite_transform_.rotate_y(deg);
+   local_version_ = SceneState::next_version();
 }
 
 void TransformNode::rotate_z(float deg)
 {
    composite_transform_.rotate_z(deg);
+   local_version_ = SceneState::next_version();
 }
 
 void TransformNode::scale(float x, float y, float z)
 {
    composite_transform_.scale(x, y, z);
+   local_version_ = SceneState::next_version();
+}
+
+void TransformNode::set_trs(const Vector3    &translation,
+                            const Quaternion &rotation,
+                            const Vector3    &scale)
+{
+   translation_ = translation;
+   rotation_ = rotation;
+   scale_ = scale;
+   update_trs();
+}
+
+void TransformNode::set_translation(const Vector3 &translation)
+{
+   translation_ = translation;
+   update_trs();
+}
+
+void TransformNode::set_rotation(const Quaternion &rotation)
+{
+   rotation_ = rotation;
+   update_trs();
 }
 
+void TransformNode::set_scale(const Vector3 &scale)
+{
+   scale_ = scale;
+   update_trs();
+}
+
+const Quaternion &TransformNode::get_rotation() const { return rotation_; }
+
+void TransformNode::update_trs()
+{
+   composite_transform_ = Matrix4x4::compose_trs(translation_, rotation_.to_matrix(), scale_);
+   local_version_ = SceneState::next_version();
+}
+
+const Matrix4x4 &TransformNode::get_matrix() const { return composite_transform_; }
+
+uint64_t TransformNode::get_version() const { return local_version_; }
+
+const Matrix4x4 &TransformNode::get_world_matrix() const { return world_; }
+
 void TransformNode::draw(SceneState &scene_state)
 {
     // Save the current model matrix state by pushing it onto the stack
     scene_state.push_transforms();
-    
-    // Apply this transform node's transformation to the current model matrix
-    scene_state.model_matrix *= composite_transform_;
-    
-    // Calculate the normal matrix (inverse transpose of upper 3x3 of model matrix)
-    // For transforming normals, we need the inverse transpose to handle non-uniform scaling
-    Matrix4x4 normal_matrix = scene_state.model_matrix;
-    
-    // For most cases, especially with uniform scaling and rotations, we can use
-    // the upper 3x3 of the model matrix directly. For non-uniform scaling,
-    // we would need the inverse transpose, but let's try the direct approach first.
-    
-    // Calculate composite PVM matrix (projection * view * model)
-    Matrix4x4 pvm_matrix = scene_state.pv * scene_state.model_matrix;
-    
-    // Set the GLSL uniforms if their locations are valid
-    if (scene_state.model_matrix_loc >= 0) 
-        glUniformMatrix4fv(scene_state.model_matrix_loc, 1, GL_FALSE, scene_state.model_matrix.get());
-    
-    if (scene_state.normal_matrix_loc >= 0) 
-        glUniformMatrix4fv(scene_state.normal_matrix_loc, 1, GL_FALSE, normal_matrix.get());
-    
-    if (scene_state.pvm_matrix_loc >= 0) 
-        glUniformMatrix4fv(scene_state.pvm_matrix_loc, 1, GL_FALSE, pvm_matrix.get());
-        
+
+    // The world matrix (parent model matrix * this node's transform) is
+    // cached; it changes only if this transform or an ancestor's did
+    bool world_changed =
+        drawn_version_ != local_version_ || parent_version_ != scene_state.model_version;
+    if(world_changed)
+    {
+        world_ = scene_state.model_matrix * composite_transform_;
+        parent_version_ = scene_state.model_version;
+        world_version_ = SceneState::next_version();
+        drawn_version_ = local_version_;
+    }
+    if(world_changed || pv_version_ != scene_state.pv_version)
+    {
+        pvm_ = scene_state.pv * world_;
+        pv_version_ = scene_state.pv_version;
+    }
+    scene_state.model_matrix = world_;
+    scene_state.model_version = world_version_;
+
+    // The normal matrix should be the inverse transpose of the upper 3x3
+    // of the model matrix. The upper 3x3 itself is used, which is correct
+    // for rotations and uniform scaling.
+    GLStateCache &gl = gl_state();
+    gl.uniform_matrix4fv(scene_state.model_matrix_loc, world_.get());
+    gl.uniform_matrix4fv(scene_state.normal_matrix_loc, world_.get());
+    gl.uniform_matrix4fv(scene_state.pvm_matrix_loc, pvm_.get());
 
     // Draw all children with the updated transformation state
     SceneNode::draw(scene_state);
-    
+
     // Restore the previous model matrix state by popping from the stack
     scene_state.pop_transforms();
 }
 
+void TransformNode::compile(RenderCompiler &compiler)
+{
+    uint32_t transform = compiler.transform;
+    compiler.transform = compiler.list.add_transform(this, transform);
+    compile_children(compiler);
+    compiler.transform = transform;
+}
+
 void TransformNode::update(SceneState &scene_state) {}
 
 } // namespace cg
@@ -21,7 +21,11 @@ namespace cg
 
 /**
  * Transform node. Applies a transformation. This class allows OpenGL style
- * transforms applied to the scene graph.
+ * transforms applied to the scene graph. Alternatively the transform can be
+ * held as separate translation, quaternion rotation and scale parts
+ * (set_trs and friends), which animation can update each frame without
+ * trigonometry. Setting a part rebuilds the whole transform from the parts,
+ * replacing any OpenGL style calls made before it.
  */
 class TransformNode : public SceneNode
 {
@@ -41,6 +45,13 @@ class TransformNode : public SceneNode
      */
     void load_identity();
 
+    /**
+     * Replace the transform with a prebuilt matrix, e.g. one computed at
+     * compile time with the constexpr Matrix4x4 builders.
+     * @param  m  Composite transformation matrix.
+     */
+    void set_matrix(const Matrix4x4 &m);
+
     /**
      * Apply a translation
      * @param  x  x translation
@@ -56,6 +67,12 @@ class TransformNode : public SceneNode
      */
     void rotate(float deg, Vector3 &v);
 
+    /**
+     * Apply a rotation given as a quaternion.
+     * @param  q  Unit quaternion rotation.
+     */
+    void rotate(const Quaternion &q);
+
     /**
      * Apply rotation about the x axis.
      * @param  deg  Degrees counter-clockwise rotation.
@@ -83,11 +100,72 @@ class TransformNode : public SceneNode
     void scale(float x, float y, float z);
 
     /**
-     * Draw this transformation node and its children
+     * Replace the transform with translation * rotation * scale.
+     * @param  translation  Translation.
+     * @param  rotation     Unit quaternion rotation.
+     * @param  scale        Scale factors along x, y and z.
+     */
+    void set_trs(const Vector3 &translation, const Quaternion &rotation, const Vector3 &scale);
+
+    /**
+     * Set the translation part and rebuild the transform from the parts.
+     * @param  translation  Translation.
+     */
+    void set_translation(const Vector3 &translation);
+
+    /**
+     * Set the rotation part and rebuild the transform from the parts.
+     * @param  rotation  Unit quaternion rotation.
+     */
+    void set_rotation(const Quaternion &rotation);
+
+    /**
+     * Set the scale part and rebuild the transform from the parts.
+     * @param  scale  Scale factors along x, y and z.
+     */
+    void set_scale(const Vector3 &scale);
+
+    /**
+     * Gets the rotation part (identity unless set with set_trs or
+     * set_rotation).
+     * @return  Returns the rotation.
+     */
+    const Quaternion &get_rotation() const;
+
+    /**
+     * Gets the transform of this node (relative to its parent).
+     * @return  Returns the composite modeling transformation matrix.
+     */
+    const Matrix4x4 &get_matrix() const;
+
+    /**
+     * Gets the version of this node's transform. It changes whenever the
+     * transform is changed.
+     * @return  Returns the version.
+     */
+    uint64_t get_version() const;
+
+    /**
+     * Gets the world (model) matrix from the last draw.
+     * @return  Returns the parent model matrix times this transform.
+     */
+    const Matrix4x4 &get_world_matrix() const;
+
+    /**
+     * Draw this transformation node and its children. The world and PVM
+     * matrices are only recomputed when this transform, an ancestor's
+     * transform or the scene state's pv has changed.
      * @param  scene_state   Current scene state
      */
     void draw(SceneState &scene_state) override;
 
+    /**
+     * Compile this transformation node and its children. The draw records
+     * below it get their world matrix from this node.
+     * @param  compiler  Render list being compiled.
+     */
+    void compile(RenderCompiler &compiler) override;
+
     /**
      * Update the scene node and its children
      * @param  scene_state   Current scene state
@@ -95,8 +173,32 @@ class TransformNode : public SceneNode
     void update(SceneState &scene_state) override;
 
   protected:
-   // Composite modeling transformation matrix - stores accumulated transformations
+   // Composite modeling transformation matrix - stores accumulated
+   // transformations. Set a new local_version_ after changing it.
    Matrix4x4 composite_transform_;
+
+   // Translation, rotation and scale parts (see set_trs)
+   Vector3    translation_;
+   Quaternion rotation_;
+   Vector3    scale_;
+
+   // Cached world (model) and PVM matrices. world_ is valid while this
+   // transform is unchanged (drawn_version_ is local_version_, see
+   // SceneState::next_version) and the model matrix it was drawn
+   // under has version parent_version_; world_version_ identifies it to
+   // the children. pvm_ is valid while, in addition, pv has version
+   // pv_version_. A node shared under several parents stays correct but
+   // recomputes on every draw.
+   uint64_t  local_version_;
+   uint64_t  drawn_version_;
+   uint64_t  parent_version_;
+   uint64_t  world_version_;
+   uint64_t  pv_version_;
+   Matrix4x4 world_;
+   Matrix4x4 pvm_;
+
+   // Rebuilds composite_transform_ from the parts
+   void update_trs();
 };
 
 } // namespace cg